@@ -426,6 +426,8 @@ opal_pointer_array_t ompi_datatype_f_to_c_table = {{0}};
         ptype->super.flags |= (FLAGS);                                               \
         ptype->id = MPIDDT;                                                          \
         ompi_datatype_commit( &ptype );                                              \
+        /* the descriptions are stolen, they cannot be shared */                     \
+        opal_datatype_unshare_opt_desc( &ptype->super );                             \
         COPY_DATA_DESC( PDATA, ptype );                                              \
         (PDATA)->super.flags &= ~OPAL_DATATYPE_FLAG_PREDEFINED;                      \
         (PDATA)->super.flags |= OMPI_DATATYPE_FLAG_PREDEFINED |                      \
@@ -444,6 +446,8 @@ opal_pointer_array_t ompi_datatype_f_to_c_table = {{0}};
         ptype->super.flags |= (FLAGS);                                               \
         ptype->super.id = (MPIDDT);                                                  \
         ompi_datatype_commit( &ptype );                                              \
+        /* the descriptions are stolen, they cannot be shared */                     \
+        opal_datatype_unshare_opt_desc( &ptype->super );                             \
         COPY_DATA_DESC( (PDATA), ptype );                                            \
         (PDATA)->super.flags &= ~OPAL_DATATYPE_FLAG_PREDEFINED;                      \
         (PDATA)->super.flags |= OMPI_DATATYPE_FLAG_PREDEFINED |                      \
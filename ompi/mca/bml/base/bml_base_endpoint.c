@@ -28,6 +28,7 @@ static void mca_bml_base_endpoint_construct(mca_bml_base_endpoint_t* ep)
 {
     ep->btl_pipeline_send_length = 0;
     ep->btl_send_limit = 0;
+    ep->btl_rdma_bytes = 0;
 
     OBJ_CONSTRUCT(&ep->btl_eager, mca_bml_base_btl_array_t);
     OBJ_CONSTRUCT(&ep->btl_send,  mca_bml_base_btl_array_t);
@@ -59,6 +59,9 @@ struct mca_bml_base_btl_t {
     float     btl_weight;                            /**< BTL weight for scheduling */
     struct    mca_btl_base_module_t *btl;            /**< BTL module */
     struct    mca_btl_base_endpoint_t* btl_endpoint; /**< BTL addressing info */
+    opal_atomic_int64_t btl_rdma_bytes;              /**< RDMA bytes completed since the last weights update */
+    opal_atomic_int64_t btl_rdma_usecs;              /**< cumulated duration of these RDMA operations */
+    double    btl_throughput;                        /**< smoothed observed RDMA throughput (bytes/usec) */
 };
 typedef struct mca_bml_base_btl_t mca_bml_base_btl_t;
 
@@ -225,6 +228,7 @@ struct mca_bml_base_endpoint_t {
     mca_bml_base_btl_array_t btl_send;          /**< array of btls to use for remaining fragments */
     mca_bml_base_btl_array_t btl_rdma;          /**< array of btls that support (prefer) rdma */
     size_t                   btl_rdma_index;    /**< index of last used BTL for RDMA */
+    opal_atomic_int64_t      btl_rdma_bytes;    /**< RDMA bytes completed since the last weights update */
     uint32_t                 btl_flags_or;      /**< the bitwise OR of the btl flags */
 };
 typedef struct mca_bml_base_endpoint_t mca_bml_base_endpoint_t;
@@ -557,6 +561,24 @@ typedef int (*mca_bml_base_module_register_error_cb_fn_t)(
         mca_btl_base_module_error_cb_fn_t cbfunc
 );
 
+/**
+ * Account a completed RDMA operation.
+ *
+ * @param endpoint (IN)  BML endpoint of the peer
+ * @param bml_btl (IN)   BTL of the endpoint RDMA array the operation used
+ * @param size (IN)      Number of bytes transferred
+ * @param usecs (IN)     Time between the issue and the completion of the operation
+ *
+ * Optional, NULL when the BML does not adapt the RDMA weights of the
+ * endpoints to the observed throughput of their BTLs.
+ */
+typedef void (*mca_bml_base_module_rdma_completed_fn_t)(
+    struct mca_bml_base_endpoint_t* endpoint,
+    mca_bml_base_btl_t* bml_btl,
+    size_t size,
+    uint64_t usecs
+);
+
 /**
  * BML module interface functions and attributes.
  */
@@ -573,6 +595,7 @@ struct mca_bml_base_module_t {
     mca_bml_base_module_del_proc_btl_fn_t  bml_del_proc_btl;
     mca_bml_base_module_register_fn_t      bml_register;
     mca_bml_base_module_register_error_cb_fn_t bml_register_error;
+    mca_bml_base_module_rdma_completed_fn_t bml_rdma_completed;
 
     mca_bml_base_module_finalize_fn_t      bml_finalize;
 };
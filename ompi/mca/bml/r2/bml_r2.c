@@ -281,6 +281,9 @@ static int mca_bml_r2_endpoint_add_btl (struct ompi_proc_t *proc, mca_bml_base_e
         bml_btl_rdma->btl_endpoint = btl_endpoint;
         bml_btl_rdma->btl_weight = 0;
         bml_btl_rdma->btl_flags = btl_flags;
+        bml_btl_rdma->btl_rdma_bytes = 0;
+        bml_btl_rdma->btl_rdma_usecs = 0;
+        bml_btl_rdma->btl_throughput = 0.;
 
         if (bml_endpoint->btl_pipeline_send_length < btl->btl_rdma_pipeline_send_length) {
             bml_endpoint->btl_pipeline_send_length = btl->btl_rdma_pipeline_send_length;
@@ -370,6 +373,90 @@ static void mca_bml_r2_compute_endpoint_metrics (mca_bml_base_endpoint_t *bml_en
     }
 }
 
+/* weight of the last interval in the smoothed throughput of a BTL, so that a
+ * single interval with a transient load does not swing the weights */
+#define MCA_BML_R2_THROUGHPUT_SMOOTHING 0.5
+
+/*
+ * Recompute the RDMA weights of an endpoint from the throughput observed on
+ * each BTL since the last update. The BTLs not observed yet are estimated
+ * from their btl_bandwidth, in Mbps so 8 Mbps are a byte per usec.
+ */
+static void mca_bml_r2_update_rdma_weights (mca_bml_base_endpoint_t *bml_endpoint)
+{
+    const size_t n_rdma = mca_bml_base_btl_array_get_size (&bml_endpoint->btl_rdma);
+    double min_weight = mca_bml_r2.adaptive_min_weight;
+    double total_throughput = 0., total_weight = 0.;
+
+    if (min_weight < 0.) {
+        min_weight = 0.;
+    } else if (min_weight > 1. / n_rdma) {
+        min_weight = 1. / n_rdma;
+    }
+
+    for (size_t n_index = 0 ; n_index < n_rdma ; ++n_index) {
+        mca_bml_base_btl_t *bml_btl = mca_bml_base_btl_array_get_index (&bml_endpoint->btl_rdma, n_index);
+        int64_t bytes = OPAL_THREAD_SWAP_64 (&bml_btl->btl_rdma_bytes, 0);
+        int64_t usecs = OPAL_THREAD_SWAP_64 (&bml_btl->btl_rdma_usecs, 0);
+
+        if (bytes > 0 && usecs > 0) {
+            double throughput = (double) bytes / (double) usecs;
+
+            if (0. == bml_btl->btl_throughput) {
+                bml_btl->btl_throughput = throughput;
+            } else {
+                bml_btl->btl_throughput = MCA_BML_R2_THROUGHPUT_SMOOTHING * throughput +
+                    (1. - MCA_BML_R2_THROUGHPUT_SMOOTHING) * bml_btl->btl_throughput;
+            }
+        }
+
+        total_throughput += (0. < bml_btl->btl_throughput) ? bml_btl->btl_throughput :
+            bml_btl->btl->btl_bandwidth / 8.;
+    }
+
+    if (0. == total_throughput) {
+        return;
+    }
+
+    for (size_t n_index = 0 ; n_index < n_rdma ; ++n_index) {
+        mca_bml_base_btl_t *bml_btl = mca_bml_base_btl_array_get_index (&bml_endpoint->btl_rdma, n_index);
+        double throughput = (0. < bml_btl->btl_throughput) ? bml_btl->btl_throughput :
+            bml_btl->btl->btl_bandwidth / 8.;
+        double weight = throughput / total_throughput;
+
+        bml_btl->btl_weight = (float) ((weight < min_weight) ? min_weight : weight);
+        total_weight += bml_btl->btl_weight;
+    }
+
+    for (size_t n_index = 0 ; n_index < n_rdma ; ++n_index) {
+        mca_bml_base_btl_t *bml_btl = mca_bml_base_btl_array_get_index (&bml_endpoint->btl_rdma, n_index);
+        bml_btl->btl_weight = (float) (bml_btl->btl_weight / total_weight);
+    }
+}
+
+void mca_bml_r2_rdma_completed (mca_bml_base_endpoint_t *bml_endpoint, mca_bml_base_btl_t *bml_btl,
+                                size_t size, uint64_t usecs)
+{
+    mca_bml_base_btl_array_t *btl_rdma = &bml_endpoint->btl_rdma;
+    int64_t interval = (int64_t) mca_bml_r2.adaptive_interval;
+
+    /* only the large messages striped across the RDMA BTLs use their weights */
+    if (btl_rdma->arr_size < 2 || bml_btl < btl_rdma->bml_btls ||
+        bml_btl >= btl_rdma->bml_btls + btl_rdma->arr_size) {
+        return;
+    }
+
+    OPAL_THREAD_ADD_FETCH64(&bml_btl->btl_rdma_bytes, (int64_t) size);
+    OPAL_THREAD_ADD_FETCH64(&bml_btl->btl_rdma_usecs, (int64_t) usecs);
+
+    /* the thread resetting the endpoint counter updates the weights, the
+     * others keep on striping with the current ones */
+    if (OPAL_THREAD_ADD_FETCH64(&bml_endpoint->btl_rdma_bytes, (int64_t) size) >= interval &&
+        OPAL_THREAD_SWAP_64(&bml_endpoint->btl_rdma_bytes, 0) >= interval) {
+        mca_bml_r2_update_rdma_weights (bml_endpoint);
+    }
+}
+
 static int mca_bml_r2_add_proc (struct ompi_proc_t *proc)
 {
     mca_bml_base_endpoint_t *bml_endpoint;
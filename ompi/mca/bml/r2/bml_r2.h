@@ -45,6 +45,9 @@ struct mca_bml_r2_module_t {
     mca_btl_base_component_progress_fn_t * btl_progress;
     bool btls_added;
     bool show_unreach_errors;
+    bool adaptive_weights;          /**< adapt the RDMA weights to the observed throughput */
+    size_t adaptive_interval;       /**< RDMA bytes completed with a peer between updates */
+    double adaptive_min_weight;     /**< minimal weight kept by each RDMA BTL */
 };
 
 typedef struct mca_bml_r2_module_t mca_bml_r2_module_t;
@@ -61,6 +64,9 @@ mca_bml_base_module_t* mca_bml_r2_component_init( int* priority,
 
 int mca_bml_r2_progress(void);
 
+void mca_bml_r2_rdma_completed(struct mca_bml_base_endpoint_t *bml_endpoint, mca_bml_base_btl_t *bml_btl,
+                               size_t size, uint64_t usecs);
+
 int mca_bml_r2_component_fini(void);
 
 int mca_bml_r2_finalize( void );
@@ -64,6 +64,39 @@ static int mca_bml_r2_component_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_bml_r2.show_unreach_errors);
 
+    mca_bml_r2.adaptive_weights = false;
+    (void) mca_base_component_var_register(&mca_bml_r2_component.bml_version,
+                                           "adaptive_weights",
+                                           "Periodically recompute the weights used to stripe the large "
+                                           "messages across the RDMA BTLs of a peer from the throughput "
+                                           "observed on each of them, instead of using their static "
+                                           "btl_bandwidth (default: false)",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_bml_r2.adaptive_weights);
+
+    mca_bml_r2.adaptive_interval = 32 * 1024 * 1024;
+    (void) mca_base_component_var_register(&mca_bml_r2_component.bml_version,
+                                           "adaptive_interval",
+                                           "Number of RDMA bytes completed with a peer between two updates "
+                                           "of its adaptive weights (default: 32MB)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_bml_r2.adaptive_interval);
+
+    mca_bml_r2.adaptive_min_weight = 0.05;
+    (void) mca_base_component_var_register(&mca_bml_r2_component.bml_version,
+                                           "adaptive_min_weight",
+                                           "Minimal share of the striped traffic kept by each RDMA BTL with "
+                                           "adaptive weights, so that the throughput of a slow BTL keeps "
+                                           "being observed (default: 0.05)",
+                                           MCA_BASE_VAR_TYPE_DOUBLE, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_bml_r2.adaptive_min_weight);
+
     return OMPI_SUCCESS;
 }
 
@@ -90,5 +123,6 @@ mca_bml_base_module_t* mca_bml_r2_component_init( int* priority,
 
     *priority = 100;
     mca_bml_r2.btls_added = false;
+    mca_bml_r2.super.bml_rdma_completed = mca_bml_r2.adaptive_weights ? mca_bml_r2_rdma_completed : NULL;
     return &mca_bml_r2.super;
 }
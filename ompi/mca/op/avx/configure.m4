@@ -29,12 +29,14 @@ AC_DEFUN([MCA_ompi_op_avx_CONFIG],[
     op_avx_support=0
     op_avx2_support=0
     op_avx512_support=0
+    op_f16c_support=0
 
     AS_VAR_PUSHDEF([op_avx_check_sse3], [ompi_cv_op_avx_check_sse3])
     AS_VAR_PUSHDEF([op_avx_check_sse41], [ompi_cv_op_avx_check_sse41])
     AS_VAR_PUSHDEF([op_avx_check_avx], [ompi_cv_op_avx_check_avx])
     AS_VAR_PUSHDEF([op_avx_check_avx2], [ompi_cv_op_avx_check_avx2])
     AS_VAR_PUSHDEF([op_avx_check_avx512], [ompi_cv_op_avx_check_avx512])
+    AS_VAR_PUSHDEF([op_avx_check_f16c], [ompi_cv_op_avx_check_f16c])
 
     OPAL_VAR_SCOPE_PUSH([op_avx_cflags_save])
 
@@ -185,6 +187,51 @@ AC_DEFUN([MCA_ompi_op_avx_CONFIG],[
                          CFLAGS="$op_avx_cflags_save"
                         ])])
            #
+           # Check for F16C support, needed by the half-precision (MPIX_C_FLOAT16)
+           # reductions in the AVX2 and AVX512 libraries. The conversion instructions
+           # live in their own ISA extension, so the AVX2 flags alone are not enough.
+           #
+           AC_CACHE_CHECK([for F16C support], op_avx_check_f16c, AS_VAR_SET(op_avx_check_f16c, yes))
+           AS_IF([test $op_avx2_support -eq 1 && test "$op_avx_check_f16c" = "yes"],
+                 [AC_MSG_CHECKING([for F16C support (no additional flags)])
+                  op_avx_cflags_save="$CFLAGS"
+                  CFLAGS="$MCA_BUILD_OP_AVX2_FLAGS $CFLAGS"
+                  AC_LINK_IFELSE(
+                      [AC_LANG_PROGRAM([[#include <immintrin.h>]],
+                              [[
+#if defined(__ICC) && !defined(__F16C__)
+#error "icc needs the -m flags to provide the AVX* detection macros
+#endif
+    __m128i vA;
+    __m256 vB = _mm256_cvtph_ps(vA);
+    vA = _mm256_cvtps_ph(vB, 0)
+                              ]])],
+                      [op_f16c_support=1
+                       AC_MSG_RESULT([yes])],
+                      [AC_MSG_RESULT([no])])
+                  CFLAGS="$op_avx_cflags_save"
+                  AS_IF([test $op_f16c_support -eq 0],
+                      [AC_MSG_CHECKING([for F16C support (with -mf16c)])
+                       CFLAGS="-mf16c $MCA_BUILD_OP_AVX2_FLAGS $CFLAGS"
+                       AC_LINK_IFELSE(
+                           [AC_LANG_PROGRAM([[#include <immintrin.h>]],
+                                   [[
+#if defined(__ICC) && !defined(__F16C__)
+#error "icc needs the -m flags to provide the AVX* detection macros
+#endif
+    __m128i vA;
+    __m256 vB = _mm256_cvtph_ps(vA);
+    vA = _mm256_cvtps_ph(vB, 0)
+                                   ]])],
+                           [op_f16c_support=1
+                            MCA_BUILD_OP_AVX2_FLAGS="$MCA_BUILD_OP_AVX2_FLAGS -mf16c"
+                            AS_IF([test $op_avx512_support -eq 1],
+                                  [MCA_BUILD_OP_AVX512_FLAGS="$MCA_BUILD_OP_AVX512_FLAGS -mf16c"])
+                            AC_MSG_RESULT([yes])],
+                           [AC_MSG_RESULT([no])])
+                       CFLAGS="$op_avx_cflags_save"
+                       ])])
+           #
            # What about early AVX support? The rest of the logic is slightly different as
            # we need to include some of the SSE4.1 and SSE3 instructions. So, we first check
            # if we can compile AVX code without a flag, then we validate that we have support
@@ -305,6 +352,9 @@ AC_DEFUN([MCA_ompi_op_avx_CONFIG],[
     AC_DEFINE_UNQUOTED([OMPI_MCA_OP_HAVE_AVX2],
                        [$op_avx2_support],
                        [AVX2 supported in the current build])
+    AC_DEFINE_UNQUOTED([OMPI_MCA_OP_HAVE_F16C],
+                       [$op_f16c_support],
+                       [F16C supported in the current build])
     AC_DEFINE_UNQUOTED([OMPI_MCA_OP_HAVE_AVX],
                        [$op_avx_support],
                        [AVX supported in the current build])
@@ -329,6 +379,7 @@ AC_DEFUN([MCA_ompi_op_avx_CONFIG],[
     AC_SUBST(MCA_BUILD_OP_AVX_FLAGS)
 
     AS_VAR_POPDEF([op_avx_check_avx512])
+    AS_VAR_POPDEF([op_avx_check_f16c])
     AS_VAR_POPDEF([op_avx_check_avx2])
     AS_VAR_POPDEF([op_avx_check_avx])
     AS_VAR_POPDEF([op_avx_check_sse41])
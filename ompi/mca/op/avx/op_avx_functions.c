@@ -749,6 +749,312 @@ static void OP_CONCAT(ompi_op_avx_2buff_##op##_double,PREPEND)(const void *_in,
     // not defined - OP_AVX_FLOAT_FUNC(xor)
     // not defined - OP_AVX_DOUBLE_FUNC(xor)
 
+/*************************************************************************
+ * Min and max location "pair" datatypes
+ *************************************************************************/
+/*
+ * The pair layouts must match the ones used by the base component. The
+ * value and the index of each pair are loaded in the same vector, the
+ * comparison is done on the value lanes and the resulting mask is then
+ * broadcast over the entire pair. On equality the index lanes are
+ * replaced by the smallest of the two indexes, exactly as in the base
+ * implementation. The padding of the 16 bytes pairs is never altered.
+ *
+ * Only the AVX2 and AVX512 flavors are generated, as the blend and the
+ * 32 bits min on integers are not available with AVX alone.
+ */
+#if defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2)
+#define OP_AVX_LOC_STRUCT(type_name, type1, type2) \
+  typedef struct {                                 \
+      type1 v;                                     \
+      type2 k;                                     \
+  } ompi_op_avx_##type_name##_t;
+
+OP_AVX_LOC_STRUCT(float_int, float, int)
+OP_AVX_LOC_STRUCT(double_int, double, int)
+OP_AVX_LOC_STRUCT(long_int, long, int)
+OP_AVX_LOC_STRUCT(2int, int, int)
+
+#if defined(GENERATE_AVX512_CODE) && defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512)
+#if __AVX512F__
+/* Value lanes: even 32 bits lanes for the 8 bytes pairs, even 64 bits lanes for the 16 bytes pairs */
+#define OP_AVX512_LOC_GT_f32(a, b) _mm512_mask_cmp_ps_mask(0x5555, _mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_GT_OQ)
+#define OP_AVX512_LOC_EQ_f32(a, b) _mm512_mask_cmp_ps_mask(0x5555, _mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_EQ_OQ)
+#define OP_AVX512_LOC_GT_i32(a, b) _mm512_mask_cmpgt_epi32_mask(0x5555, (a), (b))
+#define OP_AVX512_LOC_EQ_i32(a, b) _mm512_mask_cmpeq_epi32_mask(0x5555, (a), (b))
+#define OP_AVX512_LOC_GT_f64(a, b) _mm512_mask_cmp_pd_mask(0x55, _mm512_castsi512_pd(a), _mm512_castsi512_pd(b), _CMP_GT_OQ)
+#define OP_AVX512_LOC_EQ_f64(a, b) _mm512_mask_cmp_pd_mask(0x55, _mm512_castsi512_pd(a), _mm512_castsi512_pd(b), _CMP_EQ_OQ)
+#define OP_AVX512_LOC_GT_i64(a, b) _mm512_mask_cmpgt_epi64_mask(0x55, (a), (b))
+#define OP_AVX512_LOC_EQ_i64(a, b) _mm512_mask_cmpeq_epi64_mask(0x55, (a), (b))
+
+/* 8 bytes pairs: value in the even lane, index in the odd lane */
+static inline __m512i ompi_op_avx_loc_select_8_avx512(__m512i a, __m512i b,
+                                                      __mmask16 take_a, __mmask16 tie)
+{
+    __m512i res = _mm512_mask_blend_epi32(take_a | (take_a << 1), b, a);
+    return _mm512_mask_blend_epi32(tie << 1, res, _mm512_min_epi32(a, b));
+}
+
+/* 16 bytes pairs: value in the even 64 bits lane, index and padding in the odd one */
+static inline __m512i ompi_op_avx_loc_select_16_avx512(__m512i a, __m512i b,
+                                                       __mmask8 take_a, __mmask8 tie)
+{
+    __m512i res = _mm512_mask_blend_epi64(take_a | (take_a << 1), b, a);
+    res = _mm512_mask_blend_epi64(tie << 1, res, _mm512_min_epi32(a, b));
+    return _mm512_mask_blend_epi32(0x8888, res, b);  /* leave the padding untouched */
+}
+
+static inline void ompi_op_avx_loc_store_8_avx512(void *out, __m512i res)
+{
+    _mm512_storeu_si512(out, res);
+}
+
+static inline void ompi_op_avx_loc_store_16_avx512(void *out, __m512i res)
+{
+    _mm512_mask_storeu_epi32(out, 0x7777, res);
+}
+
+#define OP_AVX512_LOC_WINS_maxloc(vtype, a, b) OP_AVX512_LOC_GT_##vtype(a, b)
+#define OP_AVX512_LOC_WINS_minloc(vtype, a, b) OP_AVX512_LOC_GT_##vtype(b, a)
+
+#define OP_AVX_AVX512_LOC_FUNC(name, type_name, vtype, pair_size)             \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX512F_FLAG) ) {                \
+        int types_per_step = (512 / 8) / (pair_size);                          \
+        for( ; left_over >= types_per_step; left_over -= types_per_step ) {    \
+            __m512i vecA = _mm512_loadu_si512((__m512i*)in);                   \
+            in += types_per_step;                                              \
+            __m512i vecB = _mm512_loadu_si512((__m512i*)out);                  \
+            __m512i res = ompi_op_avx_loc_select_##pair_size##_avx512(vecA, vecB, \
+                                      OP_AVX512_LOC_WINS_##name(vtype, vecA, vecB), \
+                                      OP_AVX512_LOC_EQ_##vtype(vecA, vecB));   \
+            _mm512_storeu_si512((__m512i*)out, res);                           \
+            out += types_per_step;                                             \
+        }                                                                      \
+        if( 0 == left_over ) return;                                           \
+    }
+#else
+#error Target architecture lacks AVX512F support needed for _mm512_mask_blend_epi32 and _mm512_min_epi32
+#endif  /* __AVX512F__ */
+#else
+#define OP_AVX_AVX512_LOC_FUNC(name, type_name, vtype, pair_size) {}
+#endif  /* defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512) */
+
+#if __AVX2__
+#define OP_AVX2_LOC_GT_f32(a, b) _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_GT_OQ))
+#define OP_AVX2_LOC_EQ_f32(a, b) _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ))
+#define OP_AVX2_LOC_GT_i32(a, b) _mm256_cmpgt_epi32((a), (b))
+#define OP_AVX2_LOC_EQ_i32(a, b) _mm256_cmpeq_epi32((a), (b))
+#define OP_AVX2_LOC_GT_f64(a, b) _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_GT_OQ))
+#define OP_AVX2_LOC_EQ_f64(a, b) _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ))
+#define OP_AVX2_LOC_GT_i64(a, b) _mm256_cmpgt_epi64((a), (b))
+#define OP_AVX2_LOC_EQ_i64(a, b) _mm256_cmpeq_epi64((a), (b))
+
+/* 8 bytes pairs: value in the even lane, index in the odd lane */
+static inline __m256i ompi_op_avx_loc_select_8_avx2(__m256i a, __m256i b,
+                                                    __m256i take_a, __m256i tie)
+{
+    __m256i res = _mm256_blendv_epi8(b, a, _mm256_shuffle_epi32(take_a, _MM_SHUFFLE(2, 2, 0, 0)));
+    return _mm256_blendv_epi8(res, _mm256_min_epi32(a, b), _mm256_slli_epi64(tie, 32));
+}
+
+/* 16 bytes pairs: value in the even 64 bits lane, index and padding in the odd one */
+static inline __m256i ompi_op_avx_loc_select_16_avx2(__m256i a, __m256i b,
+                                                     __m256i take_a, __m256i tie)
+{
+    __m256d res = _mm256_blendv_pd(_mm256_castsi256_pd(b), _mm256_castsi256_pd(a),
+                                   _mm256_castsi256_pd(_mm256_unpacklo_epi64(take_a, take_a)));
+    res = _mm256_blendv_pd(res, _mm256_castsi256_pd(_mm256_min_epi32(a, b)),
+                           _mm256_castsi256_pd(_mm256_bslli_epi128(tie, 8)));
+    return _mm256_blend_epi32(_mm256_castpd_si256(res), b, 0x88);  /* leave the padding untouched */
+}
+
+static inline void ompi_op_avx_loc_store_8_avx2(void *out, __m256i res)
+{
+    _mm256_storeu_si256((__m256i*)out, res);
+}
+
+static inline void ompi_op_avx_loc_store_16_avx2(void *out, __m256i res)
+{
+    _mm256_maskstore_epi32((int*)out, _mm256_set_epi32(0, -1, -1, -1, 0, -1, -1, -1), res);
+}
+
+#define OP_AVX2_LOC_WINS_maxloc(vtype, a, b) OP_AVX2_LOC_GT_##vtype(a, b)
+#define OP_AVX2_LOC_WINS_minloc(vtype, a, b) OP_AVX2_LOC_GT_##vtype(b, a)
+
+#define OP_AVX_AVX2_LOC_FUNC(name, type_name, vtype, pair_size)               \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX2_FLAG | OMPI_OP_AVX_HAS_AVX_FLAG) ) { \
+        int types_per_step = (256 / 8) / (pair_size);                          \
+        for( ; left_over >= types_per_step; left_over -= types_per_step ) {    \
+            __m256i vecA = _mm256_loadu_si256((__m256i*)in);                   \
+            in += types_per_step;                                              \
+            __m256i vecB = _mm256_loadu_si256((__m256i*)out);                  \
+            __m256i res = ompi_op_avx_loc_select_##pair_size##_avx2(vecA, vecB, \
+                                      OP_AVX2_LOC_WINS_##name(vtype, vecA, vecB), \
+                                      OP_AVX2_LOC_EQ_##vtype(vecA, vecB));     \
+            _mm256_storeu_si256((__m256i*)out, res);                           \
+            out += types_per_step;                                             \
+        }                                                                      \
+        if( 0 == left_over ) return;                                           \
+    }
+#else
+#error Target architecture lacks AVX2 support needed for _mm256_blendv_epi8 and _mm256_min_epi32
+#endif  /* __AVX2__ */
+
+#define OP_AVX_LOC_FUNC(name, type_name, vtype, pair_size)                     \
+static void OP_CONCAT(ompi_op_avx_2buff_##name##_##type_name,PREPEND)(const void *_in, void *_out, int *count, \
+                                                                      struct ompi_datatype_t **dtype, \
+                                                                      struct ompi_op_base_module_1_0_0_t *module) \
+{                                                                              \
+    int left_over = *count;                                                    \
+    ompi_op_avx_##type_name##_t *in = (ompi_op_avx_##type_name##_t*)_in;       \
+    ompi_op_avx_##type_name##_t *out = (ompi_op_avx_##type_name##_t*)_out;     \
+    OP_AVX_AVX512_LOC_FUNC(name, type_name, vtype, pair_size);                 \
+    OP_AVX_AVX2_LOC_FUNC(name, type_name, vtype, pair_size);                   \
+    for( ; left_over > 0; left_over--, in++, out++ ) {                         \
+        if( current_func(in->v, out->v) ) {                                    \
+            out->v = in->v;                                                    \
+            out->k = in->k;                                                    \
+        } else if( in->v == out->v ) {                                         \
+            out->k = (out->k < in->k ? out->k : in->k);                        \
+        }                                                                      \
+    }                                                                          \
+}
+
+/*************************************************************************
+ * Max location
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a) > (b))
+    OP_AVX_LOC_FUNC(maxloc, float_int, f32, 8)
+    OP_AVX_LOC_FUNC(maxloc, double_int, f64, 16)
+#if SIZEOF_LONG == 8
+    OP_AVX_LOC_FUNC(maxloc, long_int, i64, 16)
+#endif
+    OP_AVX_LOC_FUNC(maxloc, 2int, i32, 8)
+
+/*************************************************************************
+ * Min location
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a) < (b))
+    OP_AVX_LOC_FUNC(minloc, float_int, f32, 8)
+    OP_AVX_LOC_FUNC(minloc, double_int, f64, 16)
+#if SIZEOF_LONG == 8
+    OP_AVX_LOC_FUNC(minloc, long_int, i64, 16)
+#endif
+    OP_AVX_LOC_FUNC(minloc, 2int, i32, 8)
+#endif  /* defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2) */
+
+/*************************************************************************
+ * Half precision floating point (MPIX_C_FLOAT16)
+ *
+ * There are no arithmetic instructions on 16 bits floats before AVX512-FP16,
+ * so the values are widened to single precision (F16C or AVX512F), the
+ * operation is done in single precision and the result is rounded back to
+ * half precision. This is exactly what the compiler does for the scalar
+ * version, so both generate bitwise identical results.
+ *************************************************************************/
+#if (defined(HAVE_SHORT_FLOAT) && (2 == SIZEOF_SHORT_FLOAT)) || \
+    (defined(HAVE_OPAL_SHORT_FLOAT_T) && (2 == SIZEOF_OPAL_SHORT_FLOAT_T))
+#if (defined(GENERATE_AVX512_CODE) && defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512)) || \
+    (defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_F16C) && (1 == OMPI_MCA_OP_HAVE_F16C))
+#define OP_AVX_HAS_SHORT_FLOAT 1
+
+#if defined(HAVE_SHORT_FLOAT)
+typedef short float ompi_op_avx_short_float_t;
+#else
+typedef opal_short_float_t ompi_op_avx_short_float_t;
+#endif  /* defined(HAVE_SHORT_FLOAT) */
+
+#define OP_AVX_HALF_ROUNDING (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+
+#if defined(GENERATE_AVX512_CODE) && defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512)
+#if __AVX512F__
+#define OP_AVX_AVX512_HALF_FUNC(op)                                     \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX512F_FLAG) ) {         \
+        types_per_step = (512 / 8) / sizeof(float);                     \
+        for (; left_over >= types_per_step; left_over -= types_per_step) { \
+            __m512 vecA = _mm512_cvtph_ps(_mm256_loadu_si256((__m256i*)in)); \
+            __m512 vecB = _mm512_cvtph_ps(_mm256_loadu_si256((__m256i*)out)); \
+            in += types_per_step;                                       \
+            __m512 res = _mm512_##op##_ps(vecA, vecB);                  \
+            _mm256_storeu_si256((__m256i*)out, _mm512_cvtps_ph(res, OP_AVX_HALF_ROUNDING)); \
+            out += types_per_step;                                      \
+        }                                                               \
+        if( 0 == left_over ) return;                                    \
+    }
+#else
+#error Target architecture lacks AVX512F support needed for _mm512_cvtph_ps and _mm512_cvtps_ph
+#endif  /* __AVX512F__ */
+#else
+#define OP_AVX_AVX512_HALF_FUNC(op) {}
+#endif  /* defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512) */
+
+#if defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_F16C) && (1 == OMPI_MCA_OP_HAVE_F16C)
+#if __F16C__ && __AVX__
+#define OP_AVX_F16C_HALF_FUNC(op)                                       \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX_FLAG | OMPI_OP_AVX_HAS_F16C_FLAG) ) { \
+        types_per_step = (256 / 8) / sizeof(float);                     \
+        for( ; left_over >= types_per_step; left_over -= types_per_step ) { \
+            __m256 vecA = _mm256_cvtph_ps(_mm_loadu_si128((__m128i*)in)); \
+            in += types_per_step;                                       \
+            __m256 vecB = _mm256_cvtph_ps(_mm_loadu_si128((__m128i*)out)); \
+            __m256 res = _mm256_##op##_ps(vecA, vecB);                  \
+            _mm_storeu_si128((__m128i*)out, _mm256_cvtps_ph(res, OP_AVX_HALF_ROUNDING)); \
+            out += types_per_step;                                      \
+        }                                                               \
+        if( 0 == left_over ) return;                                    \
+    }
+#else
+#error Target architecture lacks F16C support needed for _mm256_cvtph_ps and _mm256_cvtps_ph
+#endif  /* __F16C__ && __AVX__ */
+#else
+#define OP_AVX_F16C_HALF_FUNC(op) {}
+#endif  /* defined(OMPI_MCA_OP_HAVE_F16C) && (1 == OMPI_MCA_OP_HAVE_F16C) */
+
+#define OP_AVX_HALF_FUNC(op)                                            \
+static void OP_CONCAT(ompi_op_avx_2buff_##op##_short_float,PREPEND)(const void *_in, void *_out, int *count, \
+                                                                    struct ompi_datatype_t **dtype, \
+                                                                    struct ompi_op_base_module_1_0_0_t *module) \
+{                                                                       \
+    int types_per_step, left_over = *count;                             \
+    ompi_op_avx_short_float_t *in = (ompi_op_avx_short_float_t*)_in,    \
+        *out = (ompi_op_avx_short_float_t*)_out;                        \
+    OP_AVX_AVX512_HALF_FUNC(op);                                        \
+    OP_AVX_F16C_HALF_FUNC(op);                                          \
+    while( left_over > 0 ) {                                            \
+        int how_much = (left_over > 8) ? 8 : left_over;                 \
+        switch(how_much) {                                              \
+        case 8: out[7] = current_func(out[7], in[7]);                   \
+        case 7: out[6] = current_func(out[6], in[6]);                   \
+        case 6: out[5] = current_func(out[5], in[5]);                   \
+        case 5: out[4] = current_func(out[4], in[4]);                   \
+        case 4: out[3] = current_func(out[3], in[3]);                   \
+        case 3: out[2] = current_func(out[2], in[2]);                   \
+        case 2: out[1] = current_func(out[1], in[1]);                   \
+        case 1: out[0] = current_func(out[0], in[0]);                   \
+        }                                                               \
+        left_over -= how_much;                                          \
+        out += how_much;                                                \
+        in += how_much;                                                 \
+    }                                                                   \
+}
+
+#undef current_func
+#define current_func(a, b) ((a) > (b) ? (a) : (b))
+    OP_AVX_HALF_FUNC(max)
+#undef current_func
+#define current_func(a, b) ((a) < (b) ? (a) : (b))
+    OP_AVX_HALF_FUNC(min)
+#undef current_func
+#define current_func(a, b) ((a) + (b))
+    OP_AVX_HALF_FUNC(add)
+#undef current_func
+#define current_func(a, b) ((a) * (b))
+    OP_AVX_HALF_FUNC(mul)
+#endif  /* AVX512F or F16C code generation */
+#endif  /* 16 bits short float */
+
 /*
  *  This is a three buffer (2 input and 1 output) version of the reduction
  *  routines, needed for some optimizations.
@@ -1337,6 +1643,202 @@ static void OP_CONCAT(ompi_op_avx_3buff_##op##_double,PREPEND)(const void *_in1,
     // not defined - OP_AVX_FLOAT_FUNC_3(xor)
     // not defined - OP_AVX_DOUBLE_FUNC_3(xor)
 
+/*************************************************************************
+ * Min and max location "pair" datatypes
+ *************************************************************************/
+/*
+ * On equality the value is taken from the first input, so the first
+ * input wins the value lanes for both the strict comparison and the
+ * equality, and the index lanes are then fixed for the equality.
+ */
+#if defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2)
+#if defined(GENERATE_AVX512_CODE) && defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512)
+#define OP_AVX_AVX512_LOC_FUNC_3(name, type_name, vtype, pair_size)           \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX512F_FLAG) ) {                \
+        int types_per_step = (512 / 8) / (pair_size);                          \
+        for( ; left_over >= types_per_step; left_over -= types_per_step ) {    \
+            __m512i vecA = _mm512_loadu_si512((__m512i*)in1);                  \
+            __m512i vecB = _mm512_loadu_si512((__m512i*)in2);                  \
+            in1 += types_per_step;                                             \
+            in2 += types_per_step;                                             \
+            __mmask16 tie = OP_AVX512_LOC_EQ_##vtype(vecA, vecB);              \
+            __m512i res = ompi_op_avx_loc_select_##pair_size##_avx512(vecA, vecB, \
+                                      OP_AVX512_LOC_WINS_##name(vtype, vecA, vecB) | tie, \
+                                      tie);                                    \
+            ompi_op_avx_loc_store_##pair_size##_avx512(out, res);              \
+            out += types_per_step;                                             \
+        }                                                                      \
+        if( 0 == left_over ) return;                                           \
+    }
+#else
+#define OP_AVX_AVX512_LOC_FUNC_3(name, type_name, vtype, pair_size) {}
+#endif  /* defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512) */
+
+#define OP_AVX_AVX2_LOC_FUNC_3(name, type_name, vtype, pair_size)             \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX2_FLAG | OMPI_OP_AVX_HAS_AVX_FLAG) ) { \
+        int types_per_step = (256 / 8) / (pair_size);                          \
+        for( ; left_over >= types_per_step; left_over -= types_per_step ) {    \
+            __m256i vecA = _mm256_loadu_si256((__m256i*)in1);                  \
+            __m256i vecB = _mm256_loadu_si256((__m256i*)in2);                  \
+            in1 += types_per_step;                                             \
+            in2 += types_per_step;                                             \
+            __m256i tie = OP_AVX2_LOC_EQ_##vtype(vecA, vecB);                  \
+            __m256i res = ompi_op_avx_loc_select_##pair_size##_avx2(vecA, vecB, \
+                                      _mm256_or_si256(OP_AVX2_LOC_WINS_##name(vtype, vecA, vecB), tie), \
+                                      tie);                                    \
+            ompi_op_avx_loc_store_##pair_size##_avx2(out, res);                \
+            out += types_per_step;                                             \
+        }                                                                      \
+        if( 0 == left_over ) return;                                           \
+    }
+
+#define OP_AVX_LOC_FUNC_3(name, type_name, vtype, pair_size)                   \
+static void OP_CONCAT(ompi_op_avx_3buff_##name##_##type_name,PREPEND)(const void * restrict _in1, \
+                                                                      const void * restrict _in2, \
+                                                                      void * restrict _out, int *count, \
+                                                                      struct ompi_datatype_t **dtype, \
+                                                                      struct ompi_op_base_module_1_0_0_t *module) \
+{                                                                              \
+    int left_over = *count;                                                    \
+    ompi_op_avx_##type_name##_t *in1 = (ompi_op_avx_##type_name##_t*)_in1;     \
+    ompi_op_avx_##type_name##_t *in2 = (ompi_op_avx_##type_name##_t*)_in2;     \
+    ompi_op_avx_##type_name##_t *out = (ompi_op_avx_##type_name##_t*)_out;     \
+    OP_AVX_AVX512_LOC_FUNC_3(name, type_name, vtype, pair_size);               \
+    OP_AVX_AVX2_LOC_FUNC_3(name, type_name, vtype, pair_size);                 \
+    for( ; left_over > 0; left_over--, in1++, in2++, out++ ) {                 \
+        if( current_func(in1->v, in2->v) ) {                                   \
+            out->v = in1->v;                                                   \
+            out->k = in1->k;                                                   \
+        } else if( in1->v == in2->v ) {                                        \
+            out->v = in1->v;                                                   \
+            out->k = (in2->k < in1->k ? in2->k : in1->k);                      \
+        } else {                                                               \
+            out->v = in2->v;                                                   \
+            out->k = in2->k;                                                   \
+        }                                                                      \
+    }                                                                          \
+}
+
+/*************************************************************************
+ * Max location
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a) > (b))
+    OP_AVX_LOC_FUNC_3(maxloc, float_int, f32, 8)
+    OP_AVX_LOC_FUNC_3(maxloc, double_int, f64, 16)
+#if SIZEOF_LONG == 8
+    OP_AVX_LOC_FUNC_3(maxloc, long_int, i64, 16)
+#endif
+    OP_AVX_LOC_FUNC_3(maxloc, 2int, i32, 8)
+
+/*************************************************************************
+ * Min location
+ *************************************************************************/
+#undef current_func
+#define current_func(a, b) ((a) < (b))
+    OP_AVX_LOC_FUNC_3(minloc, float_int, f32, 8)
+    OP_AVX_LOC_FUNC_3(minloc, double_int, f64, 16)
+#if SIZEOF_LONG == 8
+    OP_AVX_LOC_FUNC_3(minloc, long_int, i64, 16)
+#endif
+    OP_AVX_LOC_FUNC_3(minloc, 2int, i32, 8)
+#endif  /* defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2) */
+
+/*************************************************************************
+ * Half precision floating point (MPIX_C_FLOAT16)
+ *************************************************************************/
+#if defined(OP_AVX_HAS_SHORT_FLOAT)
+#if defined(GENERATE_AVX512_CODE) && defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512)
+#if __AVX512F__
+#define OP_AVX_AVX512_HALF_FUNC_3(op)                                   \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX512F_FLAG) ) {         \
+        types_per_step = (512 / 8) / sizeof(float);                     \
+        for (; left_over >= types_per_step; left_over -= types_per_step) { \
+            __m512 vecA = _mm512_cvtph_ps(_mm256_loadu_si256((__m256i*)in1)); \
+            __m512 vecB = _mm512_cvtph_ps(_mm256_loadu_si256((__m256i*)in2)); \
+            in1 += types_per_step;                                      \
+            in2 += types_per_step;                                      \
+            __m512 res = _mm512_##op##_ps(vecA, vecB);                  \
+            _mm256_storeu_si256((__m256i*)out, _mm512_cvtps_ph(res, OP_AVX_HALF_ROUNDING)); \
+            out += types_per_step;                                      \
+        }                                                               \
+        if( 0 == left_over ) return;                                    \
+    }
+#else
+#error Target architecture lacks AVX512F support needed for _mm512_cvtph_ps and _mm512_cvtps_ph
+#endif  /* __AVX512F__ */
+#else
+#define OP_AVX_AVX512_HALF_FUNC_3(op) {}
+#endif  /* defined(OMPI_MCA_OP_HAVE_AVX512) && (1 == OMPI_MCA_OP_HAVE_AVX512) */
+
+#if defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_F16C) && (1 == OMPI_MCA_OP_HAVE_F16C)
+#if __F16C__ && __AVX__
+#define OP_AVX_F16C_HALF_FUNC_3(op)                                     \
+    if( OMPI_OP_AVX_HAS_FLAGS(OMPI_OP_AVX_HAS_AVX_FLAG | OMPI_OP_AVX_HAS_F16C_FLAG) ) { \
+        types_per_step = (256 / 8) / sizeof(float);                     \
+        for( ; left_over >= types_per_step; left_over -= types_per_step ) { \
+            __m256 vecA = _mm256_cvtph_ps(_mm_loadu_si128((__m128i*)in1)); \
+            __m256 vecB = _mm256_cvtph_ps(_mm_loadu_si128((__m128i*)in2)); \
+            in1 += types_per_step;                                      \
+            in2 += types_per_step;                                      \
+            __m256 res = _mm256_##op##_ps(vecA, vecB);                  \
+            _mm_storeu_si128((__m128i*)out, _mm256_cvtps_ph(res, OP_AVX_HALF_ROUNDING)); \
+            out += types_per_step;                                      \
+        }                                                               \
+        if( 0 == left_over ) return;                                    \
+    }
+#else
+#error Target architecture lacks F16C support needed for _mm256_cvtph_ps and _mm256_cvtps_ph
+#endif  /* __F16C__ && __AVX__ */
+#else
+#define OP_AVX_F16C_HALF_FUNC_3(op) {}
+#endif  /* defined(OMPI_MCA_OP_HAVE_F16C) && (1 == OMPI_MCA_OP_HAVE_F16C) */
+
+#define OP_AVX_HALF_FUNC_3(op)                                          \
+static void OP_CONCAT(ompi_op_avx_3buff_##op##_short_float,PREPEND)(const void *_in1, const void *_in2, \
+                                                                    void *_out, int *count, \
+                                                                    struct ompi_datatype_t **dtype, \
+                                                                    struct ompi_op_base_module_1_0_0_t *module) \
+{                                                                       \
+    int types_per_step, left_over = *count;                             \
+    ompi_op_avx_short_float_t *in1 = (ompi_op_avx_short_float_t*)_in1, \
+        *in2 = (ompi_op_avx_short_float_t*)_in2,                        \
+        *out = (ompi_op_avx_short_float_t*)_out;                        \
+    OP_AVX_AVX512_HALF_FUNC_3(op);                                      \
+    OP_AVX_F16C_HALF_FUNC_3(op);                                        \
+    while( left_over > 0 ) {                                            \
+        int how_much = (left_over > 8) ? 8 : left_over;                 \
+        switch(how_much) {                                              \
+        case 8: out[7] = current_func(in1[7], in2[7]);                  \
+        case 7: out[6] = current_func(in1[6], in2[6]);                  \
+        case 6: out[5] = current_func(in1[5], in2[5]);                  \
+        case 5: out[4] = current_func(in1[4], in2[4]);                  \
+        case 4: out[3] = current_func(in1[3], in2[3]);                  \
+        case 3: out[2] = current_func(in1[2], in2[2]);                  \
+        case 2: out[1] = current_func(in1[1], in2[1]);                  \
+        case 1: out[0] = current_func(in1[0], in2[0]);                  \
+        }                                                               \
+        left_over -= how_much;                                          \
+        out += how_much;                                                \
+        in1 += how_much;                                                \
+        in2 += how_much;                                                \
+    }                                                                   \
+}
+
+#undef current_func
+#define current_func(a, b) ((a) > (b) ? (a) : (b))
+    OP_AVX_HALF_FUNC_3(max)
+#undef current_func
+#define current_func(a, b) ((a) < (b) ? (a) : (b))
+    OP_AVX_HALF_FUNC_3(min)
+#undef current_func
+#define current_func(a, b) ((a) + (b))
+    OP_AVX_HALF_FUNC_3(add)
+#undef current_func
+#define current_func(a, b) ((a) * (b))
+    OP_AVX_HALF_FUNC_3(mul)
+#endif  /* defined(OP_AVX_HAS_SHORT_FLOAT) */
+
 /** C integer ***********************************************************/
 #define C_INTEGER_8_16_32(name, ftype)                                                         \
     [OMPI_OP_BASE_TYPE_INT8_T]   = OP_CONCAT(ompi_op_avx_##ftype##_##name##_int8_t,PREPEND),   \
@@ -1365,11 +1867,34 @@ static void OP_CONCAT(ompi_op_avx_3buff_##op##_double,PREPEND)(const void *_in1,
 #define FLOAT(name, ftype) OP_CONCAT(ompi_op_avx_##ftype##_##name##_float,PREPEND)
 #define DOUBLE(name, ftype) OP_CONCAT(ompi_op_avx_##ftype##_##name##_double,PREPEND)
 
+#if defined(OP_AVX_HAS_SHORT_FLOAT)
+#define SHORT_FLOAT(name, ftype) OP_CONCAT(ompi_op_avx_##ftype##_##name##_short_float,PREPEND)
+#else
+#define SHORT_FLOAT(name, ftype) NULL
+#endif  /* defined(OP_AVX_HAS_SHORT_FLOAT) */
+
 #define FLOATING_POINT(name, ftype)                                         \
-    [OMPI_OP_BASE_TYPE_SHORT_FLOAT] = NULL,                                 \
+    [OMPI_OP_BASE_TYPE_SHORT_FLOAT] = SHORT_FLOAT(name, ftype),             \
     [OMPI_OP_BASE_TYPE_FLOAT] = FLOAT(name, ftype),                         \
     [OMPI_OP_BASE_TYPE_DOUBLE] = DOUBLE(name, ftype)
 
+/** Min and max location pairs ******************************************/
+#if defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2)
+#if SIZEOF_LONG == 8
+#define TWOLOC_LONG_INT(name, ftype) OP_CONCAT(ompi_op_avx_##ftype##_##name##_long_int,PREPEND)
+#else
+#define TWOLOC_LONG_INT(name, ftype) NULL
+#endif  /* SIZEOF_LONG == 8 */
+
+#define TWOLOC(name, ftype)                                                                        \
+    [OMPI_OP_BASE_TYPE_FLOAT_INT] = OP_CONCAT(ompi_op_avx_##ftype##_##name##_float_int,PREPEND),   \
+    [OMPI_OP_BASE_TYPE_DOUBLE_INT] = OP_CONCAT(ompi_op_avx_##ftype##_##name##_double_int,PREPEND), \
+    [OMPI_OP_BASE_TYPE_LONG_INT] = TWOLOC_LONG_INT(name, ftype),                                   \
+    [OMPI_OP_BASE_TYPE_2INT] = OP_CONCAT(ompi_op_avx_##ftype##_##name##_2int,PREPEND)
+#else
+#define TWOLOC(name, ftype) NULL
+#endif  /* defined(GENERATE_AVX2_CODE) && defined(OMPI_MCA_OP_HAVE_AVX2) && (1 == OMPI_MCA_OP_HAVE_AVX2) */
+
 /*
  * MPI_OP_NULL
  * All types
@@ -1431,6 +1956,14 @@ ompi_op_base_handler_fn_t OP_CONCAT(ompi_op_avx_functions, PREPEND)[OMPI_OP_BASE
     [OMPI_OP_BASE_FORTRAN_BXOR] = {
         C_INTEGER(bxor, 2buff),
     },
+    /* Corresponds to MPI_MAXLOC */
+    [OMPI_OP_BASE_FORTRAN_MAXLOC] = {
+        TWOLOC(maxloc, 2buff),
+    },
+    /* Corresponds to MPI_MINLOC */
+    [OMPI_OP_BASE_FORTRAN_MINLOC] = {
+        TWOLOC(minloc, 2buff),
+    },
     /* Corresponds to MPI_REPLACE */
     [OMPI_OP_BASE_FORTRAN_REPLACE] = {
         /* (MPI_ACCUMULATE is handled differently than the other
@@ -1494,6 +2027,14 @@ ompi_op_base_3buff_handler_fn_t OP_CONCAT(ompi_op_avx_3buff_functions, PREPEND)[
     [OMPI_OP_BASE_FORTRAN_BXOR] = {
         C_INTEGER(xor, 3buff),
     },
+    /* Corresponds to MPI_MAXLOC */
+    [OMPI_OP_BASE_FORTRAN_MAXLOC] = {
+        TWOLOC(maxloc, 3buff),
+    },
+    /* Corresponds to MPI_MINLOC */
+    [OMPI_OP_BASE_FORTRAN_MINLOC] = {
+        TWOLOC(minloc, 3buff),
+    },
     /* Corresponds to MPI_REPLACE */
     [OMPI_OP_BASE_FORTRAN_REPLACE] = {
         /* MPI_ACCUMULATE is handled differently than the other
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_OP_MT_EXPORT_H
+#define MCA_OP_MT_EXPORT_H
+
+#include "ompi_config.h"
+
+#include "ompi/mca/mca.h"
+#include "opal/class/opal_object.h"
+
+#include "ompi/mca/op/op.h"
+
+BEGIN_C_DECLS
+
+/**
+ * The mt component does not provide any reduction kernel of its own.
+ * It sits on top of the other op components (base, avx, ...) and, for
+ * buffers larger than a threshold, splits the reduction in contiguous
+ * chunks that are handed to the opal thread pool. Each chunk
+ * is reduced with the function that would have been used without this
+ * component.
+ */
+typedef struct {
+    /** The base op component struct */
+    ompi_op_base_component_1_0_0_t super;
+
+    /** Priority of the component, must be higher than the priority of
+        the components providing the kernels */
+    int priority;
+    /** Size in bytes above which a reduction is split across threads */
+    size_t threshold;
+    /** Minimum amount of bytes handed to each thread */
+    size_t min_chunk;
+} ompi_op_mt_component_t;
+
+/**
+ * One module per MPI_Op. It caches the functions (and their modules)
+ * that were selected before the mt component, and that are used to
+ * reduce each chunk.
+ */
+typedef struct {
+    ompi_op_base_module_1_0_0_t super;
+
+    ompi_op_base_handler_fn_t fallback_fns[OMPI_OP_BASE_TYPE_MAX];
+    ompi_op_base_module_t *fallback_modules[OMPI_OP_BASE_TYPE_MAX];
+    ompi_op_base_3buff_handler_fn_t fallback_3buff_fns[OMPI_OP_BASE_TYPE_MAX];
+    ompi_op_base_module_t *fallback_3buff_modules[OMPI_OP_BASE_TYPE_MAX];
+} ompi_op_mt_module_t;
+
+OBJ_CLASS_DECLARATION(ompi_op_mt_module_t);
+
+/**
+ * Globally exported variable.
+ */
+OMPI_DECLSPEC extern ompi_op_mt_component_t mca_op_mt_component;
+
+/**
+ * Create the module for an intrinsic MPI_Op.
+ */
+ompi_op_base_module_t *ompi_op_mt_module_create(struct ompi_op_t *op);
+
+END_C_DECLS
+
+#endif /* MCA_OP_MT_EXPORT_H */
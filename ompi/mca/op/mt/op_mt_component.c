@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * This is the "mt" component source code. It splits the reduction of
+ * large buffers across the opal pool of helper threads.
+ */
+
+#include "ompi_config.h"
+
+#include "opal/mca/threads/thread_pool.h"
+
+#include "ompi/constants.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/op/op.h"
+#include "ompi/mca/op/base/base.h"
+#include "ompi/mca/op/mt/op_mt.h"
+
+static int mt_component_open(void);
+static int mt_component_close(void);
+static int mt_component_init_query(bool enable_progress_threads,
+                                   bool enable_mpi_thread_multiple);
+static struct ompi_op_base_module_1_0_0_t *
+    mt_component_op_query(struct ompi_op_t *op, int *priority);
+static int mt_component_register(void);
+
+ompi_op_mt_component_t mca_op_mt_component = {
+    {
+        .opc_version = {
+            OMPI_OP_BASE_VERSION_1_0_0,
+
+            .mca_component_name = "mt",
+            MCA_BASE_MAKE_VERSION(component, OMPI_MAJOR_VERSION, OMPI_MINOR_VERSION,
+                                  OMPI_RELEASE_VERSION),
+            .mca_open_component = mt_component_open,
+            .mca_close_component = mt_component_close,
+            .mca_register_component_params = mt_component_register,
+        },
+        .opc_data = {
+            /* The component is checkpoint ready */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        },
+
+        .opc_init_query = mt_component_init_query,
+        .opc_op_query = mt_component_op_query,
+    },
+};
+
+/*
+ * Component open
+ */
+static int mt_component_open(void)
+{
+    return opal_thread_pool_init();
+}
+
+/*
+ * Component close
+ */
+static int mt_component_close(void)
+{
+    /* The helper threads are stopped with the last user of the pool */
+    opal_thread_pool_fini();
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Register MCA params.
+ */
+static int
+mt_component_register(void)
+{
+    mca_op_mt_component.priority = 75;
+    (void) mca_base_component_var_register(&mca_op_mt_component.super.opc_version,
+                                           "priority",
+                                           "Priority of the mt op component. It must be higher than the "
+                                           "priority of the components providing the reduction kernels "
+                                           "(avx uses 50)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_op_mt_component.priority);
+
+    mca_op_mt_component.threshold = 4 * 1024 * 1024;
+    (void) mca_base_component_var_register(&mca_op_mt_component.super.opc_version,
+                                           "threshold",
+                                           "Size in bytes of the buffers above which a reduction is split "
+                                           "across the helper threads (default: 4MiB)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_op_mt_component.threshold);
+
+    mca_op_mt_component.min_chunk = 512 * 1024;
+    (void) mca_base_component_var_register(&mca_op_mt_component.super.opc_version,
+                                           "min_chunk",
+                                           "Minimum number of bytes reduced by each thread. Reductions "
+                                           "slightly above the threshold use fewer threads "
+                                           "(default: 512KiB)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_op_mt_component.min_chunk);
+
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Query whether this component wants to be used in this process.
+ */
+static int
+mt_component_init_query(bool enable_progress_threads,
+                        bool enable_mpi_thread_multiple)
+{
+    if (opal_thread_pool_size <= 0) {
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+    if (mca_op_mt_component.min_chunk == 0) {
+        mca_op_mt_component.min_chunk = 1;
+    }
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Query whether this component can be used for a specific op
+ */
+static struct ompi_op_base_module_1_0_0_t *
+mt_component_op_query(struct ompi_op_t *op, int *priority)
+{
+    ompi_op_base_module_t *module = NULL;
+
+    /* Sanity check -- although the framework should never invoke the
+       _component_op_query() on non-intrinsic MPI_Op's, we'll put a
+       check here just to be sure. */
+    if (0 == (OMPI_OP_FLAGS_INTRINSIC & op->o_flags)) {
+        return NULL;
+    }
+
+    switch (op->o_f_to_c_index) {
+    case OMPI_OP_BASE_FORTRAN_MAX:
+    case OMPI_OP_BASE_FORTRAN_MIN:
+    case OMPI_OP_BASE_FORTRAN_SUM:
+    case OMPI_OP_BASE_FORTRAN_PROD:
+    case OMPI_OP_BASE_FORTRAN_LAND:
+    case OMPI_OP_BASE_FORTRAN_BAND:
+    case OMPI_OP_BASE_FORTRAN_LOR:
+    case OMPI_OP_BASE_FORTRAN_BOR:
+    case OMPI_OP_BASE_FORTRAN_LXOR:
+    case OMPI_OP_BASE_FORTRAN_BXOR:
+    case OMPI_OP_BASE_FORTRAN_MAXLOC:
+    case OMPI_OP_BASE_FORTRAN_MINLOC:
+        module = ompi_op_mt_module_create(op);
+        break;
+    case OMPI_OP_BASE_FORTRAN_REPLACE:
+    case OMPI_OP_BASE_FORTRAN_NO_OP:
+    default:
+        break;
+    }
+
+    if (NULL != module) {
+        *priority = mca_op_mt_component.priority;
+    }
+    return (ompi_op_base_module_1_0_0_t *) module;
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * The mt module wraps, for every datatype, the function selected by the
+ * lower priority op components. Small reductions are forwarded as is,
+ * large ones are split across the helper threads.
+ */
+
+#include "ompi_config.h"
+
+#include "opal/class/opal_object.h"
+#include "opal/mca/threads/thread_pool.h"
+
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/op/op.h"
+#include "ompi/mca/op/base/base.h"
+#include "ompi/mca/op/mt/op_mt.h"
+
+static void mt_module_constructor(ompi_op_mt_module_t *m)
+{
+    for (int i = 0; i < OMPI_OP_BASE_TYPE_MAX; ++i) {
+        m->fallback_fns[i] = NULL;
+        m->fallback_modules[i] = NULL;
+        m->fallback_3buff_fns[i] = NULL;
+        m->fallback_3buff_modules[i] = NULL;
+    }
+}
+
+static void mt_module_destructor(ompi_op_mt_module_t *m)
+{
+    for (int i = 0; i < OMPI_OP_BASE_TYPE_MAX; ++i) {
+        if (NULL != m->fallback_modules[i]) {
+            OBJ_RELEASE(m->fallback_modules[i]);
+        }
+        if (NULL != m->fallback_3buff_modules[i]) {
+            OBJ_RELEASE(m->fallback_3buff_modules[i]);
+        }
+    }
+}
+
+OBJ_CLASS_INSTANCE(ompi_op_mt_module_t,
+                   ompi_op_base_module_t,
+                   mt_module_constructor,
+                   mt_module_destructor);
+
+/* Chunks are a multiple of this many elements, so that threads do not
+   share cache lines at the chunk boundaries */
+#define OP_MT_CHUNK_ALIGN 64
+
+typedef struct {
+    ompi_op_base_handler_fn_t fn;
+    ompi_op_base_3buff_handler_fn_t fn_3buff;
+    ompi_op_base_module_t *module;
+    struct ompi_datatype_t *dtype;
+    const char *in1;
+    const char *in2;
+    char *out;
+    size_t elem_size;
+    int count;
+    int per_part;
+} op_mt_job_t;
+
+static void mt_reduce_part(void *arg, int part)
+{
+    op_mt_job_t *job = (op_mt_job_t *) arg;
+    size_t offset;
+    int start = part * job->per_part, count;
+
+    if (start >= job->count) {
+        return;
+    }
+    count = job->count - start;
+    if (count > job->per_part) {
+        count = job->per_part;
+    }
+    offset = (size_t) start * job->elem_size;
+    if (NULL != job->fn) {
+        job->fn(job->in1 + offset, job->out + offset, &count,
+                &job->dtype, job->module);
+    } else {
+        job->fn_3buff(job->in1 + offset, job->in2 + offset, job->out + offset, &count,
+                      &job->dtype, job->module);
+    }
+}
+
+/*
+ * Reduce count elements of size elem_size with the helper threads.
+ * Exactly one of fn and fn_3buff is not NULL. Returns
+ * OMPI_ERR_TEMP_OUT_OF_RESOURCE if the pool is busy (or cannot be
+ * started), in which case the caller must reduce the buffers by itself.
+ */
+static int mt_reduce(ompi_op_base_handler_fn_t fn,
+                     ompi_op_base_3buff_handler_fn_t fn_3buff,
+                     ompi_op_base_module_t *module,
+                     const void *in1, const void *in2, void *out,
+                     int count, size_t elem_size,
+                     struct ompi_datatype_t *dtype)
+{
+    op_mt_job_t job = {.fn = fn, .fn_3buff = fn_3buff, .module = module, .dtype = dtype,
+                       .in1 = (const char *) in1, .in2 = (const char *) in2,
+                       .out = (char *) out, .elem_size = elem_size, .count = count};
+    size_t nparts;
+
+    /* Do not wake more threads than there is work for */
+    nparts = ((size_t) count * elem_size) / mca_op_mt_component.min_chunk;
+    if (nparts > (size_t) opal_thread_pool_concurrency()) {
+        nparts = opal_thread_pool_concurrency();
+    }
+    if (nparts < 2) {
+        return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+    }
+    job.per_part = (int) (((size_t) count + nparts - 1) / nparts);
+    job.per_part = ((job.per_part + OP_MT_CHUNK_ALIGN - 1) / OP_MT_CHUNK_ALIGN) * OP_MT_CHUNK_ALIGN;
+
+    if (OPAL_SUCCESS != opal_thread_pool_submit(mt_reduce_part, &job, (int) nparts)) {
+        return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+    }
+    opal_thread_pool_wait();
+    return OMPI_SUCCESS;
+}
+
+/*
+ * ompi_op_reduce hands the derived datatypes to ompi_op_reduce_derived,
+ * which calls the module functions on the predefined type of each block,
+ * so the datatype is predefined on that path. A derived datatype made of
+ * a single predefined type can still reach us from a direct call of the
+ * functions: it is not split, and goes to the fallback of its predefined
+ * type (elem_size is then 0). The element size is the extent, as the
+ * pair types used by MINLOC/MAXLOC are padded.
+ */
+static inline int mt_type_index(struct ompi_datatype_t *dtype, size_t *elem_size)
+{
+    ptrdiff_t extent;
+
+    if (OPAL_UNLIKELY(!ompi_datatype_is_predefined(dtype))) {
+        *elem_size = 0;
+        return ompi_op_ddt_map[ompi_datatype_get_single_predefined_type_from_args(dtype)->id];
+    }
+    ompi_datatype_type_extent(dtype, &extent);
+    *elem_size = (size_t) extent;
+    return ompi_op_ddt_map[dtype->id];
+}
+
+static void mt_2buff(const void *in, void *out, int *count,
+                     struct ompi_datatype_t **dtype,
+                     struct ompi_op_base_module_1_0_0_t *module)
+{
+    ompi_op_mt_module_t *m = (ompi_op_mt_module_t *) module;
+    size_t elem_size;
+    int idx = mt_type_index(*dtype, &elem_size);
+
+    if ((size_t) *count * elem_size >= mca_op_mt_component.threshold &&
+        OMPI_SUCCESS == mt_reduce(m->fallback_fns[idx], NULL, m->fallback_modules[idx],
+                                  in, NULL, out, *count, elem_size, *dtype)) {
+        return;
+    }
+    m->fallback_fns[idx](in, out, count, dtype, m->fallback_modules[idx]);
+}
+
+static void mt_3buff(const void *in1, const void *in2, void *out, int *count,
+                     struct ompi_datatype_t **dtype,
+                     struct ompi_op_base_module_1_0_0_t *module)
+{
+    ompi_op_mt_module_t *m = (ompi_op_mt_module_t *) module;
+    size_t elem_size;
+    int idx = mt_type_index(*dtype, &elem_size);
+
+    if ((size_t) *count * elem_size >= mca_op_mt_component.threshold &&
+        OMPI_SUCCESS == mt_reduce(NULL, m->fallback_3buff_fns[idx],
+                                  m->fallback_3buff_modules[idx],
+                                  in1, in2, out, *count, elem_size, *dtype)) {
+        return;
+    }
+    m->fallback_3buff_fns[idx](in1, in2, out, count, dtype,
+                               m->fallback_3buff_modules[idx]);
+}
+
+/*
+ * The enable function is called by the selection logic in increasing
+ * priority order, right before the module functions are copied on the
+ * op. At this point the op holds the best functions provided by the
+ * lower priority components, which become our fallbacks.
+ */
+static int mt_module_enable(ompi_op_base_module_t *module, struct ompi_op_t *op)
+{
+    ompi_op_mt_module_t *m = (ompi_op_mt_module_t *) module;
+
+    /* Like the other op components, keep one reference on the module
+       for each function it provides to the op. */
+    for (int i = 0; i < OMPI_OP_BASE_TYPE_MAX; ++i) {
+        if (NULL != op->o_func.intrinsic.fns[i]) {
+            m->fallback_fns[i] = op->o_func.intrinsic.fns[i];
+            m->fallback_modules[i] = op->o_func.intrinsic.modules[i];
+            OBJ_RETAIN(m->fallback_modules[i]);
+            m->super.opm_fns[i] = mt_2buff;
+            OBJ_RETAIN(module);
+        }
+        if (NULL != op->o_3buff_intrinsic.fns[i]) {
+            m->fallback_3buff_fns[i] = op->o_3buff_intrinsic.fns[i];
+            m->fallback_3buff_modules[i] = op->o_3buff_intrinsic.modules[i];
+            OBJ_RETAIN(m->fallback_3buff_modules[i]);
+            m->super.opm_3buff_fns[i] = mt_3buff;
+            OBJ_RETAIN(module);
+        }
+    }
+    return OMPI_SUCCESS;
+}
+
+ompi_op_base_module_t *ompi_op_mt_module_create(struct ompi_op_t *op)
+{
+    ompi_op_mt_module_t *module = OBJ_NEW(ompi_op_mt_module_t);
+
+    module->super.opm_enable = mt_module_enable;
+    module->super.opm_op = op;
+    return (ompi_op_base_module_t *) module;
+}
@@ -24,8 +24,8 @@ AC_DEFUN([MCA_ompi_pml_ob1_POST_CONFIG], [
 AC_DEFUN([MCA_ompi_pml_ob1_CONFIG],[
     OPAL_VAR_SCOPE_PUSH([pml_ob1_matching_engine])
     AC_ARG_WITH([pml-ob1-matching], [AS_HELP_STRING([--with-pml-ob1-matching=type],
-                                                    [Configure pml/ob1 to use an alternate matching engine. Only valid on x86_64 systems.
-                                                     Valid values are: none, default, arrays, fuzzy-byte, fuzzy-short, fuzzy-word, vector (default: none)])])
+                                                    [Configure pml/ob1 to use an alternate matching engine. Only valid on x86_64 systems, except hash.
+                                                     Valid values are: none, default, arrays, fuzzy-byte, fuzzy-short, fuzzy-word, vector, hash (default: none)])])
 
     pml_ob1_matching_engine=MCA_PML_OB1_CUSTOM_MATCHING_NONE
 
@@ -52,6 +52,9 @@ AC_DEFUN([MCA_ompi_pml_ob1_CONFIG],[
             vector)
                 pml_ob1_matching_engine=MCA_PML_OB1_CUSTOM_MATCHING_VECTOR
                 ;;
+            hash)
+                pml_ob1_matching_engine=MCA_PML_OB1_CUSTOM_MATCHING_HASH
+                ;;
             *)
                 AC_MSG_ERROR([invalid matching type specified for --pml-ob1-matching: $with_pml_ob1_matching])
                 ;;
@@ -17,8 +17,8 @@
 #include "ompi_config.h"
 #include "ompi/mca/pml/ob1/pml_ob1.h"
 
-#define CUSTOM_MATCH_DEBUG         1
-#define CUSTOM_MATCH_DEBUG_VERBOSE 1
+#define CUSTOM_MATCH_DEBUG         0
+#define CUSTOM_MATCH_DEBUG_VERBOSE 0
 
 /**
  * Custom match types
@@ -30,6 +30,7 @@
 #define MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_SHORT 4
 #define MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_WORD  5
 #define MCA_PML_OB1_CUSTOM_MATCHING_VECTOR      6
+#define MCA_PML_OB1_CUSTOM_MATCHING_HASH        7
 
 #if MCA_PML_OB1_CUSTOM_MATCHING != MCA_PML_OB1_CUSTOM_MATCHING_NONE
 
@@ -47,6 +48,8 @@
 #include "pml_ob1_custom_match_fuzzy512-word.h"
 #elif MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_VECTOR
 #include "pml_ob1_custom_match_vectors.h"
+#elif MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_HASH
+#include "pml_ob1_custom_match_hash.h"
 #endif
 
 #else
@@ -0,0 +1,634 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Matching engine binning the posted receives and the unexpected fragments
+ * by a hash of their (source, tag) pair, so that the matching cost does not
+ * depend on the length of the queues when the peers and the tags are
+ * diverse.
+ *
+ * Posted receives: the receives with a specific source and tag go in the
+ * bins, the receives with MPI_ANY_SOURCE or MPI_ANY_TAG in a separate
+ * wildcard list. Every receive gets a sequence number when posted, an
+ * incoming fragment is matched by the oldest of the first candidate of its
+ * bin and the first candidate of the wildcard list.
+ *
+ * Unexpected fragments: the fragments are in the bins and in a list in
+ * arrival order. The receives with a specific source and tag only look at
+ * their bin, the wildcard receives scan the arrival list.
+ *
+ * In both queues the elements with the same (source, tag) are in the same
+ * bin in their arrival order, which keeps the MPI ordering. The number of
+ * bins doubles when the queue grows beyond twice its number of bins.
+ */
+
+#ifndef PML_OB1_CUSTOM_MATCH_HASH_H
+#define PML_OB1_CUSTOM_MATCH_HASH_H
+
+#include "../pml_ob1_recvreq.h"
+#include "../pml_ob1_recvfrag.h"
+
+#define CUSTOM_MATCH_HASH_INITIAL_BINS 64
+
+static inline uint32_t custom_match_hash(int tag, int src, uint32_t mask)
+{
+    uint64_t key = ((uint64_t)(uint32_t) src << 32) | (uint32_t) tag;
+    return (uint32_t)((key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+}
+
+/* an MPI_ANY_TAG receive does not match the negative (internal) tags */
+static inline int custom_match_matches(int req_tag, int req_src, int tag, int src)
+{
+    return ((req_tag == tag) || ((req_tag == OMPI_ANY_TAG) && (tag >= 0))) &&
+        ((req_src == src) || (req_src == OMPI_ANY_SOURCE));
+}
+
+typedef struct custom_match_prq_node
+{
+    int tag;
+    int src;
+    uint64_t seq;
+    struct custom_match_prq_node* prev;
+    struct custom_match_prq_node* next;
+    void* value;
+} custom_match_prq_node;
+
+typedef struct custom_match_prq_list
+{
+    custom_match_prq_node* head;
+    custom_match_prq_node* tail;
+} custom_match_prq_list;
+
+typedef struct custom_match_prq
+{
+    custom_match_prq_list* bins;
+    uint32_t mask;
+    custom_match_prq_list wild;
+    custom_match_prq_node* pool;
+    uint64_t seq;
+    int size;
+} custom_match_prq;
+
+static inline void custom_match_prq_list_append(custom_match_prq_list* list, custom_match_prq_node* elem)
+{
+    elem->next = NULL;
+    elem->prev = list->tail;
+    if(list->tail)
+    {
+        list->tail->next = elem;
+    }
+    else
+    {
+        list->head = elem;
+    }
+    list->tail = elem;
+}
+
+static inline void custom_match_prq_list_remove(custom_match_prq_list* list, custom_match_prq_node* elem)
+{
+    if(elem->prev)
+    {
+        elem->prev->next = elem->next;
+    }
+    else
+    {
+        list->head = elem->next;
+    }
+    if(elem->next)
+    {
+        elem->next->prev = elem->prev;
+    }
+    else
+    {
+        list->tail = elem->prev;
+    }
+}
+
+static inline custom_match_prq_list* custom_match_prq_list_of(custom_match_prq* list, int tag, int src)
+{
+    if((OMPI_ANY_TAG == tag) || (OMPI_ANY_SOURCE == src))
+    {
+        return &list->wild;
+    }
+    return &list->bins[custom_match_hash(tag, src, list->mask)];
+}
+
+static inline void custom_match_prq_release(custom_match_prq* list, custom_match_prq_list* from,
+                                            custom_match_prq_node* elem)
+{
+    custom_match_prq_list_remove(from, elem);
+    elem->value = NULL;
+    elem->next = list->pool;
+    list->pool = elem;
+    list->size--;
+}
+
+static inline int custom_match_prq_cancel(custom_match_prq* list, void* req)
+{
+    mca_pml_base_request_t *base = (mca_pml_base_request_t *)req;
+    custom_match_prq_list* from = custom_match_prq_list_of(list, base->req_tag, base->req_peer);
+    custom_match_prq_node* elem;
+
+#if CUSTOM_MATCH_DEBUG_VERBOSE
+    printf("custom_match_prq_cancel - list: %p req: %p\n", (void *) list, req);
+#endif
+    for(elem = from->head; elem; elem = elem->next)
+    {
+        if(elem->value == req)
+        {
+            custom_match_prq_release(list, from, elem);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* find the oldest posted receive matching the fragment, and where it is */
+static inline custom_match_prq_node* custom_match_prq_find(custom_match_prq* list, int tag, int peer,
+                                                           custom_match_prq_list** from)
+{
+    custom_match_prq_list* bin = &list->bins[custom_match_hash(tag, peer, list->mask)];
+    custom_match_prq_node *elem, *wild = NULL;
+
+    for(elem = bin->head; elem; elem = elem->next)
+    {
+        if((elem->tag == tag) && (elem->src == peer))
+        {
+            break;
+        }
+    }
+    for(wild = list->wild.head; wild; wild = wild->next)
+    {
+        if((NULL != elem) && (wild->seq > elem->seq))
+        {
+            wild = NULL;  /* the remaining wildcard receives were posted later */
+            break;
+        }
+        if(custom_match_matches(wild->tag, wild->src, tag, peer))
+        {
+            break;
+        }
+    }
+    if(NULL != wild)
+    {
+        *from = &list->wild;
+        return wild;
+    }
+    *from = bin;
+    return elem;
+}
+
+static inline void* custom_match_prq_find_verify(custom_match_prq* list, int tag, int peer)
+{
+    custom_match_prq_list* from;
+    custom_match_prq_node* elem;
+
+#if CUSTOM_MATCH_DEBUG_VERBOSE
+    printf("custom_match_prq_find_verify list: %p tag: %x peer: %x\n", (void *) list, tag, peer);
+#endif
+    elem = custom_match_prq_find(list, tag, peer, &from);
+    return elem ? elem->value : NULL;
+}
+
+static inline void* custom_match_prq_find_dequeue_verify(custom_match_prq* list, int tag, int peer)
+{
+    custom_match_prq_list* from;
+    custom_match_prq_node* elem;
+    void* payload;
+
+#if CUSTOM_MATCH_DEBUG_VERBOSE
+    printf("custom_match_prq_find_dequeue_verify list: %p:%d tag: %x peer: %x\n", (void *) list, list->size, tag, peer);
+#endif
+    elem = custom_match_prq_find(list, tag, peer, &from);
+    if(NULL == elem)
+    {
+        return NULL;
+    }
+    payload = elem->value;
+    custom_match_prq_release(list, from, elem);
+    return payload;
+}
+
+/* double the number of bins, the order of the elements with the same key is kept */
+static inline void custom_match_prq_grow(custom_match_prq* list)
+{
+    uint32_t nbins = (list->mask + 1) * 2, i;
+    custom_match_prq_list* bins = calloc(nbins, sizeof(custom_match_prq_list));
+    custom_match_prq_node *elem, *next;
+
+    if(NULL == bins)
+    {
+        return;  /* keep the current bins, only the matching gets slower */
+    }
+    for(i = 0; i <= list->mask; i++)
+    {
+        for(elem = list->bins[i].head; elem; elem = next)
+        {
+            next = elem->next;
+            custom_match_prq_list_append(&bins[custom_match_hash(elem->tag, elem->src, nbins - 1)], elem);
+        }
+    }
+    free(list->bins);
+    list->bins = bins;
+    list->mask = nbins - 1;
+}
+
+static inline void custom_match_prq_append(custom_match_prq* list, void* payload, int tag, int source)
+{
+    custom_match_prq_node* elem;
+
+#if CUSTOM_MATCH_DEBUG_VERBOSE
+    printf("custom_match_prq_append list: %p tag: %x source: %x\n", (void *) list, tag, source);
+#endif
+    if(list->size >= (int) (2 * (list->mask + 1)))
+    {
+        custom_match_prq_grow(list);
+    }
+    if(list->pool)
+    {
+        elem = list->pool;
+        list->pool = elem->next;
+    }
+    else
+    {
+        elem = malloc(sizeof(custom_match_prq_node));
+    }
+    elem->tag = tag;
+    elem->src = source;
+    elem->seq = list->seq++;
+    elem->value = payload;
+    custom_match_prq_list_append(custom_match_prq_list_of(list, tag, source), elem);
+    list->size++;
+}
+
+static inline int custom_match_prq_size(custom_match_prq* list)
+{
+    return list->size;
+}
+
+static inline custom_match_prq* custom_match_prq_init()
+{
+    custom_match_prq* list = malloc(sizeof(custom_match_prq));
+
+#if CUSTOM_MATCH_DEBUG_VERBOSE
+    printf("custom_match_prq_init\n");
+#endif
+    list->bins = calloc(CUSTOM_MATCH_HASH_INITIAL_BINS, sizeof(custom_match_prq_list));
+    list->mask = CUSTOM_MATCH_HASH_INITIAL_BINS - 1;
+    list->wild.head = NULL;
+    list->wild.tail = NULL;
+    list->pool = NULL;
+    list->seq = 0;
+    list->size = 0;
+    return list;
+}
+
+static inline void custom_match_prq_free_nodes(custom_match_prq_node* elem)
+{
+    custom_match_prq_node* next;
+
+    for(; elem; elem = next)
+    {
+        next = elem->next;
+        free(elem);
+    }
+}
+
+static inline void custom_match_prq_destroy(custom_match_prq* list)
+{
+    uint32_t i;
+
+#if CUSTOM_MATCH_DEBUG_VERBOSE
+    printf("custom_match_prq_destroy\n");
+#endif
+    for(i = 0; i <= list->mask; i++)
+    {
+        custom_match_prq_free_nodes(list->bins[i].head);
+    }
+    custom_match_prq_free_nodes(list->wild.head);
+    custom_match_prq_free_nodes(list->pool);
+    free(list->bins);
+    free(list);
+}
+
+static inline void custom_match_prq_dump_node(custom_match_prq_node* elem)
+{
+    mca_pml_base_request_t *req = (mca_pml_base_request_t *)elem->value;
+    char cpeer[64], ctag[64];
+
+    if( OMPI_ANY_SOURCE == req->req_peer ) snprintf(cpeer, 64, "%s", "ANY_SOURCE");
+    else snprintf(cpeer, 64, "%d", req->req_peer);
+    if( OMPI_ANY_TAG == req->req_tag ) snprintf(ctag, 64, "%s", "ANY_TAG");
+    else snprintf(ctag, 64, "%d", req->req_tag);
+    opal_output(0, "req %p peer %s tag %s addr %p count %lu datatype %s [%p] [%s %s] req_seq %" PRIu64
+                " match_seq %" PRIu64,
+                (void*) req, cpeer, ctag,
+                (void*) req->req_addr, req->req_count,
+                (0 != req->req_count ? req->req_datatype->name : "N/A"),
+                (void*) req->req_datatype,
+                (req->req_pml_complete ? "pml_complete" : ""),
+                (req->req_free_called ? "freed" : ""),
+                req->req_sequence, elem->seq);
+}
+
+static inline void custom_match_print(custom_match_prq* list)
+{
+    custom_match_prq_node* elem;
+    uint32_t i;
+
+    printf("%d posted receives in %u bins\n", list->size, list->mask + 1);
+    for(i = 0; i <= list->mask; i++)
+    {
+        for(elem = list->bins[i].head; elem; elem = elem->next)
+        {
+            printf("bin %u tag %d source %d seq %" PRIu64 " value %p\n", i, elem->tag, elem->src,
+                   elem->seq, elem->value);
+        }
+    }
+    for(elem = list->wild.head; elem; elem = elem->next)
+    {
+        printf("wildcard tag %d source %d seq %" PRIu64 " value %p\n", elem->tag, elem->src,
+               elem->seq, elem->value);
+    }
+}
+
+static inline void custom_match_prq_dump(custom_match_prq* list)
+{
+    custom_match_prq_node* elem;
+    uint32_t i;
+
+    printf("Elements in the bins:\n");
+    for(i = 0; i <= list->mask; i++)
+    {
+        for(elem = list->bins[i].head; elem; elem = elem->next)
+        {
+            custom_match_prq_dump_node(elem);
+        }
+    }
+    printf("Elements in the wildcard list:\n");
+    for(elem = list->wild.head; elem; elem = elem->next)
+    {
+        custom_match_prq_dump_node(elem);
+    }
+}
+
+
+// UMQ below.
+
+typedef struct custom_match_umq_node
+{
+    int tag;
+    int src;
+    struct custom_match_umq_node* prev;  /* in the bin */
+    struct custom_match_umq_node* next;
+    struct custom_match_umq_node* older; /* in the arrival order */
+    struct custom_match_umq_node* newer;
+    void* value;
+} custom_match_umq_node;
+
+typedef struct custom_match_umq_list
+{
+    custom_match_umq_node* head;
+    custom_match_umq_node* tail;
+} custom_match_umq_list;
+
+typedef struct custom_match_umq
+{
+    custom_match_umq_list* bins;
+    uint32_t mask;
+    custom_match_umq_node* oldest;
+    custom_match_umq_node* newest;
+    custom_match_umq_node* pool;
+    int size;
+} custom_match_umq;
+
+static inline void custom_match_umq_dump(custom_match_umq* list);
+
+static inline void custom_match_umq_bin_append(custom_match_umq_list* bin, custom_match_umq_node* elem)
+{
+    elem->next = NULL;
+    elem->prev = bin->tail;
+    if(bin->tail)
+    {
+        bin->tail->next = elem;
+    }
+    else
+    {
+        bin->head = elem;
+    }
+    bin->tail = elem;
+}
+
+static inline void* custom_match_umq_find_verify_hold(custom_match_umq* list, int tag, int peer, custom_match_umq_node** hold_prev, custom_match_umq_node** hold_elem, int* hold_index)
+{
+    custom_match_umq_node* elem;
+
+#if CUSTOM_MATCH_DEBUG_VERBOSE
+    printf("custom_match_umq_find_verify_hold list: %p:%d tag: %x peer: %x\n", (void *) list, list->size, tag, peer);
+#endif
+    if((OMPI_ANY_TAG == tag) || (OMPI_ANY_SOURCE == peer))
+    {
+        for(elem = list->oldest; elem; elem = elem->newer)
+        {
+            if(custom_match_matches(tag, peer, elem->tag, elem->src))
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        for(elem = list->bins[custom_match_hash(tag, peer, list->mask)].head; elem; elem = elem->next)
+        {
+            if((elem->tag == tag) && (elem->src == peer))
+            {
+                break;
+            }
+        }
+    }
+    if(NULL == elem)
+    {
+        return NULL;
+    }
+    *hold_prev = elem->prev;
+    *hold_elem = elem;
+    *hold_index = 0;
+    return elem->value;
+}
+
+static inline void custom_match_umq_remove_hold(custom_match_umq* list, custom_match_umq_node* prev, custom_match_umq_node* elem, int i)
+{
+    custom_match_umq_list* bin = &list->bins[custom_match_hash(elem->tag, elem->src, list->mask)];
+
+    (void) prev;
+    (void) i;
+    if(elem->prev)
+    {
+        elem->prev->next = elem->next;
+    }
+    else
+    {
+        bin->head = elem->next;
+    }
+    if(elem->next)
+    {
+        elem->next->prev = elem->prev;
+    }
+    else
+    {
+        bin->tail = elem->prev;
+    }
+    if(elem->older)
+    {
+        elem->older->newer = elem->newer;
+    }
+    else
+    {
+        list->oldest = elem->newer;
+    }
+    if(elem->newer)
+    {
+        elem->newer->older = elem->older;
+    }
+    else
+    {
+        list->newest = elem->older;
+    }
+    elem->value = NULL;
+    elem->next = list->pool;
+    list->pool = elem;
+    list->size--;
+}
+
+/* double the number of bins, the arrival order gives the order in the new bins */
+static inline void custom_match_umq_grow(custom_match_umq* list)
+{
+    uint32_t nbins = (list->mask + 1) * 2;
+    custom_match_umq_list* bins = calloc(nbins, sizeof(custom_match_umq_list));
+    custom_match_umq_node* elem;
+
+    if(NULL == bins)
+    {
+        return;
+    }
+    for(elem = list->oldest; elem; elem = elem->newer)
+    {
+        custom_match_umq_bin_append(&bins[custom_match_hash(elem->tag, elem->src, nbins - 1)], elem);
+    }
+    free(list->bins);
+    list->bins = bins;
+    list->mask = nbins - 1;
+}
+
+static inline void custom_match_umq_append(custom_match_umq* list, int tag, int source, void* payload)
+{
+    custom_match_umq_node* elem;
+
+#if CUSTOM_MATCH_DEBUG_VERBOSE
+    printf("custom_match_umq_append list: %p payload: %p tag: %d src: %d\n", (void *) list, payload, tag, source);
+#endif
+    if(list->size >= (int) (2 * (list->mask + 1)))
+    {
+        custom_match_umq_grow(list);
+    }
+    if(list->pool)
+    {
+        elem = list->pool;
+        list->pool = elem->next;
+    }
+    else
+    {
+        elem = malloc(sizeof(custom_match_umq_node));
+    }
+    elem->tag = tag;
+    elem->src = source;
+    elem->value = payload;
+    custom_match_umq_bin_append(&list->bins[custom_match_hash(tag, source, list->mask)], elem);
+    elem->newer = NULL;
+    elem->older = list->newest;
+    if(list->newest)
+    {
+        list->newest->newer = elem;
+    }
+    else
+    {
+        list->oldest = elem;
+    }
+    list->newest = elem;
+    list->size++;
+}
+
+/* the unexpected fragments in arrival order, starting with elem NULL */
+static inline custom_match_umq_node* custom_match_umq_iter(custom_match_umq* list, custom_match_umq_node* elem)
+{
+    return (NULL == elem) ? list->oldest : elem->newer;
+}
+
+static inline custom_match_umq* custom_match_umq_init()
+{
+    custom_match_umq* list = malloc(sizeof(custom_match_umq));
+
+#if CUSTOM_MATCH_DEBUG_VERBOSE
+    printf("custom_match_umq_init\n");
+#endif
+    list->bins = calloc(CUSTOM_MATCH_HASH_INITIAL_BINS, sizeof(custom_match_umq_list));
+    list->mask = CUSTOM_MATCH_HASH_INITIAL_BINS - 1;
+    list->oldest = NULL;
+    list->newest = NULL;
+    list->pool = NULL;
+    list->size = 0;
+    return list;
+}
+
+static inline void custom_match_umq_destroy(custom_match_umq* list)
+{
+    custom_match_umq_node *elem, *next;
+
+#if CUSTOM_MATCH_DEBUG_VERBOSE
+    printf("custom_match_umq_destroy\n");
+#endif
+    for(elem = list->oldest; elem; elem = next)
+    {
+        next = elem->newer;
+        free(elem);
+    }
+    for(elem = list->pool; elem; elem = next)
+    {
+        next = elem->next;
+        free(elem);
+    }
+    free(list->bins);
+    free(list);
+}
+
+static inline int custom_match_umq_size(custom_match_umq* list)
+{
+    return list->size;
+}
+
+static inline void custom_match_umq_dump(custom_match_umq* list)
+{
+    custom_match_umq_node* elem;
+    int i = 0;
+
+    printf("Elements in the list (arrival order):\n");
+    for(elem = list->oldest; elem; elem = elem->newer)
+    {
+        mca_pml_ob1_recv_frag_t *frag = (mca_pml_ob1_recv_frag_t *)elem->value;
+        printf("%d frag %p tag %d src %d bin %u\n", i++, (void *) frag,
+               frag->hdr.hdr_match.hdr_tag, frag->hdr.hdr_match.hdr_src,
+               custom_match_hash(elem->tag, elem->src, list->mask));
+    }
+}
+
+#endif
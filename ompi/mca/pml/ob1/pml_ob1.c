@@ -52,6 +52,8 @@
 #include "pml_ob1.h"
 #include "pml_ob1_component.h"
 #include "pml_ob1_comm.h"
+#include "pml_ob1_coalesce.h"
+#include "pml_ob1_flow_control.h"
 #include "pml_ob1_hdr.h"
 #include "pml_ob1_recvfrag.h"
 #include "pml_ob1_sendreq.h"
@@ -165,6 +167,13 @@ int mca_pml_ob1_enable(bool enable)
     /* missing communicator pending list */
     OBJ_CONSTRUCT(&mca_pml_ob1.non_existing_communicator_pending, opal_list_t);
 
+    /* coalescing of the small messages */
+    OBJ_CONSTRUCT(&mca_pml_ob1.coalesce_pending, opal_list_t);
+    OBJ_CONSTRUCT(&mca_pml_ob1.coalesce_retry, opal_list_t);
+    if (mca_pml_ob1.coalesce) {
+        opal_progress_register (mca_pml_ob1_coalesce_progress);
+    }
+
     /**
      * If we get here this is the PML who get selected for the run. We
      * should get ownership for the send and receive requests list, and
@@ -257,6 +266,7 @@ int mca_pml_ob1_add_comm(ompi_communicator_t* comm)
 #else
             custom_match_umq_append(pml_comm->umq, hdr->hdr_tag, hdr->hdr_src, frag);
 #endif
+            pml_proc->unexpected_bytes += frag->segments[0].seg_len;
             PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_MSG_INSERT_IN_UNEX_Q, comm,
                                    hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
             continue;
@@ -272,6 +282,7 @@ int mca_pml_ob1_add_comm(ompi_communicator_t* comm)
 #else
             custom_match_umq_append(pml_comm->umq, hdr->hdr_tag, hdr->hdr_src, frag);
 #endif
+            pml_proc->unexpected_bytes += frag->segments[0].seg_len;
             PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_MSG_INSERT_IN_UNEX_Q, comm,
                                    hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
             /* And now the ugly part. As some fragments can be inserted in the cant_match list,
@@ -297,6 +308,17 @@ int mca_pml_ob1_add_comm(ompi_communicator_t* comm)
 
 int mca_pml_ob1_del_comm(ompi_communicator_t* comm)
 {
+    mca_pml_ob1_comm_t* pml_comm = (mca_pml_ob1_comm_t*) comm->c_pml_comm;
+
+    /* the coalesced messages carry the context id, send them while it is valid */
+    if (mca_pml_ob1.coalesce) {
+        for (size_t i = 0 ; i < pml_comm->num_procs ; ++i) {
+            if (NULL != pml_comm->procs[i]) {
+                mca_pml_ob1_coalesce_flush_peer (pml_comm->procs[i]);
+            }
+        }
+    }
+
     OBJ_RELEASE(comm->c_pml_comm);
     comm->c_pml_comm = NULL;
     return OMPI_SUCCESS;
@@ -449,6 +471,18 @@ int mca_pml_ob1_add_procs(ompi_proc_t** procs, size_t nprocs)
     if(OMPI_SUCCESS != rc)
         goto cleanup_and_return;
 
+    rc = mca_bml.bml_register( MCA_PML_OB1_HDR_TYPE_COALESCED,
+                               mca_pml_ob1_recv_frag_callback_coalesced,
+                               NULL );
+    if(OMPI_SUCCESS != rc)
+        goto cleanup_and_return;
+
+    rc = mca_bml.bml_register( MCA_PML_OB1_HDR_TYPE_CREDIT,
+                               mca_pml_ob1_recv_frag_callback_credit,
+                               NULL );
+    if(OMPI_SUCCESS != rc)
+        goto cleanup_and_return;
+
     /* register error handlers */
     rc = mca_bml.bml_register_error(mca_pml_ob1_error_handler);
     if(OMPI_SUCCESS != rc)
@@ -467,6 +501,11 @@ int mca_pml_ob1_add_procs(ompi_proc_t** procs, size_t nprocs)
 
 int mca_pml_ob1_del_procs(ompi_proc_t** procs, size_t nprocs)
 {
+    /* the coalesced fragments must leave before their endpoints go away */
+    if (mca_pml_ob1.coalesce) {
+        mca_pml_ob1_coalesce_fini ();
+    }
+
     return mca_bml.bml_del_procs(nprocs, procs);
 }
 
@@ -769,6 +808,19 @@ void mca_pml_ob1_process_pending_packets(mca_bml_base_btl_t* bml_btl)
                     return;
                 }
                 break;
+            case MCA_PML_OB1_HDR_TYPE_CREDIT:
+                rc = mca_pml_ob1_send_credits_btl(pckt->proc, send_dst,
+                                                  pckt->hdr.hdr_credit.hdr_ctx,
+                                                  pckt->hdr.hdr_credit.hdr_src,
+                                                  pckt->hdr.hdr_credit.hdr_credits);
+                if( OPAL_UNLIKELY(OMPI_ERR_OUT_OF_RESOURCE == rc) ) {
+                    OPAL_THREAD_LOCK(&mca_pml_ob1.lock);
+                    opal_list_append(&mca_pml_ob1.pckt_pending,
+                                     (opal_list_item_t*)pckt);
+                    OPAL_THREAD_UNLOCK(&mca_pml_ob1.lock);
+                    return;
+                }
+                break;
             default:
                 opal_output(0, "[%s:%d] wrong header type\n",
                             __FILE__, __LINE__);
@@ -60,6 +60,15 @@ struct mca_pml_ob1_t {
     size_t rdma_retries_limit;
     int max_rdma_per_request;
     int max_send_per_range;
+    int matching_shards;    /* number of peer shards with their own matching lock */
+    bool adaptive_eager;    /* learn the eager limit of each peer from its rendezvous */
+    double adaptive_eager_scale;
+    bool coalesce;          /* pack the small eager messages to a peer into a single fragment */
+    size_t coalesce_max_msg;
+    size_t coalesce_size;
+    unsigned int coalesce_delay;
+    bool flow_control;      /* bound the eager bytes in flight to each peer with credits */
+    unsigned int flow_control_credits;
     bool use_all_rdma;
 
     /* lock queue access */
@@ -79,6 +88,9 @@ struct mca_pml_ob1_t {
     opal_list_t rdma_pending;
     /* List of pending fragments without a matching communicator */
     opal_list_t non_existing_communicator_pending;
+    /* coalescing batches with an open fragment, and fragments to resend */
+    opal_list_t coalesce_pending;
+    opal_list_t coalesce_retry;
     bool enabled;
     char* allocator_name;
     mca_allocator_base_module_t* allocator;
@@ -287,9 +299,9 @@ do {                                                            \
 int mca_pml_ob1_send_fin(ompi_proc_t* proc, mca_bml_base_btl_t* bml_btl,
         opal_ptr_t hdr_frag, uint64_t size, uint8_t order, int status);
 
-/* This function tries to resend FIN/ACK packets from pckt_pending queue.
- * Packets are added to the queue when sending of FIN or ACK is failed due to
- * resource unavailability. bml_btl passed to the function doesn't represents
+/* This function tries to resend FIN/ACK/CREDIT packets from pckt_pending queue.
+ * Packets are added to the queue when sending of FIN, ACK or CREDIT is failed
+ * due to resource unavailability. bml_btl passed to the function doesn't represents
  * packet's destination, it represents BTL on which resource was freed, so only
  * this BTL should be considered for resending packets */
 void mca_pml_ob1_process_pending_packets(mca_bml_base_btl_t* bml_btl);
@@ -0,0 +1,344 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/runtime/opal_progress.h"
+#include "ompi/runtime/ompi_spc.h"
+#include "pml_ob1.h"
+#include "pml_ob1_coalesce.h"
+#include "pml_ob1_flow_control.h"
+#include "pml_ob1_hdr.h"
+#include "pml_ob1_recvreq.h"
+#include "pml_ob1_sendreq.h"
+
+static void mca_pml_ob1_coalesce_construct (mca_pml_ob1_coalesce_t *batch)
+{
+    batch->proc = NULL;
+    batch->bml_btl = NULL;
+    batch->des = NULL;
+    batch->limit = 0;
+    batch->count = 0;
+    batch->start = 0;
+    OBJ_CONSTRUCT(&batch->lock, opal_mutex_t);
+}
+
+static void mca_pml_ob1_coalesce_destruct (mca_pml_ob1_coalesce_t *batch)
+{
+    OBJ_DESTRUCT(&batch->lock);
+}
+
+OBJ_CLASS_INSTANCE(mca_pml_ob1_coalesce_t, opal_list_item_t,
+                   mca_pml_ob1_coalesce_construct, mca_pml_ob1_coalesce_destruct);
+
+static void mca_pml_ob1_coalesce_completion (mca_btl_base_module_t* btl,
+                                             struct mca_btl_base_endpoint_t* ep,
+                                             struct mca_btl_base_descriptor_t* des,
+                                             int status)
+{
+    mca_bml_base_btl_t* bml_btl = (mca_bml_base_btl_t*) des->des_context;
+
+    /* check for pending requests */
+    MCA_PML_OB1_PROGRESS_PENDING(bml_btl);
+}
+
+static int mca_pml_ob1_coalesce_send_des (mca_bml_base_btl_t *bml_btl, mca_btl_base_descriptor_t *des)
+{
+    int rc = mca_bml_base_send (bml_btl, des, MCA_PML_OB1_HDR_TYPE_COALESCED);
+
+    if (OPAL_UNLIKELY(rc < 0)) {
+        /* the messages are already complete for the sender, the fragment is
+         * retried by the progress engine */
+        OPAL_THREAD_LOCK(&mca_pml_ob1.lock);
+        opal_list_append (&mca_pml_ob1.coalesce_retry, (opal_list_item_t *) des);
+        OPAL_THREAD_UNLOCK(&mca_pml_ob1.lock);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    if (OPAL_LIKELY(1 == rc)) {
+        MCA_PML_OB1_PROGRESS_PENDING(bml_btl);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+/* close the open fragment of the batch and return it. the fragment is sent
+ * by the caller once it released mca_pml_ob1.lock, as the btl may call back
+ * into the pml. */
+static mca_btl_base_descriptor_t *mca_pml_ob1_coalesce_close (mca_pml_ob1_coalesce_t *batch)
+{
+    mca_btl_base_descriptor_t *des = batch->des;
+    mca_pml_ob1_coalesced_hdr_t *hdr = (mca_pml_ob1_coalesced_hdr_t *) des->des_segments->seg_addr.pval;
+
+    mca_pml_ob1_coalesced_hdr_prepare (hdr, 0, batch->count);
+    ob1_hdr_hton (hdr, MCA_PML_OB1_HDR_TYPE_COALESCED, batch->proc);
+
+    opal_list_remove_item (&mca_pml_ob1.coalesce_pending, &batch->super);
+    batch->des = NULL;
+    batch->count = 0;
+
+    return des;
+}
+
+/* close the open fragment of the batch, if any, and send it. the caller
+ * holds the lock of the batch. */
+static int mca_pml_ob1_coalesce_flush_locked (mca_pml_ob1_coalesce_t *batch)
+{
+    mca_btl_base_descriptor_t *des = NULL;
+    mca_bml_base_btl_t *bml_btl;
+
+    OPAL_THREAD_LOCK(&mca_pml_ob1.lock);
+    if (NULL != batch->des) {
+        des = mca_pml_ob1_coalesce_close (batch);
+    }
+    bml_btl = batch->bml_btl;
+    OPAL_THREAD_UNLOCK(&mca_pml_ob1.lock);
+
+    if (NULL == des) {
+        return OMPI_SUCCESS;
+    }
+
+    return mca_pml_ob1_coalesce_send_des (bml_btl, des);
+}
+
+int mca_pml_ob1_coalesce_send (const void *buf, size_t count, ompi_datatype_t *datatype,
+                               int tag, uint16_t seqn, mca_pml_base_send_mode_t sendmode,
+                               mca_pml_ob1_comm_proc_t *ob1_proc, mca_bml_base_endpoint_t *endpoint,
+                               ompi_communicator_t *comm)
+{
+    mca_btl_base_descriptor_t *full = NULL, *des;
+    mca_bml_base_btl_t *full_btl = NULL, *bml_btl;
+    mca_pml_ob1_coalesce_t *batch;
+    mca_pml_ob1_coalesced_entry_t *entry;
+    opal_convertor_t convertor;
+    size_t size, length;
+    opal_timer_t now;
+    int rc = OMPI_SUCCESS;
+
+    ompi_datatype_type_size (datatype, &size);
+    if (MCA_PML_BASE_SEND_SYNCHRONOUS == sendmode || (size * count) > mca_pml_ob1.coalesce_max_msg) {
+        /* keep the messages to the peer in sequence */
+        mca_pml_ob1_coalesce_flush_peer (ob1_proc);
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
+    if (count > 0) {
+        /* initialize just enough of the convertor to avoid a SEGV in opal_convertor_cleanup */
+        OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+        opal_convertor_copy_and_prepare_for_send (ob1_proc->ompi_proc->super.proc_convertor,
+                                                  (const struct opal_datatype_t *) datatype,
+                                                  count, buf, 0, &convertor);
+        opal_convertor_get_packed_size (&convertor, &size);
+    } else {
+        size = 0;
+    }
+
+    length = OMPI_PML_OB1_MATCH_HDR_LEN + size;
+
+    if (OPAL_UNLIKELY(mca_pml_ob1.flow_control) && !mca_pml_ob1_flow_control_acquire (ob1_proc, size)) {
+        if (count > 0) {
+            opal_convertor_cleanup (&convertor);
+        }
+        mca_pml_ob1_coalesce_flush_peer (ob1_proc);
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
+    batch = ob1_proc->coalesce;
+    if (OPAL_UNLIKELY(NULL == batch)) {
+        OPAL_THREAD_LOCK(&mca_pml_ob1.lock);
+        batch = ob1_proc->coalesce;
+        if (NULL == batch) {
+            batch = OBJ_NEW(mca_pml_ob1_coalesce_t);
+            batch->proc = ob1_proc->ompi_proc;
+            opal_atomic_wmb ();
+            ob1_proc->coalesce = batch;
+        }
+        OPAL_THREAD_UNLOCK(&mca_pml_ob1.lock);
+    }
+
+    /* the lock of the batch is held until the fragments are handed to the
+     * btl, so the fragments to the peer leave in the order they were
+     * filled whatever the number of sending threads */
+    OPAL_THREAD_LOCK(&batch->lock);
+    OPAL_THREAD_LOCK(&mca_pml_ob1.lock);
+
+    if (NULL != batch->des &&
+        batch->des->des_segments->seg_len + MCA_PML_OB1_COALESCED_ENTRY_LEN(length) > batch->limit) {
+        full_btl = batch->bml_btl;
+        full = mca_pml_ob1_coalesce_close (batch);
+    }
+
+    if (NULL == batch->des) {
+        bml_btl = mca_bml_base_btl_array_get_next (&endpoint->btl_eager);
+        batch->limit = bml_btl->btl->btl_eager_limit;
+        if (batch->limit > mca_pml_ob1.coalesce_size) {
+            batch->limit = mca_pml_ob1.coalesce_size;
+        }
+
+        des = NULL;
+        if (sizeof (mca_pml_ob1_coalesced_hdr_t) + MCA_PML_OB1_COALESCED_ENTRY_LEN(length) <= batch->limit) {
+            mca_bml_base_alloc (bml_btl, &des, MCA_BTL_NO_ORDER, batch->limit,
+                                MCA_BTL_DES_FLAGS_PRIORITY | MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
+        }
+        if (OPAL_UNLIKELY(NULL == des)) {
+            if (mca_pml_ob1.flow_control) {
+                mca_pml_ob1_flow_control_release (ob1_proc, size);
+            }
+            rc = OMPI_ERR_NOT_AVAILABLE;
+            goto unlock;
+        }
+
+        des->des_cbfunc = mca_pml_ob1_coalesce_completion;
+        des->des_cbdata = NULL;
+        des->des_segments->seg_len = sizeof (mca_pml_ob1_coalesced_hdr_t);
+
+        batch->bml_btl = bml_btl;
+        batch->des = des;
+        batch->start = opal_timer_base_get_usec ();
+        opal_list_append (&mca_pml_ob1.coalesce_pending, &batch->super);
+    }
+
+    des = batch->des;
+    entry = (mca_pml_ob1_coalesced_entry_t *) ((unsigned char *) des->des_segments->seg_addr.pval +
+                                               des->des_segments->seg_len);
+
+    if (size > 0) {
+        struct iovec iov = {.iov_base = (IOVBASE_TYPE *) ((unsigned char *) &entry->hdr_match +
+                                                          OMPI_PML_OB1_MATCH_HDR_LEN),
+                            .iov_len = size};
+        uint32_t iov_count = 1;
+
+        (void) opal_convertor_pack (&convertor, &iov, &iov_count, &size);
+    }
+
+    mca_pml_ob1_match_hdr_prepare (&entry->hdr_match, MCA_PML_OB1_HDR_TYPE_MATCH, 0,
+                                   comm->c_contextid, comm->c_my_rank, tag, seqn);
+    ob1_hdr_hton (&entry->hdr_match, MCA_PML_OB1_HDR_TYPE_MATCH, ob1_proc->ompi_proc);
+    entry->hdr_length = (uint32_t) length;
+    MCA_PML_OB1_COALESCED_ENTRY_HTON(*entry);
+
+    des->des_segments->seg_len += MCA_PML_OB1_COALESCED_ENTRY_LEN(length);
+    ++batch->count;
+
+    SPC_USER_OR_MPI(tag, (ompi_spc_value_t)size, OMPI_SPC_BYTES_SENT_USER, OMPI_SPC_BYTES_SENT_MPI);
+
+    /* send the fragment if it can not hold another message, or if the
+     * first message waited long enough */
+    now = opal_timer_base_get_usec ();
+    if (des->des_segments->seg_len + MCA_PML_OB1_COALESCED_ENTRY_LEN(OMPI_PML_OB1_MATCH_HDR_LEN) > batch->limit ||
+        UINT16_MAX == batch->count || (now - batch->start) >= mca_pml_ob1.coalesce_delay) {
+        des = mca_pml_ob1_coalesce_close (batch);
+    } else {
+        des = NULL;
+    }
+
+ unlock:
+    bml_btl = batch->bml_btl;
+    OPAL_THREAD_UNLOCK(&mca_pml_ob1.lock);
+
+    if (count > 0) {
+        opal_convertor_cleanup (&convertor);
+    }
+
+    if (NULL != full) {
+        (void) mca_pml_ob1_coalesce_send_des (full_btl, full);
+    }
+    if (OMPI_SUCCESS == rc && NULL != des) {
+        (void) mca_pml_ob1_coalesce_send_des (bml_btl, des);
+    }
+    OPAL_THREAD_UNLOCK(&batch->lock);
+
+    return rc;
+}
+
+int mca_pml_ob1_coalesce_flush (mca_pml_ob1_comm_proc_t *ob1_proc)
+{
+    mca_pml_ob1_coalesce_t *batch = ob1_proc->coalesce;
+    int rc;
+
+    if (NULL == batch) {
+        return OMPI_SUCCESS;
+    }
+
+    OPAL_THREAD_LOCK(&batch->lock);
+    rc = mca_pml_ob1_coalesce_flush_locked (batch);
+    OPAL_THREAD_UNLOCK(&batch->lock);
+
+    return rc;
+}
+
+int mca_pml_ob1_coalesce_progress (void)
+{
+    mca_btl_base_descriptor_t *des;
+    mca_pml_ob1_coalesce_t *batch;
+    int count = 0;
+
+    if (0 == opal_list_get_size (&mca_pml_ob1.coalesce_retry) &&
+        0 == opal_list_get_size (&mca_pml_ob1.coalesce_pending)) {
+        return 0;
+    }
+
+    /* the fragments that could not be sent first, then the open ones. each
+     * fragment is sent without the lock held, and at most once per call as
+     * a failed send puts it back on the retry list. */
+    for (size_t i = opal_list_get_size (&mca_pml_ob1.coalesce_retry) ; i > 0 ; --i) {
+        OPAL_THREAD_LOCK(&mca_pml_ob1.lock);
+        des = (mca_btl_base_descriptor_t *) opal_list_remove_first (&mca_pml_ob1.coalesce_retry);
+        OPAL_THREAD_UNLOCK(&mca_pml_ob1.lock);
+        if (NULL == des) {
+            break;
+        }
+        if (OMPI_SUCCESS != mca_pml_ob1_coalesce_send_des ((mca_bml_base_btl_t *) des->des_context, des)) {
+            return count;
+        }
+        ++count;
+    }
+
+    for (size_t i = opal_list_get_size (&mca_pml_ob1.coalesce_pending) ; i > 0 ; --i) {
+        int rc;
+
+        /* the lock of the batch is taken before mca_pml_ob1.lock, keep a
+         * reference on the batch while none of them is held */
+        OPAL_THREAD_LOCK(&mca_pml_ob1.lock);
+        batch = (mca_pml_ob1_coalesce_t *) opal_list_get_first (&mca_pml_ob1.coalesce_pending);
+        if (opal_list_get_end (&mca_pml_ob1.coalesce_pending) == &batch->super) {
+            OPAL_THREAD_UNLOCK(&mca_pml_ob1.lock);
+            break;
+        }
+        OBJ_RETAIN(batch);
+        OPAL_THREAD_UNLOCK(&mca_pml_ob1.lock);
+
+        OPAL_THREAD_LOCK(&batch->lock);
+        rc = mca_pml_ob1_coalesce_flush_locked (batch);
+        OPAL_THREAD_UNLOCK(&batch->lock);
+        OBJ_RELEASE(batch);
+
+        if (OMPI_SUCCESS != rc) {
+            break;
+        }
+        ++count;
+    }
+
+    return count;
+}
+
+void mca_pml_ob1_coalesce_fini (void)
+{
+    /* the messages of these fragments are already complete for the sender,
+     * deliver them while the endpoints are still around */
+    while (0 != opal_list_get_size (&mca_pml_ob1.coalesce_pending) ||
+           0 != opal_list_get_size (&mca_pml_ob1.coalesce_retry)) {
+        (void) mca_pml_ob1_coalesce_progress ();
+        opal_progress ();
+    }
+}
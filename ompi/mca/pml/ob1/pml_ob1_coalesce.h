@@ -0,0 +1,90 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ *  @file
+ *
+ *  Coalescing of the small eager messages to the same peer. The messages
+ *  are packed, match header and payload, into a fragment held open for
+ *  the peer and completed at once. The fragment is sent when it is full,
+ *  when it becomes older than the coalescing delay, when the progress
+ *  engine runs, and before any send to the peer that is not coalesced,
+ *  so the messages mostly reach the peer in sequence. The fragments to a
+ *  peer are filled and handed to the btl under the lock of the peer, so
+ *  this also holds with several sending threads; only a fragment the btl
+ *  refused can be overtaken, the matching then puts it back in order.
+ */
+
+#ifndef MCA_PML_OB1_COALESCE_H
+#define MCA_PML_OB1_COALESCE_H
+
+#include "ompi/mca/bml/bml.h"
+#include "opal/mca/timer/base/base.h"
+#include "pml_ob1.h"
+#include "pml_ob1_comm.h"
+
+BEGIN_C_DECLS
+
+struct mca_pml_ob1_coalesce_t {
+    opal_list_item_t super;               /**< in mca_pml_ob1.coalesce_pending while open */
+    ompi_proc_t *proc;                    /**< destination */
+    mca_bml_base_btl_t *bml_btl;          /**< btl the fragment was allocated on */
+    mca_btl_base_descriptor_t *des;       /**< open fragment (NULL if none) */
+    size_t limit;                         /**< capacity of the fragment */
+    uint16_t count;                       /**< number of messages packed */
+    opal_timer_t start;                   /**< time the first message was packed */
+    opal_mutex_t lock;                    /**< serializes the sends to the peer */
+};
+typedef struct mca_pml_ob1_coalesce_t mca_pml_ob1_coalesce_t;
+
+OBJ_CLASS_DECLARATION(mca_pml_ob1_coalesce_t);
+
+/**
+ * Pack an eager message into the fragment open for the peer.
+ *
+ * @returns OMPI_SUCCESS if the message was packed, it is then complete
+ *          from the sender point of view. Any other value if the message
+ *          can not be coalesced, the fragment of the peer is then flushed
+ *          and the message should take the usual path.
+ */
+int mca_pml_ob1_coalesce_send (const void *buf, size_t count, ompi_datatype_t *datatype,
+                               int tag, uint16_t seqn, mca_pml_base_send_mode_t sendmode,
+                               mca_pml_ob1_comm_proc_t *ob1_proc, mca_bml_base_endpoint_t *endpoint,
+                               ompi_communicator_t *comm);
+
+/**
+ * Send the fragment open for the peer, if any.
+ */
+int mca_pml_ob1_coalesce_flush (mca_pml_ob1_comm_proc_t *ob1_proc);
+
+/**
+ * Send all the open fragments. Registered with the progress engine when
+ * coalescing is enabled.
+ */
+int mca_pml_ob1_coalesce_progress (void);
+
+/**
+ * Send the fragments still open or waiting to be sent again, and progress
+ * until the btls accepted all of them. Called before the endpoints are
+ * released.
+ */
+void mca_pml_ob1_coalesce_fini (void);
+
+static inline void mca_pml_ob1_coalesce_flush_peer (mca_pml_ob1_comm_proc_t *ob1_proc)
+{
+    if (OPAL_UNLIKELY(NULL != ob1_proc->coalesce && NULL != ob1_proc->coalesce->des)) {
+        (void) mca_pml_ob1_coalesce_flush (ob1_proc);
+    }
+}
+
+END_C_DECLS
+
+#endif  /* MCA_PML_OB1_COALESCE_H */
@@ -24,6 +24,7 @@
 
 #include "pml_ob1.h"
 #include "pml_ob1_comm.h"
+#include "pml_ob1_coalesce.h"
 
 
 
@@ -32,7 +33,15 @@ static void mca_pml_ob1_comm_proc_construct(mca_pml_ob1_comm_proc_t* proc)
     proc->ompi_proc = NULL;
     proc->expected_sequence = 1;
     proc->send_sequence = 0;
+    proc->matching_lock = NULL;
     proc->frags_cant_match = NULL;
+    proc->eager_limit = 0;
+    proc->rndv_latency = 0.0;
+    proc->rndv_bandwidth = 0.0;
+    proc->coalesce = NULL;
+    proc->send_credits = (int32_t) mca_pml_ob1.flow_control_credits;
+    proc->matched_credits = 0;
+    proc->unexpected_bytes = 0;
 #if !MCA_PML_OB1_CUSTOM_MATCH
     OBJ_CONSTRUCT(&proc->specific_receives, opal_list_t);
     OBJ_CONSTRUCT(&proc->unexpected_frags, opal_list_t);
@@ -47,6 +56,11 @@ static void mca_pml_ob1_comm_proc_destruct(mca_pml_ob1_comm_proc_t* proc)
     OBJ_DESTRUCT(&proc->specific_receives);
     OBJ_DESTRUCT(&proc->unexpected_frags);
 #endif
+    if (proc->coalesce) {
+        /* flushed when the communicator was deleted */
+        assert(NULL == proc->coalesce->des);
+        OBJ_RELEASE(proc->coalesce);
+    }
     if (proc->ompi_proc) {
         OBJ_RELEASE(proc->ompi_proc);
     }
@@ -69,6 +83,8 @@ static void mca_pml_ob1_comm_construct(mca_pml_ob1_comm_t* comm)
     OBJ_CONSTRUCT(&comm->matching_lock, opal_mutex_t);
     OBJ_CONSTRUCT(&comm->proc_lock, opal_mutex_t);
     comm->recv_sequence = 0;
+    comm->shard_locks = NULL;
+    comm->shard_mask = 0;
     comm->procs = NULL;
     comm->last_probed = 0;
     comm->num_procs = 0;
@@ -87,6 +103,13 @@ static void mca_pml_ob1_comm_destruct(mca_pml_ob1_comm_t* comm)
         free(comm->procs);
     }
 
+    if (NULL != comm->shard_locks) {
+        for (uint32_t i = 0; i <= comm->shard_mask; ++i) {
+            OBJ_DESTRUCT(comm->shard_locks + i);
+        }
+        free(comm->shard_locks);
+    }
+
 #if !MCA_PML_OB1_CUSTOM_MATCH
     OBJ_DESTRUCT(&comm->wild_receives);
 #else
@@ -113,7 +136,53 @@ int mca_pml_ob1_comm_init_size (mca_pml_ob1_comm_t* comm, size_t size)
         return OMPI_ERR_OUT_OF_RESOURCE;
     }
     comm->num_procs = size;
+
+#if !MCA_PML_OB1_CUSTOM_MATCH
+    /* the custom matching engines keep the queues of all the peers in the same
+     * structures, so they always serialize the matching on the communicator */
+    if ((opal_using_threads() || mca_pml_ob1_matching_protection) &&
+        mca_pml_ob1.matching_shards > 1 && size > 1) {
+        uint32_t nshards = 1;
+
+        while (nshards < (uint32_t) mca_pml_ob1.matching_shards && nshards < size) {
+            nshards <<= 1;
+        }
+        comm->shard_locks = (opal_mutex_t *) malloc(nshards * sizeof(opal_mutex_t));
+        if (NULL == comm->shard_locks) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        for (uint32_t i = 0; i < nshards; ++i) {
+            OBJ_CONSTRUCT(comm->shard_locks + i, opal_mutex_t);
+        }
+        comm->shard_mask = nshards - 1;
+    }
+#endif
+
     return OMPI_SUCCESS;
 }
 
+void mca_pml_ob1_comm_lock_all (mca_pml_ob1_comm_t* comm)
+{
+    if (NULL == comm->shard_locks) {
+        OB1_MATCHING_LOCK(&comm->matching_lock);
+        return;
+    }
+
+    for (uint32_t i = 0; i <= comm->shard_mask; ++i) {
+        OB1_MATCHING_LOCK(comm->shard_locks + i);
+    }
+}
+
+void mca_pml_ob1_comm_unlock_all (mca_pml_ob1_comm_t* comm)
+{
+    if (NULL == comm->shard_locks) {
+        OB1_MATCHING_UNLOCK(&comm->matching_lock);
+        return;
+    }
+
+    for (uint32_t i = comm->shard_mask + 1; i > 0; --i) {
+        OB1_MATCHING_UNLOCK(comm->shard_locks + i - 1);
+    }
+}
+
 
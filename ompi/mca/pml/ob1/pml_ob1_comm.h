@@ -45,7 +45,15 @@ struct mca_pml_ob1_comm_proc_t {
     struct ompi_proc_t* ompi_proc;
     uint16_t expected_sequence;    /**< send message sequence number - receiver side */
     opal_atomic_int32_t send_sequence; /**< send side sequence number */
+    opal_mutex_t *matching_lock;   /**< lock protecting the matching state of this peer */
     struct mca_pml_ob1_recv_frag_t* frags_cant_match;  /**< out-of-order fragment queues */
+    uint32_t eager_limit;          /**< eager limit learned from the rendezvous (0 if none) */
+    float rndv_latency;            /**< smoothed rendezvous handshake round trip (usec) */
+    float rndv_bandwidth;          /**< smoothed rendezvous throughput (bytes/usec) */
+    struct mca_pml_ob1_coalesce_t *coalesce; /**< small messages being coalesced to the peer */
+    opal_atomic_int32_t send_credits;    /**< eager bytes the peer can still buffer - sender side */
+    opal_atomic_int32_t matched_credits; /**< eager bytes matched, not returned yet - receiver side */
+    size_t unexpected_bytes;       /**< bytes held by the unexpected fragments of the peer */
 #if !MCA_PML_OB1_CUSTOM_MATCH
     opal_list_t specific_receives; /**< queues of unmatched specific receives */
     opal_list_t unexpected_frags;  /**< unexpected fragment queues */
@@ -60,8 +68,10 @@ OBJ_CLASS_DECLARATION(mca_pml_ob1_comm_proc_t);
  */
 struct mca_pml_comm_t {
     opal_object_t super;
-    volatile uint32_t recv_sequence;  /**< recv request sequence number - receiver side */
-    opal_mutex_t matching_lock;   /**< matching lock */
+    opal_atomic_int32_t recv_sequence;  /**< recv request sequence number - receiver side */
+    opal_mutex_t matching_lock;   /**< matching lock, or wildcard lock when the peers are sharded */
+    opal_mutex_t *shard_locks;    /**< per peer shard matching locks (NULL if not sharded) */
+    uint32_t shard_mask;          /**< number of shard locks minus one */
 #if !MCA_PML_OB1_CUSTOM_MATCH
     opal_list_t wild_receives;    /**< queue of unmatched wild (source process not specified) receives */
 #endif
@@ -98,6 +108,8 @@ static inline mca_pml_ob1_comm_proc_t *mca_pml_ob1_peer_lookup (struct ompi_comm
             mca_pml_ob1_comm_proc_t* proc = OBJ_NEW(mca_pml_ob1_comm_proc_t);
             proc->ompi_proc = ompi_comm_peer_lookup (comm, rank);
             OBJ_RETAIN(proc->ompi_proc);
+            proc->matching_lock = (NULL == pml_comm->shard_locks) ? &pml_comm->matching_lock :
+                pml_comm->shard_locks + (rank & pml_comm->shard_mask);
             opal_atomic_wmb ();
             pml_comm->procs[rank] = proc;
         }
@@ -117,6 +129,18 @@ static inline mca_pml_ob1_comm_proc_t *mca_pml_ob1_peer_lookup (struct ompi_comm
 
 extern int mca_pml_ob1_comm_init_size(mca_pml_ob1_comm_t* comm, size_t size);
 
+/**
+ * Acquire (release) the matching locks of all the peers of the communicator.
+ *
+ * When the peers are sharded the matching of a fragment only holds the lock
+ * of the shard of its source, plus the wildcard lock if wildcard receives are
+ * posted. Operations scanning or modifying the state of several peers
+ * (wildcard receives and probes, cancellation of a wildcard receive, revoke)
+ * hold all the shard locks, taken in ascending order.
+ */
+extern void mca_pml_ob1_comm_lock_all(mca_pml_ob1_comm_t* comm);
+extern void mca_pml_ob1_comm_unlock_all(mca_pml_ob1_comm_t* comm);
+
 END_C_DECLS
 #endif
 
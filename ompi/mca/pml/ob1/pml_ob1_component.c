@@ -35,6 +35,7 @@
 #include "ompi/mca/pml/base/pml_base_bsend.h"
 #include "pml_ob1.h"
 #include "pml_ob1_hdr.h"
+#include "pml_ob1_coalesce.h"
 #include "pml_ob1_sendreq.h"
 #include "pml_ob1_recvreq.h"
 #include "pml_ob1_rdmafrag.h"
@@ -167,6 +168,37 @@ static int mca_pml_ob1_get_unex_msgq_size (const struct mca_base_pvar_t *pvar, v
     return OMPI_SUCCESS;
 }
 
+static int mca_pml_ob1_get_unex_msgq_bytes (const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
+{
+    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
+    mca_pml_ob1_comm_t *pml_comm = comm->c_pml_comm;
+    int comm_size = ompi_comm_size (comm);
+    unsigned long *values = (unsigned long *) value;
+
+    for (int i = 0 ; i < comm_size ; ++i) {
+        values[i] = pml_comm->procs[i] ? (unsigned long) pml_comm->procs[i]->unexpected_bytes : 0;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static int mca_pml_ob1_get_flow_control_credits (const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
+{
+    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
+    mca_pml_ob1_comm_t *pml_comm = comm->c_pml_comm;
+    int comm_size = ompi_comm_size (comm);
+    unsigned *values = (unsigned *) value;
+
+    /* the peers never sent to hold a full window */
+    for (int i = 0 ; i < comm_size ; ++i) {
+        int32_t credits = pml_comm->procs[i] ? pml_comm->procs[i]->send_credits
+                                             : (int32_t) mca_pml_ob1.flow_control_credits;
+        values[i] = credits > 0 ? (unsigned) credits : 0;
+    }
+
+    return OMPI_SUCCESS;
+}
+
 static int mca_pml_ob1_get_posted_recvq_size (const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
 {
     ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
@@ -194,6 +226,49 @@ static int mca_pml_ob1_get_posted_recvq_size (const struct mca_base_pvar_t *pvar
     return OMPI_SUCCESS;
 }
 
+static int mca_pml_ob1_get_adaptive_eager_limit (const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
+{
+    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
+    mca_pml_ob1_comm_t *pml_comm = comm->c_pml_comm;
+    int comm_size = ompi_comm_size (comm);
+    unsigned *values = (unsigned *) value;
+
+    for (int i = 0 ; i < comm_size ; ++i) {
+        values[i] = pml_comm->procs[i] ? pml_comm->procs[i]->eager_limit : 0;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static int mca_pml_ob1_get_rndv_latency (const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
+{
+    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
+    mca_pml_ob1_comm_t *pml_comm = comm->c_pml_comm;
+    int comm_size = ompi_comm_size (comm);
+    double *values = (double *) value;
+
+    for (int i = 0 ; i < comm_size ; ++i) {
+        values[i] = pml_comm->procs[i] ? pml_comm->procs[i]->rndv_latency : 0.0;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static int mca_pml_ob1_get_rndv_bandwidth (const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
+{
+    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
+    mca_pml_ob1_comm_t *pml_comm = comm->c_pml_comm;
+    int comm_size = ompi_comm_size (comm);
+    double *values = (double *) value;
+
+    /* bytes per usec are MB/s */
+    for (int i = 0 ; i < comm_size ; ++i) {
+        values[i] = pml_comm->procs[i] ? pml_comm->procs[i]->rndv_bandwidth : 0.0;
+    }
+
+    return OMPI_SUCCESS;
+}
+
 static int mca_pml_ob1_component_register(void)
 {
     mca_pml_ob1_param_register_int("verbose", 0, &mca_pml_ob1_verbose);
@@ -216,6 +291,84 @@ static int mca_pml_ob1_component_register(void)
 
     mca_pml_ob1_param_register_uint("unexpected_limit", 128, &mca_pml_ob1.unexpected_limit);
 
+    mca_pml_ob1.matching_shards = 16;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "matching_shards",
+                                           "Number of shards, each with its own lock, the peers of a "
+                                           "communicator are distributed into for matching when running "
+                                           "multithreaded. Threads receiving from peers of different shards "
+                                           "match concurrently, wildcard receives lock all the shards. "
+                                           "Rounded up to a power of 2, 1 serializes all the matching of a "
+                                           "communicator (default: 16)", MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_pml_ob1.matching_shards);
+
+    mca_pml_ob1.adaptive_eager = false;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "adaptive_eager",
+                                           "Learn the eager limit of each peer as the bandwidth-delay product "
+                                           "of the rendezvous with it, which lowers the eager limit of the "
+                                           "peers with a low latency or a low throughput. The BTL eager limit "
+                                           "remains the upper bound (default: false)", MCA_BASE_VAR_TYPE_BOOL,
+                                           NULL, 0, 0, OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_pml_ob1.adaptive_eager);
+
+    mca_pml_ob1.adaptive_eager_scale = 1.0;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "adaptive_eager_scale",
+                                           "Factor applied to the bandwidth-delay product of the rendezvous "
+                                           "with a peer to get its learned eager limit (default: 1.0)",
+                                           MCA_BASE_VAR_TYPE_DOUBLE, NULL, 0, 0, OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.adaptive_eager_scale);
+
+    mca_pml_ob1.coalesce = false;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "coalesce",
+                                           "Pack the small eager messages sent to the same peer into a "
+                                           "single fragment. The fragment is sent when full, when its "
+                                           "first message waited more than coalesce_delay, when the "
+                                           "progress engine runs, or before any other send to the peer "
+                                           "(default: false)", MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_pml_ob1.coalesce);
+
+    mca_pml_ob1.coalesce_max_msg = 256;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "coalesce_max_msg",
+                                           "Largest message, in bytes, that is coalesced (default: 256)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.coalesce_max_msg);
+
+    mca_pml_ob1.coalesce_size = 8192;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "coalesce_size",
+                                           "Size, in bytes, of the coalesced fragments. The eager limit "
+                                           "of the BTL remains the upper bound (default: 8192)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.coalesce_size);
+
+    mca_pml_ob1.coalesce_delay = 10;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "coalesce_delay",
+                                           "Time, in microseconds, after which the next message sent to "
+                                           "the peer flushes a coalesced fragment (default: 10)",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, 0, OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.coalesce_delay);
+
+    mca_pml_ob1.flow_control = false;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "flow_control",
+                                           "Bound the eager bytes sent to each peer and not yet matched by "
+                                           "it to flow_control_credits. The messages exceeding the bound, "
+                                           "and all the rendezvous, carry no data before they are matched, "
+                                           "so the memory used by unexpected messages stays bounded. Must "
+                                           "be the same on all processes (default: false)",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.flow_control);
+
+    mca_pml_ob1.flow_control_credits = 65536;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "flow_control_credits",
+                                           "Eager bytes, match headers included, that may be in flight to "
+                                           "each peer of a communicator when flow control is enabled "
+                                           "(default: 65536)", MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_pml_ob1.flow_control_credits);
+    if (mca_pml_ob1.flow_control_credits > INT32_MAX) {
+        mca_pml_ob1.flow_control_credits = INT32_MAX;
+    }
+
     mca_pml_ob1.use_all_rdma = false;
     (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "use_all_rdma",
                                            "Use all available RDMA btls for the RDMA and RDMA pipeline protocols "
@@ -234,6 +387,21 @@ static int mca_pml_ob1_component_register(void)
                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
                                            mca_pml_ob1_get_unex_msgq_size, NULL, mca_pml_ob1_comm_size_notify, NULL);
 
+    (void)mca_base_component_pvar_register(&mca_pml_ob1_component.pmlm_version,
+                                           "unexpected_msgq_bytes", "Number of bytes held by the unexpected "
+                                           "messages received by each peer in a communicator", OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_SIZE,
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_LONG, NULL, MPI_T_BIND_MPI_COMM,
+                                           MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                           mca_pml_ob1_get_unex_msgq_bytes, NULL, mca_pml_ob1_comm_size_notify, NULL);
+
+    (void)mca_base_component_pvar_register(&mca_pml_ob1_component.pmlm_version,
+                                           "flow_control_credits", "Eager bytes each peer in a communicator "
+                                           "can still receive from this process when flow control is enabled",
+                                           OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_LEVEL,
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, MPI_T_BIND_MPI_COMM,
+                                           MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                           mca_pml_ob1_get_flow_control_credits, NULL, mca_pml_ob1_comm_size_notify, NULL);
+
     (void)mca_base_component_pvar_register(&mca_pml_ob1_component.pmlm_version,
                                            "posted_recvq_length", "Number of unmatched receives "
                                            "posted for each peer in a communicator", OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_SIZE,
@@ -241,6 +409,27 @@ static int mca_pml_ob1_component_register(void)
                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
                                            mca_pml_ob1_get_posted_recvq_size, NULL, mca_pml_ob1_comm_size_notify, NULL);
 
+    (void)mca_base_component_pvar_register(&mca_pml_ob1_component.pmlm_version,
+                                           "adaptive_eager_limit", "Eager limit learned for each peer "
+                                           "in a communicator (0 if none)", OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_SIZE,
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, MPI_T_BIND_MPI_COMM,
+                                           MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                           mca_pml_ob1_get_adaptive_eager_limit, NULL, mca_pml_ob1_comm_size_notify, NULL);
+
+    (void)mca_base_component_pvar_register(&mca_pml_ob1_component.pmlm_version,
+                                           "rndv_latency", "Estimated rendezvous round trip (usec) with "
+                                           "each peer in a communicator", OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_GENERIC,
+                                           MCA_BASE_VAR_TYPE_DOUBLE, NULL, MPI_T_BIND_MPI_COMM,
+                                           MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                           mca_pml_ob1_get_rndv_latency, NULL, mca_pml_ob1_comm_size_notify, NULL);
+
+    (void)mca_base_component_pvar_register(&mca_pml_ob1_component.pmlm_version,
+                                           "rndv_bandwidth", "Estimated rendezvous throughput (MB/s) with "
+                                           "each peer in a communicator", OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_GENERIC,
+                                           MCA_BASE_VAR_TYPE_DOUBLE, NULL, MPI_T_BIND_MPI_COMM,
+                                           MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                           mca_pml_ob1_get_rndv_bandwidth, NULL, mca_pml_ob1_comm_size_notify, NULL);
+
     return OMPI_SUCCESS;
 }
 
@@ -321,6 +510,10 @@ int mca_pml_ob1_component_fini(void)
 {
     int rc;
 
+    if (mca_pml_ob1.enabled && mca_pml_ob1.coalesce) {
+        mca_pml_ob1_coalesce_fini ();
+    }
+
     /* Shutdown BML */
     if(OMPI_SUCCESS != (rc = mca_bml.bml_finalize()))
         return rc;
@@ -352,6 +545,11 @@ int mca_pml_ob1_component_fini(void)
     OBJ_DESTRUCT(&mca_pml_ob1.recv_pending);
     OBJ_DESTRUCT(&mca_pml_ob1.send_pending);
     OBJ_DESTRUCT(&mca_pml_ob1.non_existing_communicator_pending);
+    if (mca_pml_ob1.coalesce) {
+        opal_progress_unregister (mca_pml_ob1_coalesce_progress);
+    }
+    OBJ_DESTRUCT(&mca_pml_ob1.coalesce_retry);
+    OBJ_DESTRUCT(&mca_pml_ob1.coalesce_pending);
     OBJ_DESTRUCT(&mca_pml_ob1.buffers);
     OBJ_DESTRUCT(&mca_pml_ob1.pending_pckts);
     OBJ_DESTRUCT(&mca_pml_ob1.recv_frags);
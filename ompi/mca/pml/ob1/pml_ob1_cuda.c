@@ -71,11 +71,14 @@ int mca_pml_ob1_send_request_start_cuda(mca_pml_ob1_send_request_t* sendreq,
         opal_convertor_get_current_pointer( &sendreq->req_send.req_base.req_convertor, (void**)&base );
         /* Set flag back */
         sendreq->req_send.req_base.req_convertor.flags |= CONVERTOR_CUDA;
-        if( 0 != (sendreq->req_rdma_cnt = (uint32_t)mca_pml_ob1_rdma_cuda_btls(
-                                                                           sendreq->req_endpoint,
-                                                                           base,
-                                                                           sendreq->req_send.req_bytes_packed,
-                                                                           sendreq->req_rdma))) {
+        /* a restarted persistent request still holds the registrations of its buffer */
+        if( 0 == sendreq->req_rdma_cnt ) {
+            sendreq->req_rdma_cnt = (uint32_t)mca_pml_ob1_rdma_cuda_btls(sendreq->req_endpoint,
+                                                                         base,
+                                                                         sendreq->req_send.req_bytes_packed,
+                                                                         sendreq->req_rdma);
+        }
+        if( 0 != sendreq->req_rdma_cnt ) {
             rc = mca_pml_ob1_send_request_start_rdma(sendreq, bml_btl,
                                                      sendreq->req_send.req_bytes_packed);
             if( OPAL_UNLIKELY(OMPI_SUCCESS != rc) ) {
@@ -0,0 +1,101 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "ompi/mca/bml/bml.h"
+#include "ompi/runtime/ompi_spc.h"
+#include "pml_ob1.h"
+#include "pml_ob1_flow_control.h"
+#include "pml_ob1_hdr.h"
+#include "pml_ob1_recvreq.h"
+#include "pml_ob1_sendreq.h"
+
+static void mca_pml_ob1_credit_completion (mca_btl_base_module_t* btl,
+                                           struct mca_btl_base_endpoint_t* ep,
+                                           struct mca_btl_base_descriptor_t* des,
+                                           int status)
+{
+    mca_bml_base_btl_t* bml_btl = (mca_bml_base_btl_t*) des->des_context;
+
+    /* check for pending requests */
+    MCA_PML_OB1_PROGRESS_PENDING(bml_btl);
+}
+
+int mca_pml_ob1_send_credits_btl (ompi_proc_t *proc, mca_bml_base_btl_t *bml_btl, uint16_t ctx,
+                                  int32_t src, uint32_t credits)
+{
+    mca_btl_base_descriptor_t *des;
+    int rc;
+
+    mca_bml_base_alloc (bml_btl, &des, MCA_BTL_NO_ORDER, sizeof (mca_pml_ob1_credit_hdr_t),
+                        MCA_BTL_DES_FLAGS_PRIORITY | MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
+    if (OPAL_UNLIKELY(NULL == des)) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    des->des_cbfunc = mca_pml_ob1_credit_completion;
+    des->des_cbdata = NULL;
+
+    mca_pml_ob1_credit_hdr_prepare ((mca_pml_ob1_credit_hdr_t *) des->des_segments->seg_addr.pval, 0,
+                                    ctx, src, credits);
+    ob1_hdr_hton ((mca_pml_ob1_hdr_t *) des->des_segments->seg_addr.pval, MCA_PML_OB1_HDR_TYPE_CREDIT,
+                  proc);
+
+    rc = mca_bml_base_send (bml_btl, des, MCA_PML_OB1_HDR_TYPE_CREDIT);
+    if (OPAL_LIKELY(rc >= 0)) {
+        if (OPAL_LIKELY(1 == rc)) {
+            MCA_PML_OB1_PROGRESS_PENDING(bml_btl);
+        }
+        SPC_RECORD(OMPI_SPC_BYTES_SENT_MPI, (ompi_spc_value_t) sizeof (mca_pml_ob1_credit_hdr_t));
+        return OMPI_SUCCESS;
+    }
+
+    mca_bml_base_free (bml_btl, des);
+    return OMPI_ERR_OUT_OF_RESOURCE;
+}
+
+void mca_pml_ob1_flow_control_matched (ompi_communicator_t *comm, int src, size_t size)
+{
+    mca_pml_ob1_comm_proc_t *ob1_proc = mca_pml_ob1_peer_lookup (comm, src);
+    mca_bml_base_endpoint_t *endpoint;
+    mca_bml_base_btl_t *bml_btl;
+    int32_t credits;
+
+    credits = OPAL_THREAD_ADD_FETCH32(&ob1_proc->matched_credits, MCA_PML_OB1_FLOW_CONTROL_COST(size));
+    if (credits < (int32_t) (mca_pml_ob1.flow_control_credits / 2)) {
+        return;
+    }
+
+    /* only one thread returns the credits accumulated so far */
+    credits = OPAL_THREAD_SWAP_32(&ob1_proc->matched_credits, 0);
+    if (credits <= 0) {
+        return;
+    }
+
+    endpoint = mca_bml_base_get_endpoint (ob1_proc->ompi_proc);
+    if (OPAL_UNLIKELY(NULL == endpoint)) {
+        /* returned with the next matched message */
+        (void) OPAL_THREAD_ADD_FETCH32(&ob1_proc->matched_credits, credits);
+        return;
+    }
+
+    bml_btl = mca_bml_base_btl_array_get_next (&endpoint->btl_eager);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != mca_pml_ob1_send_credits_btl (ob1_proc->ompi_proc, bml_btl,
+                                                                    comm->c_contextid, comm->c_my_rank,
+                                                                    (uint32_t) credits))) {
+        /* the sender may wait for these credits without sending anything
+         * else, send them again once the btl has resources like the ACK
+         * and the FIN */
+        MCA_PML_OB1_ADD_CREDIT_TO_PENDING(ob1_proc->ompi_proc, comm->c_contextid, comm->c_my_rank,
+                                          (uint32_t) credits);
+    }
+}
@@ -0,0 +1,101 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ *  @file
+ *
+ *  Credit-based flow control of the eager messages. Each sender holds a
+ *  window of flow_control_credits bytes per peer of a communicator. An
+ *  eager message consumes its payload and its match header from the
+ *  window, and the receiver returns them once the message is matched. A
+ *  message that does not fit in the window is sent with a rendezvous,
+ *  and when flow control is enabled the rendezvous carry no data, so the
+ *  unexpected messages a receiver buffers for a peer are bounded by the
+ *  window plus the rendezvous headers.
+ */
+
+#ifndef MCA_PML_OB1_FLOW_CONTROL_H
+#define MCA_PML_OB1_FLOW_CONTROL_H
+
+#include "pml_ob1.h"
+#include "pml_ob1_comm.h"
+#include "pml_ob1_hdr.h"
+
+BEGIN_C_DECLS
+
+/* credits consumed by an eager message of size bytes */
+#define MCA_PML_OB1_FLOW_CONTROL_COST(size) ((int32_t) ((size) + OMPI_PML_OB1_MATCH_HDR_LEN))
+
+/**
+ * Take the credits of an eager message of size bytes to the peer.
+ *
+ * @returns true if the message can be sent eagerly, false if it has to
+ *          use a rendezvous.
+ */
+static inline bool mca_pml_ob1_flow_control_acquire (mca_pml_ob1_comm_proc_t *ob1_proc, size_t size)
+{
+    int32_t cost;
+
+    if (size > mca_pml_ob1.flow_control_credits) {
+        return false;
+    }
+
+    cost = MCA_PML_OB1_FLOW_CONTROL_COST(size);
+    if (OPAL_LIKELY(OPAL_THREAD_ADD_FETCH32(&ob1_proc->send_credits, -cost) >= 0)) {
+        return true;
+    }
+
+    (void) OPAL_THREAD_ADD_FETCH32(&ob1_proc->send_credits, cost);
+    return false;
+}
+
+/**
+ * Give back the credits of an eager message that could not be sent.
+ */
+static inline void mca_pml_ob1_flow_control_release (mca_pml_ob1_comm_proc_t *ob1_proc, size_t size)
+{
+    (void) OPAL_THREAD_ADD_FETCH32(&ob1_proc->send_credits, MCA_PML_OB1_FLOW_CONTROL_COST(size));
+}
+
+/**
+ * Account an eager message of size bytes from the rank src of the
+ * communicator as matched. The credits are returned to the sender once
+ * half of its window is matched.
+ */
+void mca_pml_ob1_flow_control_matched (ompi_communicator_t *comm, int src, size_t size);
+
+/**
+ * Send a CREDIT to proc on bml_btl, returning credits for the messages
+ * the rank src of the communicator ctx matched.
+ *
+ * @returns OMPI_ERR_OUT_OF_RESOURCE if the btl can not take the packet.
+ */
+int mca_pml_ob1_send_credits_btl (ompi_proc_t *proc, mca_bml_base_btl_t *bml_btl, uint16_t ctx,
+                                  int32_t src, uint32_t credits);
+
+#define MCA_PML_OB1_ADD_CREDIT_TO_PENDING(P, C, S, Cr)                  \
+    do {                                                                \
+        mca_pml_ob1_pckt_pending_t *_pckt;                              \
+                                                                        \
+        MCA_PML_OB1_PCKT_PENDING_ALLOC(_pckt);                          \
+        mca_pml_ob1_credit_hdr_prepare (&_pckt->hdr.hdr_credit, 0,      \
+                                        (C), (S), (Cr));                \
+        _pckt->proc = (P);                                              \
+        _pckt->bml_btl = NULL;                                          \
+        OPAL_THREAD_LOCK(&mca_pml_ob1.lock);                            \
+        opal_list_append(&mca_pml_ob1.pckt_pending,                     \
+                         (opal_list_item_t*)_pckt);                     \
+        OPAL_THREAD_UNLOCK(&mca_pml_ob1.lock);                          \
+    } while(0)
+
+END_C_DECLS
+
+#endif  /* MCA_PML_OB1_FLOW_CONTROL_H */
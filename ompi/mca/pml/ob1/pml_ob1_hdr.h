@@ -35,6 +35,7 @@
 #include <netinet/in.h>
 #endif
 
+#include "opal/align.h"
 #include "opal/types.h"
 #include "opal/util/arch.h"
 #include "opal/mca/btl/btl.h"
@@ -49,6 +50,8 @@
 #define MCA_PML_OB1_HDR_TYPE_GET       (MCA_BTL_TAG_PML + 7)
 #define MCA_PML_OB1_HDR_TYPE_PUT       (MCA_BTL_TAG_PML + 8)
 #define MCA_PML_OB1_HDR_TYPE_FIN       (MCA_BTL_TAG_PML + 9)
+#define MCA_PML_OB1_HDR_TYPE_COALESCED (MCA_BTL_TAG_PML + 10)
+#define MCA_PML_OB1_HDR_TYPE_CREDIT    (MCA_BTL_TAG_PML + 11)
 
 #define MCA_PML_OB1_HDR_FLAGS_ACK     1  /* is an ack required */
 #define MCA_PML_OB1_HDR_FLAGS_NBO     2  /* is the hdr in network byte order */
@@ -413,6 +416,116 @@ static inline void mca_pml_ob1_fin_hdr_prepare (mca_pml_ob1_fin_hdr_t *hdr, uint
         (h).hdr_size = hton64((h).hdr_size);         \
     } while (0)
 
+/**
+ *  Header of a fragment carrying several eager messages to the same
+ *  peer. It is followed by hdr_count entries, each one starting on an
+ *  8 bytes boundary.
+ */
+struct mca_pml_ob1_coalesced_hdr_t {
+    mca_pml_ob1_common_hdr_t hdr_common;      /**< common attributes */
+    uint16_t hdr_count;                       /**< number of messages in the fragment */
+    uint8_t hdr_padding[4];                   /**< the first entry is 8 bytes aligned */
+};
+typedef struct mca_pml_ob1_coalesced_hdr_t mca_pml_ob1_coalesced_hdr_t;
+
+/**
+ *  A message of a coalesced fragment: the match header and the payload
+ *  it would have been sent with on its own.
+ */
+struct mca_pml_ob1_coalesced_entry_t {
+    uint32_t hdr_length;                      /**< length of the match header and of the payload */
+    mca_pml_ob1_match_hdr_t hdr_match;        /**< match header, followed by the payload */
+};
+typedef struct mca_pml_ob1_coalesced_entry_t mca_pml_ob1_coalesced_entry_t;
+
+#define MCA_PML_OB1_COALESCED_ENTRY_LEN(length) \
+    OPAL_ALIGN(offsetof(mca_pml_ob1_coalesced_entry_t, hdr_match) + (length), 8, size_t)
+
+/* the length follows the byte order of the match header of the entry */
+#define MCA_PML_OB1_COALESCED_ENTRY_NTOH(e)                                  \
+    do {                                                                     \
+        if ((e).hdr_match.hdr_common.hdr_flags & MCA_PML_OB1_HDR_FLAGS_NBO)  \
+            (e).hdr_length = ntohl((e).hdr_length);                          \
+    } while (0)
+
+#define MCA_PML_OB1_COALESCED_ENTRY_HTON(e)                                  \
+    do {                                                                     \
+        if ((e).hdr_match.hdr_common.hdr_flags & MCA_PML_OB1_HDR_FLAGS_NBO)  \
+            (e).hdr_length = htonl((e).hdr_length);                          \
+    } while (0)
+
+static inline void mca_pml_ob1_coalesced_hdr_prepare (mca_pml_ob1_coalesced_hdr_t *hdr, uint8_t hdr_flags,
+                                                      uint16_t hdr_count)
+{
+    mca_pml_ob1_common_hdr_prepare (&hdr->hdr_common, MCA_PML_OB1_HDR_TYPE_COALESCED, hdr_flags);
+    hdr->hdr_count = hdr_count;
+#if OPAL_ENABLE_DEBUG
+    hdr->hdr_padding[0] = 0;
+    hdr->hdr_padding[1] = 0;
+    hdr->hdr_padding[2] = 0;
+    hdr->hdr_padding[3] = 0;
+#endif
+}
+
+#define MCA_PML_OB1_COALESCED_HDR_NTOH(h)            \
+    do {                                             \
+        MCA_PML_OB1_COMMON_HDR_NTOH((h).hdr_common); \
+        (h).hdr_count = ntohs((h).hdr_count);        \
+    } while (0)
+
+#define MCA_PML_OB1_COALESCED_HDR_HTON(h)            \
+    do {                                             \
+        MCA_PML_OB1_COMMON_HDR_HTON((h).hdr_common); \
+        (h).hdr_count = htons((h).hdr_count);        \
+    } while (0)
+
+/**
+ *  Header returning eager credits to a sender when flow control is
+ *  enabled. The communicator and the rank identify the sender as seen
+ *  by the receiver, as in the match header.
+ */
+struct mca_pml_ob1_credit_hdr_t {
+    mca_pml_ob1_common_hdr_t hdr_common;      /**< common attributes */
+    uint16_t hdr_ctx;                         /**< communicator index */
+    int32_t  hdr_src;                         /**< rank of the receiver returning the credits */
+    uint32_t hdr_credits;                     /**< number of bytes returned */
+#if OPAL_ENABLE_HETEROGENEOUS_SUPPORT || OPAL_ENABLE_DEBUG
+    uint8_t  hdr_padding[4];
+#endif
+};
+typedef struct mca_pml_ob1_credit_hdr_t mca_pml_ob1_credit_hdr_t;
+
+static inline void mca_pml_ob1_credit_hdr_prepare (mca_pml_ob1_credit_hdr_t *hdr, uint8_t hdr_flags,
+                                                   uint16_t hdr_ctx, int32_t hdr_src, uint32_t hdr_credits)
+{
+    mca_pml_ob1_common_hdr_prepare (&hdr->hdr_common, MCA_PML_OB1_HDR_TYPE_CREDIT, hdr_flags);
+    hdr->hdr_ctx = hdr_ctx;
+    hdr->hdr_src = hdr_src;
+    hdr->hdr_credits = hdr_credits;
+#if OPAL_ENABLE_DEBUG
+    hdr->hdr_padding[0] = 0;
+    hdr->hdr_padding[1] = 0;
+    hdr->hdr_padding[2] = 0;
+    hdr->hdr_padding[3] = 0;
+#endif
+}
+
+#define MCA_PML_OB1_CREDIT_HDR_NTOH(h)               \
+    do {                                             \
+        MCA_PML_OB1_COMMON_HDR_NTOH((h).hdr_common); \
+        (h).hdr_ctx = ntohs((h).hdr_ctx);            \
+        (h).hdr_src = ntohl((h).hdr_src);            \
+        (h).hdr_credits = ntohl((h).hdr_credits);    \
+    } while (0)
+
+#define MCA_PML_OB1_CREDIT_HDR_HTON(h)               \
+    do {                                             \
+        MCA_PML_OB1_COMMON_HDR_HTON((h).hdr_common); \
+        (h).hdr_ctx = htons((h).hdr_ctx);            \
+        (h).hdr_src = htonl((h).hdr_src);            \
+        (h).hdr_credits = htonl((h).hdr_credits);    \
+    } while (0)
+
 /**
  * Union of defined hdr types.
  */
@@ -425,6 +538,8 @@ union mca_pml_ob1_hdr_t {
     mca_pml_ob1_ack_hdr_t hdr_ack;
     mca_pml_ob1_rdma_hdr_t hdr_rdma;
     mca_pml_ob1_fin_hdr_t hdr_fin;
+    mca_pml_ob1_coalesced_hdr_t hdr_coalesced;
+    mca_pml_ob1_credit_hdr_t hdr_credit;
 };
 typedef union mca_pml_ob1_hdr_t mca_pml_ob1_hdr_t;
 
@@ -457,6 +572,12 @@ ob1_hdr_ntoh(mca_pml_ob1_hdr_t *hdr, const uint8_t hdr_type)
         case MCA_PML_OB1_HDR_TYPE_FIN:
             MCA_PML_OB1_FIN_HDR_NTOH(hdr->hdr_fin);
             break;
+        case MCA_PML_OB1_HDR_TYPE_COALESCED:
+            MCA_PML_OB1_COALESCED_HDR_NTOH(hdr->hdr_coalesced);
+            break;
+        case MCA_PML_OB1_HDR_TYPE_CREDIT:
+            MCA_PML_OB1_CREDIT_HDR_NTOH(hdr->hdr_credit);
+            break;
         default:
             assert(0);
             break;
@@ -503,6 +624,12 @@ ob1_hdr_hton_intr(mca_pml_ob1_hdr_t *hdr, const uint8_t hdr_type,
         case MCA_PML_OB1_HDR_TYPE_FIN:
             MCA_PML_OB1_FIN_HDR_HTON(hdr->hdr_fin);
             break;
+        case MCA_PML_OB1_HDR_TYPE_COALESCED:
+            MCA_PML_OB1_COALESCED_HDR_HTON(hdr->hdr_coalesced);
+            break;
+        case MCA_PML_OB1_HDR_TYPE_CREDIT:
+            MCA_PML_OB1_CREDIT_HDR_HTON(hdr->hdr_credit);
+            break;
         default:
             assert(0);
             break;
@@ -26,6 +26,8 @@
 
 #include "pml_ob1.h"
 #include "pml_ob1_sendreq.h"
+#include "pml_ob1_coalesce.h"
+#include "pml_ob1_flow_control.h"
 #include "pml_ob1_recvreq.h"
 #include "ompi/peruse/peruse-internal.h"
 #include "ompi/runtime/ompi_spc.h"
@@ -78,9 +80,10 @@ int mca_pml_ob1_isend_init(const void *buf,
 static inline int mca_pml_ob1_send_inline (const void *buf, size_t count,
                                            ompi_datatype_t * datatype,
                                            int dst, int tag, int16_t seqn,
-                                           ompi_proc_t *dst_proc, mca_bml_base_endpoint_t* endpoint,
+                                           mca_pml_ob1_comm_proc_t *ob1_proc, mca_bml_base_endpoint_t* endpoint,
                                            ompi_communicator_t * comm)
 {
+    ompi_proc_t *dst_proc = ob1_proc->ompi_proc;
     mca_pml_ob1_match_hdr_t match;
     mca_bml_base_btl_t *bml_btl;
     opal_convertor_t convertor;
@@ -110,6 +113,13 @@ static inline int mca_pml_ob1_send_inline (const void *buf, size_t count,
         size = 0;
     }
 
+    if (OPAL_UNLIKELY(mca_pml_ob1.flow_control) && !mca_pml_ob1_flow_control_acquire (ob1_proc, size)) {
+        if (count > 0) {
+            opal_convertor_cleanup (&convertor);
+        }
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
     mca_pml_ob1_match_hdr_prepare (&match, MCA_PML_OB1_HDR_TYPE_MATCH, 0,
                                    comm->c_contextid, comm->c_my_rank,
                                    tag, seqn);
@@ -138,6 +148,9 @@ static inline int mca_pml_ob1_send_inline (const void *buf, size_t count,
     }
 
     if (OPAL_UNLIKELY(OMPI_SUCCESS != rc)) {
+        if (mca_pml_ob1.flow_control) {
+            mca_pml_ob1_flow_control_release (ob1_proc, size);
+        }
 	return rc;
     }
 
@@ -173,8 +186,17 @@ int mca_pml_ob1_isend(const void *buf,
         seqn = (uint16_t) OPAL_THREAD_ADD_FETCH32(&ob1_proc->send_sequence, 1);
     }
 
+    if (OPAL_UNLIKELY(mca_pml_ob1.coalesce)) {
+        rc = mca_pml_ob1_coalesce_send (buf, count, datatype, tag, seqn, sendmode,
+                                        ob1_proc, endpoint, comm);
+        if (OMPI_SUCCESS == rc) {
+            *request = &ompi_request_empty;
+            return OMPI_SUCCESS;
+        }
+    }
+
     if (MCA_PML_BASE_SEND_SYNCHRONOUS != sendmode) {
-        rc = mca_pml_ob1_send_inline (buf, count, datatype, dst, tag, seqn, dst_proc,
+        rc = mca_pml_ob1_send_inline (buf, count, datatype, dst, tag, seqn, ob1_proc,
                                       endpoint, comm);
         if (OPAL_LIKELY(0 <= rc)) {
             /* NTH: it is legal to return ompi_request_empty since the only valid
@@ -272,13 +294,18 @@ int mca_pml_ob1_send(const void *buf,
         seqn = (uint16_t) OPAL_THREAD_ADD_FETCH32(&ob1_proc->send_sequence, 1);
     }
 
+    /* a blocking send does not wait for the coalesced messages before it */
+    if (OPAL_UNLIKELY(mca_pml_ob1.coalesce)) {
+        mca_pml_ob1_coalesce_flush_peer (ob1_proc);
+    }
+
     /**
      * The immediate send will not have a request, so they are
      * intracable from the point of view of any debugger attached to
      * the parallel application.
      */
     if (MCA_PML_BASE_SEND_SYNCHRONOUS != sendmode) {
-        rc = mca_pml_ob1_send_inline (buf, count, datatype, dst, tag, seqn, dst_proc,
+        rc = mca_pml_ob1_send_inline (buf, count, datatype, dst, tag, seqn, ob1_proc,
                                       endpoint, comm);
         if (OPAL_LIKELY(0 <= rc)) {
             return OMPI_SUCCESS;
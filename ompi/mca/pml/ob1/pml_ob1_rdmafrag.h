@@ -26,6 +26,7 @@
 #define MCA_PML_OB1_RDMAFRAG_H
 
 #include "pml_ob1_hdr.h"
+#include "opal/mca/timer/base/base.h"
 
 BEGIN_C_DECLS
 
@@ -53,6 +54,7 @@ struct mca_pml_ob1_rdma_frag_t {
     mca_pml_ob1_rdma_frag_callback_t cbfunc;
 
     uint64_t rdma_offset;
+    opal_timer_t rdma_start;  /* issue time, only when the BML adapts its RDMA weights */
     void *local_address;
     mca_btl_base_registration_handle_t *local_handle;
 
@@ -80,6 +82,24 @@ OBJ_CLASS_DECLARATION(mca_pml_ob1_rdma_frag_t);
                                (opal_free_list_item_t*)frag);           \
     } while (0)
 
+/* timestamp the issue of the RDMA operation of frag */
+#define MCA_PML_OB1_RDMA_FRAG_START(frag)                               \
+    do {                                                                \
+        if (NULL != mca_bml.bml_rdma_completed) {                       \
+            (frag)->rdma_start = opal_timer_base_get_usec ();           \
+        }                                                               \
+    } while (0)
+
+/* report the throughput of the completed RDMA operation of frag with proc to the BML */
+#define MCA_PML_OB1_RDMA_FRAG_COMPLETED(frag, proc)                     \
+    do {                                                                \
+        if (NULL != mca_bml.bml_rdma_completed) {                       \
+            mca_bml.bml_rdma_completed (mca_bml_base_get_endpoint (proc), \
+                                        (frag)->rdma_bml, (frag)->rdma_length, \
+                                        opal_timer_base_get_usec () - (frag)->rdma_start); \
+        }                                                               \
+    } while (0)
+
 END_C_DECLS
 
 #endif
@@ -348,8 +348,8 @@ int mca_pml_ob1_revoke_comm( struct ompi_communicator_t* ompi_comm, bool coll_on
 
     OBJ_CONSTRUCT(&nack_list, opal_list_t);
 
-    OPAL_THREAD_LOCK(&comm->matching_lock);
-    /* these assignement need to be here because we need the matching_lock */
+    mca_pml_ob1_comm_lock_all(comm);
+    /* these assignement need to be here because we need the matching locks */
     ompi_comm->coll_revoked = true;
     if( !coll_only ) ompi_comm->comm_revoked = true;
 
@@ -360,12 +360,30 @@ int mca_pml_ob1_revoke_comm( struct ompi_communicator_t* ompi_comm, bool coll_on
     }
 #endif /* OPAL_ENABLE_DEBUG */
 
+#if MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_HASH
+    /* the unexpected frags of all the procs are in the communicator queue.
+     * Only the hash engine can walk it, and it unlinks a node without its
+     * predecessor. The other custom engines leave the unexpected frags of
+     * a revoked communicator in the queue. */
+    custom_match_umq_node *elem, *next;
+    for( elem = custom_match_umq_iter(comm->umq, NULL); NULL != elem; elem = next ) {
+        mca_pml_ob1_recv_frag_t* frag = (mca_pml_ob1_recv_frag_t*)elem->value;
+        next = custom_match_umq_iter(comm->umq, elem);
+        if( pml_ob1_frag_is_revoked(ompi_comm, frag) ) {
+            custom_match_umq_remove_hold(comm->umq, NULL, elem, 0);
+            comm->procs[frag->hdr.hdr_match.hdr_src]->unexpected_bytes -= frag->segments[0].seg_len;
+            opal_list_append(&nack_list, &frag->super.super);
+        }
+    }
+#endif
+
     /* loop over all procs in that comm */
     for (i = 0; i < comm->num_procs; i++) {
         proc = comm->procs[i];
         /* note this is not an ompi_proc, but a ob1_comm_proc, thus we don't
          * use ompi_proc_is_sentinel to verify if initialized. */
         if( NULL == proc ) continue;
+#if !MCA_PML_OB1_CUSTOM_MATCH
         /* remove the frag from the unexpected list, add to the nack list 
          * so that we can send the nack as needed to remote cancel the send
          * from outside the match lock.
@@ -377,9 +395,11 @@ int mca_pml_ob1_revoke_comm( struct ompi_communicator_t* ompi_comm, bool coll_on
             mca_pml_ob1_recv_frag_t* frag = (mca_pml_ob1_recv_frag_t*)it;
             if( pml_ob1_frag_is_revoked(ompi_comm, frag) ) {
                 it = opal_list_remove_item( frags_list, it );
+                proc->unexpected_bytes -= frag->segments[0].seg_len;
                 opal_list_append(&nack_list, &frag->super.super);
             }
         }
+#endif
         /* same for the cantmatch queue/heap; this list is more complicated
          * Keep it simple: we pop all of the complex list, put the bad items 
          * in the nack_list, and keep the good items in the keep_list;
@@ -410,7 +430,7 @@ int mca_pml_ob1_revoke_comm( struct ompi_communicator_t* ompi_comm, bool coll_on
         if( verbose > 15) mca_pml_ob1_dump(ompi_comm, verbose);
     }
 #endif
-    OPAL_THREAD_UNLOCK(&comm->matching_lock);
+    mca_pml_ob1_comm_unlock_all(comm);
     while( NULL != (it = opal_list_remove_first(&nack_list)) ) {
         mca_pml_ob1_recv_frag_t* frag = (mca_pml_ob1_recv_frag_t*)it;
         mca_pml_ob1_hdr_t* hdr = (mca_pml_ob1_hdr_t*)frag->segments->seg_addr.pval;
@@ -454,7 +474,6 @@ void mca_pml_ob1_recv_frag_callback_match (mca_btl_base_module_t *btl,
     const mca_pml_ob1_match_hdr_t *hdr = (const mca_pml_ob1_match_hdr_t *) segments->seg_addr.pval;
     ompi_communicator_t *comm_ptr;
     mca_pml_ob1_recv_request_t *match = NULL;
-    mca_pml_ob1_comm_t *comm;
     mca_pml_ob1_comm_proc_t *proc;
     size_t num_segments = descriptor->des_segment_count;
     size_t bytes_received = 0;
@@ -480,8 +499,6 @@ void mca_pml_ob1_recv_frag_callback_match (mca_btl_base_module_t *btl,
                              btl, hdr, segments, num_segments, NULL );
         return;
     }
-    comm = (mca_pml_ob1_comm_t *)comm_ptr->c_pml_comm;
-
     /* source sequence number */
     proc = mca_pml_ob1_peer_lookup (comm_ptr, hdr->hdr_src);
 
@@ -501,14 +518,14 @@ void mca_pml_ob1_recv_frag_callback_match (mca_btl_base_module_t *btl,
      * end points) from being processed, and potentially "loosing"
      * the fragment.
      */
-    OB1_MATCHING_LOCK(&comm->matching_lock);
+    OB1_MATCHING_LOCK(proc->matching_lock);
 
 #if OPAL_ENABLE_FT_MPI
     if( OPAL_UNLIKELY((ompi_comm_is_revoked(comm_ptr) && !ompi_request_tag_is_ft(hdr->hdr_tag)) ||
                       (ompi_comm_coll_revoked(comm_ptr) && ompi_request_tag_is_collective(hdr->hdr_tag))) ) {
         /* if it's a TYPE_MATCH, the sender is not expecting anything from us
          * so we are done. */
-        OPAL_THREAD_UNLOCK(&comm->matching_lock);
+        OB1_MATCHING_UNLOCK(proc->matching_lock);
         OPAL_OUTPUT_VERBOSE((15, ompi_ftmpi_output_handle,
             "ob1_revoke_comm: dropping silently frag from %d", hdr->hdr_src));
         return;
@@ -526,7 +543,7 @@ void mca_pml_ob1_recv_frag_callback_match (mca_btl_base_module_t *btl,
             MCA_PML_OB1_RECV_FRAG_INIT(frag, hdr, segments, num_segments, btl);
             append_frag_to_ordered_list(&proc->frags_cant_match, frag, proc->expected_sequence);
             SPC_RECORD(OMPI_SPC_OUT_OF_SEQUENCE, 1);
-            OB1_MATCHING_UNLOCK(&comm->matching_lock);
+            OB1_MATCHING_UNLOCK(proc->matching_lock);
             return;
         }
 
@@ -551,7 +568,7 @@ void mca_pml_ob1_recv_frag_callback_match (mca_btl_base_module_t *btl,
                            hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
 
     /* release matching lock before processing fragment */
-    OB1_MATCHING_UNLOCK(&comm->matching_lock);
+    OB1_MATCHING_UNLOCK(proc->matching_lock);
 
     if(OPAL_LIKELY(match)) {
         bytes_received = segments->seg_len - OMPI_PML_OB1_MATCH_HDR_LEN;
@@ -614,13 +631,13 @@ void mca_pml_ob1_recv_frag_callback_match (mca_btl_base_module_t *btl,
      *
      * NOTE:
      * To optimize the number of lock used, mca_pml_ob1_recv_frag_match_proc()
-     * MUST be called with communicator lock and will RELEASE the lock. This is
+     * MUST be called with the proc matching lock and will RELEASE the lock. This is
      * not ideal but it is better for the performance.
      */
     if(NULL != proc->frags_cant_match) {
         mca_pml_ob1_recv_frag_t* frag;
 
-        OB1_MATCHING_LOCK(&comm->matching_lock);
+        OB1_MATCHING_LOCK(proc->matching_lock);
         if((frag = check_cantmatch_for_match(proc))) {
             /* mca_pml_ob1_recv_frag_match_proc() will release the lock. */
             mca_pml_ob1_recv_frag_match_proc(frag->btl, comm_ptr, proc,
@@ -628,12 +645,50 @@ void mca_pml_ob1_recv_frag_callback_match (mca_btl_base_module_t *btl,
                                              frag->segments, frag->num_segments,
                                              frag->hdr.hdr_match.hdr_common.hdr_type, frag);
         } else {
-            OB1_MATCHING_UNLOCK(&comm->matching_lock);
+            OB1_MATCHING_UNLOCK(proc->matching_lock);
         }
     }
 }
 
 
+void mca_pml_ob1_recv_frag_callback_coalesced (mca_btl_base_module_t *btl,
+                                               const mca_btl_base_receive_descriptor_t *descriptor)
+{
+    const mca_btl_base_segment_t *segments = descriptor->des_segments;
+    mca_pml_ob1_coalesced_hdr_t *hdr = (mca_pml_ob1_coalesced_hdr_t *) segments->seg_addr.pval;
+    unsigned char *ptr = (unsigned char *) (hdr + 1);
+    unsigned char *end = (unsigned char *) segments->seg_addr.pval + segments->seg_len;
+    mca_btl_base_receive_descriptor_t entry_des = *descriptor;
+    mca_btl_base_segment_t entry_segment;
+
+    if (OPAL_UNLIKELY(segments->seg_len < sizeof (mca_pml_ob1_coalesced_hdr_t))) {
+        return;
+    }
+    ob1_hdr_ntoh((mca_pml_ob1_hdr_t *) hdr, MCA_PML_OB1_HDR_TYPE_COALESCED);
+
+    entry_des.des_segments = &entry_segment;
+    entry_des.des_segment_count = 1;
+    entry_des.tag = MCA_PML_OB1_HDR_TYPE_MATCH;
+
+    /* the messages were packed in the order of their sequence numbers, hand
+     * them in the same order to the match path, which copies whatever it
+     * keeps of them */
+    for (uint16_t i = 0 ; i < hdr->hdr_count ; ++i) {
+        mca_pml_ob1_coalesced_entry_t *entry = (mca_pml_ob1_coalesced_entry_t *) ptr;
+
+        MCA_PML_OB1_COALESCED_ENTRY_NTOH(*entry);
+        if (OPAL_UNLIKELY((unsigned char *) &entry->hdr_match + entry->hdr_length > end)) {
+            return;
+        }
+
+        entry_segment.seg_addr.pval = &entry->hdr_match;
+        entry_segment.seg_len = entry->hdr_length;
+        mca_pml_ob1_recv_frag_callback_match (btl, &entry_des);
+
+        ptr += MCA_PML_OB1_COALESCED_ENTRY_LEN(entry->hdr_length);
+    }
+}
+
 void mca_pml_ob1_recv_frag_callback_rndv (mca_btl_base_module_t *btl,
                                           const mca_btl_base_receive_descriptor_t *descriptor)
 {
@@ -678,6 +733,26 @@ void mca_pml_ob1_recv_frag_callback_ack (mca_btl_base_module_t *btl,
     sendreq = (mca_pml_ob1_send_request_t *) hdr->hdr_ack.hdr_src_req.pval;
     sendreq->req_recv = hdr->hdr_ack.hdr_dst_req;
 
+    if (0 != sendreq->req_rndv_start && 0 == sendreq->req_rndv_ack) {
+        mca_pml_ob1_comm_proc_t *ob1_proc = mca_pml_ob1_peer_lookup (sendreq->req_send.req_base.req_comm,
+                                                                     sendreq->req_send.req_base.req_peer);
+        float latency;
+
+        sendreq->req_rndv_ack = opal_timer_base_get_usec ();
+        /* at least the resolution of the timer, 0 stands for no estimate */
+        latency = (float) (sendreq->req_rndv_ack - sendreq->req_rndv_start);
+        if (latency < 1.0) {
+            latency = 1.0;
+        }
+        /* a late receiver delays the ACK, so only let the samples raise the
+         * estimated round trip slowly */
+        if (0.0 == ob1_proc->rndv_latency || latency < ob1_proc->rndv_latency) {
+            ob1_proc->rndv_latency = latency;
+        } else {
+            ob1_proc->rndv_latency += (latency - ob1_proc->rndv_latency) / 8;
+        }
+    }
+
 #if OPAL_ENABLE_FT_MPI
     /* if the req_recv is NULL, the comm has been revoked at the receiver */
     if( OPAL_UNLIKELY(NULL == sendreq->req_recv.pval) ) {
@@ -804,6 +879,29 @@ void mca_pml_ob1_recv_frag_callback_fin(mca_btl_base_module_t *btl,
     frag->cbfunc (frag, hdr->hdr_size);
 }
 
+void mca_pml_ob1_recv_frag_callback_credit (mca_btl_base_module_t *btl,
+                                            const mca_btl_base_receive_descriptor_t *descriptor)
+{
+    const mca_btl_base_segment_t *segments = descriptor->des_segments;
+    const mca_pml_ob1_credit_hdr_t *hdr = (mca_pml_ob1_credit_hdr_t *) segments->seg_addr.pval;
+    ompi_communicator_t *comm_ptr;
+    mca_pml_ob1_comm_proc_t *proc;
+
+    if (OPAL_UNLIKELY(segments->seg_len < sizeof(mca_pml_ob1_credit_hdr_t))) {
+        return;
+    }
+
+    ob1_hdr_ntoh ((union mca_pml_ob1_hdr_t *) hdr, MCA_PML_OB1_HDR_TYPE_CREDIT);
+    comm_ptr = ompi_comm_lookup (hdr->hdr_ctx);
+    if (OPAL_UNLIKELY(NULL == comm_ptr || NULL == comm_ptr->c_pml_comm)) {
+        /* the communicator was released, its credits with it */
+        return;
+    }
+
+    proc = mca_pml_ob1_peer_lookup (comm_ptr, hdr->hdr_src);
+    (void) OPAL_THREAD_ADD_FETCH32(&proc->send_credits, (int32_t) hdr->hdr_credits);
+}
+
 
 
 #define PML_MAX_SEQ ~((mca_pml_sequence_t)0);
@@ -923,7 +1021,17 @@ static mca_pml_ob1_recv_request_t *match_one (mca_btl_base_module_t *btl,
         match = match_incomming(hdr, comm, proc);
 #else
         if (!OMPI_COMM_CHECK_ASSERT_NO_ANY_SOURCE (comm_ptr)) {
-            match = match_incomming(hdr, comm, proc);
+            /* With sharded peers only the shard lock of the source is held here.
+             * Wildcard receives are only appended with all the shard locks held,
+             * so an empty wild queue cannot change under us, otherwise the
+             * removal from the wild queue is serialized by the wildcard lock. */
+            if (NULL != comm->shard_locks && !opal_list_is_empty(&comm->wild_receives)) {
+                OB1_MATCHING_LOCK(&comm->matching_lock);
+                match = match_incomming(hdr, comm, proc);
+                OB1_MATCHING_UNLOCK(&comm->matching_lock);
+            } else {
+                match = match_incomming(hdr, comm, proc);
+            }
         } else {
             match = match_incomming_no_any_source (hdr, comm, proc);
         }
@@ -974,6 +1082,7 @@ static mca_pml_ob1_recv_request_t *match_one (mca_btl_base_module_t *btl,
         append_frag_to_list(&proc->unexpected_frags, btl, hdr, segments,
                             num_segments, frag);
 #endif
+        proc->unexpected_bytes += mca_pml_ob1_compute_segment_length_base (segments, num_segments, 0);
         SPC_RECORD(OMPI_SPC_UNEXPECTED, 1);
         SPC_RECORD(OMPI_SPC_UNEXPECTED_IN_QUEUE, 1);
         SPC_UPDATE_WATERMARK(OMPI_SPC_MAX_UNEXPECTED_IN_QUEUE, OMPI_SPC_UNEXPECTED_IN_QUEUE);
@@ -1024,7 +1133,6 @@ static int mca_pml_ob1_recv_frag_match (mca_btl_base_module_t *btl,
     uint16_t frag_msg_seq;
     uint16_t next_msg_seq_expected;
     ompi_communicator_t *comm_ptr;
-    mca_pml_ob1_comm_t *comm;
     mca_pml_ob1_comm_proc_t *proc;
 
     /* communicator pointer */
@@ -1041,8 +1149,6 @@ static int mca_pml_ob1_recv_frag_match (mca_btl_base_module_t *btl,
                              btl, hdr, segments, num_segments, NULL );
         return OMPI_SUCCESS;
     }
-    comm = (mca_pml_ob1_comm_t *)comm_ptr->c_pml_comm;
-
     /* source sequence number */
     proc = mca_pml_ob1_peer_lookup (comm_ptr, hdr->hdr_src);
 
@@ -1062,12 +1168,12 @@ static int mca_pml_ob1_recv_frag_match (mca_btl_base_module_t *btl,
      * end points) from being processed, and potentially "loosing"
      * the fragment.
      */
-    OB1_MATCHING_LOCK(&comm->matching_lock);
+    OB1_MATCHING_LOCK(proc->matching_lock);
 
 #if OPAL_ENABLE_FT_MPI
     if( OPAL_UNLIKELY((ompi_comm_is_revoked(comm_ptr) && !ompi_request_tag_is_ft(hdr->hdr_tag) )) ||
                       (ompi_comm_coll_revoked(comm_ptr) && ompi_request_tag_is_collective(hdr->hdr_tag)) ) {
-        OPAL_THREAD_UNLOCK(&comm->matching_lock);
+        OB1_MATCHING_UNLOCK(proc->matching_lock);
         if( MCA_PML_OB1_HDR_TYPE_MATCH != hdr->hdr_common.hdr_type ) {
             assert( MCA_PML_OB1_HDR_TYPE_RGET == hdr->hdr_common.hdr_type ||
                     MCA_PML_OB1_HDR_TYPE_RNDV == hdr->hdr_common.hdr_type );
@@ -1100,7 +1206,7 @@ static int mca_pml_ob1_recv_frag_match (mca_btl_base_module_t *btl,
             SPC_RECORD(OMPI_SPC_OOS_IN_QUEUE, 1);
             SPC_UPDATE_WATERMARK(OMPI_SPC_MAX_OOS_IN_QUEUE, OMPI_SPC_OOS_IN_QUEUE);
 
-            OB1_MATCHING_UNLOCK(&comm->matching_lock);
+            OB1_MATCHING_UNLOCK(proc->matching_lock);
             return OMPI_SUCCESS;
         }
     }
@@ -1116,8 +1222,8 @@ static int mca_pml_ob1_recv_frag_match (mca_btl_base_module_t *btl,
  * then try to match the next frag in sequence by looking into arrived
  * out of order frags in frags_cant_match list until it can't find one.
  *
- * ATTENTION: THIS FUNCTION MUST BE CALLED WITH COMMUNICATOR LOCK HELD.
- * THE LOCK WILL BE RELEASED UPON RETURN. USE WITH CARE. */
+ * ATTENTION: THIS FUNCTION MUST BE CALLED WITH THE MATCHING LOCK OF THE PROC
+ * HELD. THE LOCK WILL BE RELEASED UPON RETURN. USE WITH CARE. */
 static int
 mca_pml_ob1_recv_frag_match_proc (mca_btl_base_module_t *btl,
                                   ompi_communicator_t* comm_ptr,
@@ -1129,7 +1235,6 @@ mca_pml_ob1_recv_frag_match_proc (mca_btl_base_module_t *btl,
                                   mca_pml_ob1_recv_frag_t *frag)
 {
     /* local variables */
-    mca_pml_ob1_comm_t *comm = (mca_pml_ob1_comm_t *)comm_ptr->c_pml_comm;
     mca_pml_ob1_recv_request_t *match = NULL;
 
     /* If we are here, this is the sequence number we were expecting,
@@ -1161,7 +1266,7 @@ mca_pml_ob1_recv_frag_match_proc (mca_btl_base_module_t *btl,
                            hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
 
     /* release matching lock before processing fragment */
-    OB1_MATCHING_UNLOCK(&comm->matching_lock);
+    OB1_MATCHING_UNLOCK(proc->matching_lock);
 
     if(OPAL_LIKELY(match)) {
         switch(type) {
@@ -1186,7 +1291,7 @@ mca_pml_ob1_recv_frag_match_proc (mca_btl_base_module_t *btl,
      * may now be used to form new matchs
      */
     if(OPAL_UNLIKELY(NULL != proc->frags_cant_match)) {
-        OB1_MATCHING_LOCK(&comm->matching_lock);
+        OB1_MATCHING_LOCK(proc->matching_lock);
         if((frag = check_cantmatch_for_match(proc))) {
             hdr = &frag->hdr.hdr_match;
             segments = frag->segments;
@@ -1195,7 +1300,7 @@ mca_pml_ob1_recv_frag_match_proc (mca_btl_base_module_t *btl,
             type = hdr->hdr_common.hdr_type;
             goto match_this_frag;
         }
-        OB1_MATCHING_UNLOCK(&comm->matching_lock);
+        OB1_MATCHING_UNLOCK(proc->matching_lock);
     }
 
     return OMPI_SUCCESS;
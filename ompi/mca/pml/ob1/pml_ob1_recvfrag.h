@@ -159,6 +159,20 @@ extern void mca_pml_ob1_recv_frag_callback_put (mca_btl_base_module_t *btl,
 extern void mca_pml_ob1_recv_frag_callback_fin (mca_btl_base_module_t *btl,
                                                 const mca_btl_base_receive_descriptor_t *descriptor);
 
+/**
+ *  Callback from BTL on receipt of a recv_frag (coalesced).
+ */
+
+extern void mca_pml_ob1_recv_frag_callback_coalesced (mca_btl_base_module_t *btl,
+                                                      const mca_btl_base_receive_descriptor_t *descriptor);
+
+/**
+ *  Callback from BTL on receipt of a recv_frag (credit).
+ */
+
+extern void mca_pml_ob1_recv_frag_callback_credit (mca_btl_base_module_t *btl,
+                                                   const mca_btl_base_receive_descriptor_t *descriptor);
+
 /**
  * Extract the next fragment from the cant_match ordered list. This fragment
  * will be the next in sequence.
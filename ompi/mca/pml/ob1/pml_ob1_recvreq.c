@@ -36,6 +36,7 @@
 #include "ompi/mca/pml/pml.h"
 #include "ompi/mca/bml/bml.h"
 #include "pml_ob1_comm.h"
+#include "pml_ob1_flow_control.h"
 #include "pml_ob1_recvreq.h"
 #include "pml_ob1_recvfrag.h"
 #include "pml_ob1_sendreq.h"
@@ -96,16 +97,41 @@ static int mca_pml_ob1_recv_request_free(struct ompi_request_t** request)
     return OMPI_SUCCESS;
 }
 
+/* The matching state of a specific receive is protected by the matching lock
+ * of its peer, a wildcard receive needs the matching locks of all the peers. */
+static inline void recv_req_matching_lock(mca_pml_ob1_comm_t *ob1_comm, mca_pml_ob1_comm_proc_t *proc)
+{
+    if (NULL == proc) {
+        mca_pml_ob1_comm_lock_all(ob1_comm);
+    } else {
+        OB1_MATCHING_LOCK(proc->matching_lock);
+    }
+}
+
+static inline void recv_req_matching_unlock(mca_pml_ob1_comm_t *ob1_comm, mca_pml_ob1_comm_proc_t *proc)
+{
+    if (NULL == proc) {
+        mca_pml_ob1_comm_unlock_all(ob1_comm);
+    } else {
+        OB1_MATCHING_UNLOCK(proc->matching_lock);
+    }
+}
+
 static int mca_pml_ob1_recv_request_cancel(struct ompi_request_t* ompi_request, int complete)
 {
     mca_pml_ob1_recv_request_t* request = (mca_pml_ob1_recv_request_t*)ompi_request;
     ompi_communicator_t *comm = request->req_recv.req_base.req_comm;
     mca_pml_ob1_comm_t *ob1_comm = comm->c_pml_comm;
+    mca_pml_ob1_comm_proc_t* proc = NULL;
+
+    if( OMPI_ANY_SOURCE != request->req_recv.req_base.req_peer ) {
+        proc = mca_pml_ob1_peer_lookup (comm, request->req_recv.req_base.req_peer);
+    }
 
     /* The rest should be protected behind the match logic lock */
-    OB1_MATCHING_LOCK(&ob1_comm->matching_lock);
+    recv_req_matching_lock(ob1_comm, proc);
     if( REQUEST_COMPLETE(ompi_request) ) {
-        OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
+        recv_req_matching_unlock(ob1_comm, proc);
         return OMPI_SUCCESS;
     }
     if( !request->req_match_received ) { /* the match has not been already done */
@@ -116,13 +142,12 @@ static int mca_pml_ob1_recv_request_cancel(struct ompi_request_t* ompi_request,
         if( request->req_recv.req_base.req_peer == OMPI_ANY_SOURCE ) {
             opal_list_remove_item( &ob1_comm->wild_receives, (opal_list_item_t*)request );
         } else {
-            mca_pml_ob1_comm_proc_t* proc = mca_pml_ob1_peer_lookup (comm, request->req_recv.req_base.req_peer);
             opal_list_remove_item(&proc->specific_receives, (opal_list_item_t*)request);
         }
 #endif
         PERUSE_TRACE_COMM_EVENT( PERUSE_COMM_REQ_REMOVE_FROM_POSTED_Q,
                                 &(request->req_recv.req_base), PERUSE_RECV );
-        OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
+        recv_req_matching_unlock(ob1_comm, proc);
 #if OPAL_ENABLE_FT_MPI
         opal_output_verbose(10, ompi_ftmpi_output_handle,
                             "Recv_request_cancel: cancel granted for request %p because it has not matched\n",
@@ -130,7 +155,7 @@ static int mca_pml_ob1_recv_request_cancel(struct ompi_request_t* ompi_request,
 #endif
     }
     else { /* it has matched */
-        OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
+        recv_req_matching_unlock(ob1_comm, proc);
 #if OPAL_ENABLE_FT_MPI
         if( ompi_comm_is_proc_active( comm, request->req_recv.req_base.req_peer,
                                               OMPI_COMM_IS_INTER(comm) ) ) {
@@ -178,6 +203,7 @@ static void mca_pml_ob1_recv_request_construct(mca_pml_ob1_recv_request_t* reque
     request->req_recv.req_base.req_ompi.req_cancel = mca_pml_ob1_recv_request_cancel;
     request->req_rdma_cnt = 0;
     request->local_handle = NULL;
+    request->local_handle_length = 0;
     OBJ_CONSTRUCT(&request->lock, opal_mutex_t);
 }
 
@@ -223,6 +249,9 @@ static void mca_pml_ob1_put_completion (mca_pml_ob1_rdma_frag_t *frag, int64_t r
     OPAL_THREAD_ADD_FETCH32(&recvreq->req_pipeline_depth, -1);
 
     assert ((uint64_t) rdma_size == frag->rdma_length);
+    if (OPAL_LIKELY(0 < rdma_size)) {
+        MCA_PML_OB1_RDMA_FRAG_COMPLETED(frag, recvreq->req_recv.req_base.req_proc);
+    }
     MCA_PML_OB1_RDMA_FRAG_RETURN(frag);
 
     if (OPAL_LIKELY(0 < rdma_size)) {
@@ -421,6 +450,8 @@ static void mca_pml_ob1_rget_completion (mca_btl_base_module_t* btl, struct mca_
             OPAL_THREAD_ADD_FETCH_SIZE_T(&recvreq->req_bytes_received, skipped_bytes);
         }
     } else {
+        MCA_PML_OB1_RDMA_FRAG_COMPLETED(frag, recvreq->req_recv.req_base.req_proc);
+
         /* is receive request complete */
         OPAL_THREAD_ADD_FETCH_SIZE_T(&recvreq->req_bytes_received, frag->rdma_length);
         SPC_USER_OR_MPI(recvreq->req_recv.req_base.req_tag, (ompi_spc_value_t)frag->rdma_length,
@@ -527,6 +558,7 @@ int mca_pml_ob1_recv_request_get_frag (mca_pml_ob1_rdma_frag_t *frag)
                                  frag->rdma_length, PERUSE_RECV);
 
     /* queue up get request */
+    MCA_PML_OB1_RDMA_FRAG_START(frag);
     rc = mca_bml_base_get (bml_btl, frag->local_address, frag->remote_address, local_handle,
                            (mca_btl_base_registration_handle_t *) frag->remote_handle, frag->rdma_length,
                            0, MCA_BTL_NO_ORDER, mca_pml_ob1_rget_completion, frag);
@@ -743,12 +775,20 @@ void mca_pml_ob1_recv_request_progress_rget( mca_pml_ob1_recv_request_t* recvreq
 
     bytes_remaining = hdr->hdr_rndv.hdr_msg_length;
 
+    /* a restarted persistent request still holds the registration of its
+     * buffer, keep it if it covers the message on the same btl */
+    if (OPAL_UNLIKELY(NULL != recvreq->local_handle) &&
+        (recvreq->rdma_bml != rdma_bml || recvreq->local_handle_length < bytes_remaining)) {
+        mca_bml_base_deregister_mem (recvreq->rdma_bml, recvreq->local_handle);
+        recvreq->local_handle = NULL;
+    }
+
     /* save the request for put fallback */
     recvreq->remote_req_send = hdr->hdr_rndv.hdr_src_req;
     recvreq->rdma_bml = rdma_bml;
 
     /* try to register the entire buffer */
-    if (rdma_bml->btl->btl_register_mem) {
+    if (rdma_bml->btl->btl_register_mem && NULL == recvreq->local_handle) {
         void *data_ptr;
         uint32_t flags = MCA_BTL_REG_FLAG_LOCAL_WRITE | MCA_BTL_REG_FLAG_REMOTE_WRITE;
 #if OPAL_CUDA_GDR_SUPPORT
@@ -766,6 +806,7 @@ void mca_pml_ob1_recv_request_progress_rget( mca_pml_ob1_recv_request_t* recvreq
         OPAL_THREAD_UNLOCK(&recvreq->lock);
 
         mca_bml_base_register_mem (rdma_bml, data_ptr, bytes_remaining, flags, &recvreq->local_handle);
+        recvreq->local_handle_length = bytes_remaining;
         /* It is not an error if the memory region can not be registered here. The registration will
          * be attempted again for each get fragment. */
     }
@@ -954,6 +995,10 @@ void mca_pml_ob1_recv_request_progress_match( mca_pml_ob1_recv_request_t* recvre
     recvreq->req_bytes_received += bytes_received;
     SPC_USER_OR_MPI(recvreq->req_recv.req_base.req_ompi.req_status.MPI_TAG, (ompi_spc_value_t)bytes_received,
                     OMPI_SPC_BYTES_RECEIVED_USER, OMPI_SPC_BYTES_RECEIVED_MPI);
+    if (OPAL_UNLIKELY(mca_pml_ob1.flow_control)) {
+        mca_pml_ob1_flow_control_matched (recvreq->req_recv.req_base.req_comm, hdr->hdr_match.hdr_src,
+                                          bytes_received);
+    }
     recv_request_pml_complete(recvreq);
 }
 
@@ -1087,6 +1132,7 @@ int mca_pml_ob1_recv_request_schedule_once( mca_pml_ob1_recv_request_t* recvreq,
         frag->rdma_bml      = bml_btl;
         frag->local_address = data_ptr;
         frag->rdma_offset   = recvreq->req_rdma_offset;
+        MCA_PML_OB1_RDMA_FRAG_START(frag);
 
         rc = mca_pml_ob1_recv_request_put_frag (frag);
         if (OPAL_LIKELY(OMPI_SUCCESS == rc)) {
@@ -1261,7 +1307,7 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
 {
     ompi_communicator_t *comm = req->req_recv.req_base.req_comm;
     mca_pml_ob1_comm_t *ob1_comm = comm->c_pml_comm;
-    mca_pml_ob1_comm_proc_t* proc;
+    mca_pml_ob1_comm_proc_t *proc, *peer_proc = NULL;
     mca_pml_ob1_recv_frag_t* frag;
     mca_pml_ob1_hdr_t* hdr;
 #if MCA_PML_OB1_CUSTOM_MATCH
@@ -1284,7 +1330,11 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
 
     MCA_PML_BASE_RECV_START(&req->req_recv);
 
-    OB1_MATCHING_LOCK(&ob1_comm->matching_lock);
+    if(req->req_recv.req_base.req_peer != OMPI_ANY_SOURCE) {
+        peer_proc = mca_pml_ob1_peer_lookup (comm, req->req_recv.req_base.req_peer);
+    }
+
+    recv_req_matching_lock(ob1_comm, peer_proc);
     /**
      * The laps of time between the ACTIVATE event and the SEARCH_UNEX one include
      * the cost of the request lock.
@@ -1292,8 +1342,9 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
     PERUSE_TRACE_COMM_EVENT(PERUSE_COMM_SEARCH_UNEX_Q_BEGIN,
                             &(req->req_recv.req_base), PERUSE_RECV);
 
-    /* assign sequence number */
-    req->req_recv.req_base.req_sequence = ob1_comm->recv_sequence++;
+    /* assign sequence number, atomically as the specific receives of
+     * different peer shards are posted concurrently */
+    req->req_recv.req_base.req_sequence = (uint32_t) OPAL_THREAD_FETCH_ADD32(&ob1_comm->recv_sequence, 1);
 
 #if OPAL_ENABLE_FT_MPI
     /* if the communicator is not in a good state (revoked or coll_revoked), do not
@@ -1309,7 +1360,7 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
             recv_request_pml_complete( req );
             PERUSE_TRACE_COMM_EVENT(PERUSE_COMM_SEARCH_UNEX_Q_END,
                                     &(req->req_recv.req_base), PERUSE_RECV);
-            OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
+            recv_req_matching_unlock(ob1_comm, peer_proc);
             return;
         }
     }
@@ -1336,7 +1387,7 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
         }
 #endif  /* !OPAL_ENABLE_HETEROGENEOUS_SUPPORT */
     } else {
-        proc = mca_pml_ob1_peer_lookup (comm, req->req_recv.req_base.req_peer);
+        proc = peer_proc;
         req->req_recv.req_base.req_proc = proc->ompi_proc;
 #if MCA_PML_OB1_CUSTOM_MATCH
         frag = recv_req_match_specific_proc(req, proc, &hold_prev, &hold_elem, &hold_index);
@@ -1363,7 +1414,7 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
             append_recv_req_to_queue(queue, req);
 #endif
         req->req_match_received = false;
-        OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
+        recv_req_matching_unlock(ob1_comm, peer_proc);
     } else {
         if(OPAL_LIKELY(!IS_PROB_REQ(req))) {
             PERUSE_TRACE_COMM_EVENT(PERUSE_COMM_REQ_MATCH_UNEX,
@@ -1385,8 +1436,9 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
             opal_list_remove_item(&proc->unexpected_frags,
                                   (opal_list_item_t*)frag);
 #endif
+            proc->unexpected_bytes -= frag->segments[0].seg_len;
             SPC_RECORD(OMPI_SPC_UNEXPECTED_IN_QUEUE, -1);
-            OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
+            recv_req_matching_unlock(ob1_comm, peer_proc);
 
             switch(hdr->hdr_common.hdr_type) {
             case MCA_PML_OB1_HDR_TYPE_MATCH:
@@ -1421,15 +1473,16 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
             opal_list_remove_item(&proc->unexpected_frags,
                                   (opal_list_item_t*)frag);
 #endif
+            proc->unexpected_bytes -= frag->segments[0].seg_len;
             SPC_RECORD(OMPI_SPC_UNEXPECTED_IN_QUEUE, -1);
-            OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
+            recv_req_matching_unlock(ob1_comm, peer_proc);
 
             req->req_recv.req_base.req_addr = frag;
             mca_pml_ob1_recv_request_matched_probe(req, frag->btl,
                                                    frag->segments, frag->num_segments);
 
         } else {
-            OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
+            recv_req_matching_unlock(ob1_comm, peer_proc);
             mca_pml_ob1_recv_request_matched_probe(req, frag->btl,
                                                    frag->segments, frag->num_segments);
         }
@@ -56,6 +56,7 @@ struct mca_pml_ob1_recv_request_t {
     opal_mutex_t lock;
     mca_bml_base_btl_t *rdma_bml;
     mca_btl_base_registration_handle_t *local_handle;
+    size_t local_handle_length;  /**< length of the buffer registered with local_handle */
     /** The size of this array is set from mca_pml_ob1.max_rdma_per_request */
     mca_pml_ob1_com_btl_t req_rdma[];
 };
@@ -196,7 +197,10 @@ recv_request_pml_complete(mca_pml_ob1_recv_request_t *recvreq)
                 recvreq->req_recv.req_base.req_ompi.req_status.MPI_ERROR =
                     MPI_ERR_TRUNCATE;
             }
-            if (OPAL_UNLIKELY(recvreq->local_handle)) {
+            /* a persistent request keeps the registration of its buffer for
+             * its next start, it is returned with the request */
+            if (OPAL_UNLIKELY(recvreq->local_handle) &&
+                !recvreq->req_recv.req_base.req_ompi.req_persistent) {
                 mca_bml_base_deregister_mem (recvreq->rdma_bml, recvreq->local_handle);
                 recvreq->local_handle = NULL;
             }
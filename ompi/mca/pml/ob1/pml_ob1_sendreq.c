@@ -175,6 +175,8 @@ static void mca_pml_ob1_send_request_construct(mca_pml_ob1_send_request_t* req)
     req->req_rdma_cnt = 0;
     req->req_throttle_sends = false;
     req->rdma_frag = NULL;
+    req->req_rndv_start = 0;
+    req->req_rndv_ack = 0;
     OBJ_CONSTRUCT(&req->req_send_ranges, opal_list_t);
     OBJ_CONSTRUCT(&req->req_send_range_lock, opal_mutex_t);
 }
@@ -191,6 +193,60 @@ OBJ_CLASS_INSTANCE( mca_pml_ob1_send_request_t,
                     mca_pml_ob1_send_request_construct,
                     mca_pml_ob1_send_request_destruct );
 
+/* lowest eager limit learned for a peer */
+#define MCA_PML_OB1_ADAPTIVE_EAGER_MIN 1024
+
+/**
+ * Completion of a rendezvous with pml_ob1_adaptive_eager: update the
+ * throughput observed with the peer, and derive its eager limit from the
+ * bandwidth-delay product of the rendezvous. Sending eagerly the messages
+ * shorter than the data the link carries during the handshake round trip
+ * saves the round trip, the rendezvous pays off for the larger ones. The
+ * product grows with the latency, and the BTL eager limit remains the
+ * upper bound: this only moves the cut-over down for the peers with a
+ * low latency or a low throughput, for which the handshake is cheap,
+ * while the peers with a high latency keep the BTL eager limit.
+ */
+void mca_pml_ob1_send_request_rndv_complete (mca_pml_ob1_send_request_t *sendreq)
+{
+    mca_pml_ob1_comm_proc_t *ob1_proc = mca_pml_ob1_peer_lookup (sendreq->req_send.req_base.req_comm,
+                                                                 sendreq->req_send.req_base.req_peer);
+    opal_timer_t now = opal_timer_base_get_usec ();
+    double elapsed, bandwidth, limit;
+
+    if (0 != sendreq->req_rndv_ack) {
+        elapsed = (double) (now - sendreq->req_rndv_ack);
+    } else {
+        /* RGET protocol, there is no ACK before the data transfer */
+        elapsed = (double) (now - sendreq->req_rndv_start) - ob1_proc->rndv_latency;
+    }
+    sendreq->req_rndv_start = 0;
+
+    if (OPAL_UNLIKELY(MPI_SUCCESS != sendreq->req_send.req_base.req_ompi.req_status.MPI_ERROR ||
+                      elapsed < 1.0)) {
+        return;
+    }
+
+    bandwidth = (double) sendreq->req_send.req_bytes_packed / elapsed;
+    if (0.0 == ob1_proc->rndv_bandwidth) {
+        ob1_proc->rndv_bandwidth = (float) bandwidth;
+    } else {
+        ob1_proc->rndv_bandwidth += (float) ((bandwidth - ob1_proc->rndv_bandwidth) / 8);
+    }
+
+    if (0.0 == ob1_proc->rndv_latency) {
+        return;
+    }
+
+    limit = mca_pml_ob1.adaptive_eager_scale * ob1_proc->rndv_latency * ob1_proc->rndv_bandwidth;
+    if (limit < MCA_PML_OB1_ADAPTIVE_EAGER_MIN) {
+        limit = MCA_PML_OB1_ADAPTIVE_EAGER_MIN;
+    } else if (limit > (double) UINT32_MAX) {
+        limit = (double) UINT32_MAX;
+    }
+    ob1_proc->eager_limit = (uint32_t) limit;
+}
+
 /**
  * Completion of a short message - nothing left to schedule.
  */
@@ -29,6 +29,7 @@
 #include "opal/mca/mpool/base/base.h"
 #include "ompi/mca/pml/base/pml_base_sendreq.h"
 #include "pml_ob1_comm.h"
+#include "pml_ob1_flow_control.h"
 #include "pml_ob1_hdr.h"
 #include "pml_ob1_rdma.h"
 #include "pml_ob1_rdmafrag.h"
@@ -57,6 +58,8 @@ struct mca_pml_ob1_send_request_t {
     opal_mutex_t req_send_range_lock;
     opal_list_t req_send_ranges;
     mca_pml_ob1_rdma_frag_t *rdma_frag;
+    opal_timer_t req_rndv_start;  /**< start of the rendezvous, when learning the eager limit */
+    opal_timer_t req_rndv_ack;    /**< arrival of the rendezvous ACK */
     /** The size of this array is set from mca_pml_ob1.max_rdma_per_request */
     mca_pml_ob1_com_btl_t req_rdma[];
 };
@@ -224,6 +227,9 @@ static inline void mca_pml_ob1_send_request_fini (mca_pml_ob1_send_request_t *se
                             sendreq->req_send.req_base.req_datatype);
      );
 
+    /* registrations kept by a persistent request */
+    mca_pml_ob1_free_rdma_resources(sendreq);
+
     /*  Let the base handle the reference counts */
     MCA_PML_BASE_SEND_REQUEST_FINI((&(sendreq)->req_send));
     assert( NULL == sendreq->rdma_frag );
@@ -250,17 +256,26 @@ static inline void mca_pml_ob1_send_request_fini (mca_pml_ob1_send_request_t *se
  * should only be an internal call to the PML.
  *
  */
+void mca_pml_ob1_send_request_rndv_complete(mca_pml_ob1_send_request_t *sendreq);
+
 static inline void
 send_request_pml_complete(mca_pml_ob1_send_request_t *sendreq)
 {
     if(false == sendreq->req_send.req_base.req_pml_complete) {
+        if (OPAL_UNLIKELY(0 != sendreq->req_rndv_start)) {
+            mca_pml_ob1_send_request_rndv_complete(sendreq);
+        }
+
         if(sendreq->req_send.req_bytes_packed > 0) {
             PERUSE_TRACE_COMM_EVENT( PERUSE_COMM_REQ_XFER_END,
                                      &(sendreq->req_send.req_base), PERUSE_SEND);
         }
 
-        /* return mpool resources */
-        mca_pml_ob1_free_rdma_resources(sendreq);
+        /* return mpool resources, a persistent request keeps them for its
+         * next start and returns them when it is freed */
+        if (!sendreq->req_send.req_base.req_ompi.req_persistent) {
+            mca_pml_ob1_free_rdma_resources(sendreq);
+        }
 
         if (sendreq->req_send.req_send_mode == MCA_PML_BASE_SEND_BUFFERED &&
             sendreq->req_send.req_addr != sendreq->req_send.req_base.req_addr) {
@@ -390,6 +405,8 @@ mca_pml_ob1_send_request_start_btl( mca_pml_ob1_send_request_t* sendreq,
     size_t size = sendreq->req_send.req_bytes_packed;
     mca_btl_base_module_t* btl = bml_btl->btl;
     size_t eager_limit = btl->btl_eager_limit - sizeof(mca_pml_ob1_hdr_t);
+    size_t rndv_size;
+    bool eager;
     int rc;
 
 #if OPAL_CUDA_GDR_SUPPORT
@@ -398,10 +415,40 @@ mca_pml_ob1_send_request_start_btl( mca_pml_ob1_send_request_t* sendreq,
     }
 #endif /* OPAL_CUDA_GDR_SUPPORT */
 
-    if( OPAL_LIKELY(size <= eager_limit) ) {
+    if (OPAL_UNLIKELY(mca_pml_ob1.adaptive_eager)) {
+        /* the BTL limit is the size of its buffers, the learned limit of the
+         * peer (its bandwidth-delay product) can only lower it */
+        mca_pml_ob1_comm_proc_t *ob1_proc = mca_pml_ob1_peer_lookup (sendreq->req_send.req_base.req_comm,
+                                                                     sendreq->req_send.req_base.req_peer);
+        if (0 != ob1_proc->eager_limit && ob1_proc->eager_limit < eager_limit) {
+            eager_limit = ob1_proc->eager_limit;
+        }
+        if (size > eager_limit) {
+            sendreq->req_rndv_start = opal_timer_base_get_usec ();
+        }
+    }
+
+    eager = size <= eager_limit;
+    rndv_size = eager_limit;
+    if(OPAL_UNLIKELY(btl->btl_rndv_eager_limit < eager_limit))
+        rndv_size = btl->btl_rndv_eager_limit;
+
+    if (OPAL_UNLIKELY(mca_pml_ob1.flow_control)) {
+        /* only the eager messages the receiver has credits for carry data
+         * before they are matched, the rendezvous go without */
+        if (eager && MCA_PML_BASE_SEND_SYNCHRONOUS != sendreq->req_send.req_send_mode) {
+            eager = mca_pml_ob1_flow_control_acquire (mca_pml_ob1_peer_lookup (sendreq->req_send.req_base.req_comm,
+                                                                               sendreq->req_send.req_base.req_peer),
+                                                      size);
+        }
+        rndv_size = 0;
+    }
+
+    if( OPAL_LIKELY(eager) ) {
         switch(sendreq->req_send.req_send_mode) {
         case MCA_PML_BASE_SEND_SYNCHRONOUS:
-            rc = mca_pml_ob1_send_request_start_rndv(sendreq, bml_btl, size, 0);
+            rc = mca_pml_ob1_send_request_start_rndv(sendreq, bml_btl,
+                                                     mca_pml_ob1.flow_control ? 0 : size, 0);
             break;
         case MCA_PML_BASE_SEND_BUFFERED:
             rc = mca_pml_ob1_send_request_start_copy(sendreq, bml_btl, size);
@@ -417,10 +464,14 @@ mca_pml_ob1_send_request_start_btl( mca_pml_ob1_send_request_t* sendreq,
             }
             break;
         }
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != rc && mca_pml_ob1.flow_control) &&
+            MCA_PML_BASE_SEND_SYNCHRONOUS != sendreq->req_send.req_send_mode) {
+            mca_pml_ob1_flow_control_release (mca_pml_ob1_peer_lookup (sendreq->req_send.req_base.req_comm,
+                                                                       sendreq->req_send.req_base.req_peer),
+                                              size);
+        }
     } else {
-        size = eager_limit;
-        if(OPAL_UNLIKELY(btl->btl_rndv_eager_limit < eager_limit))
-            size = btl->btl_rndv_eager_limit;
+        size = rndv_size;
         if(sendreq->req_send.req_send_mode == MCA_PML_BASE_SEND_BUFFERED) {
             rc = mca_pml_ob1_send_request_start_buffered(sendreq, bml_btl, size);
         } else if
@@ -428,11 +479,14 @@ mca_pml_ob1_send_request_start_btl( mca_pml_ob1_send_request_t* sendreq,
             unsigned char *base;
             opal_convertor_get_current_pointer( &sendreq->req_send.req_base.req_convertor, (void**)&base );
 
-            if( 0 != (sendreq->req_rdma_cnt = (uint32_t)mca_pml_ob1_rdma_btls(
-                                                                              sendreq->req_endpoint,
-                                                                              base,
-                                                                              sendreq->req_send.req_bytes_packed,
-                                                                              sendreq->req_rdma))) {
+            /* a restarted persistent request still holds the registrations of its buffer */
+            if( 0 == sendreq->req_rdma_cnt ) {
+                sendreq->req_rdma_cnt = (uint32_t)mca_pml_ob1_rdma_btls(sendreq->req_endpoint,
+                                                                        base,
+                                                                        sendreq->req_send.req_bytes_packed,
+                                                                        sendreq->req_rdma);
+            }
+            if( 0 != sendreq->req_rdma_cnt ) {
                 rc = mca_pml_ob1_send_request_start_rdma(sendreq, bml_btl,
                                                          sendreq->req_send.req_bytes_packed);
                 if( OPAL_UNLIKELY(OMPI_SUCCESS != rc) ) {
@@ -464,6 +518,8 @@ mca_pml_ob1_send_request_start_seq (mca_pml_ob1_send_request_t* sendreq, mca_bml
     sendreq->req_pipeline_depth = 0;
     sendreq->req_bytes_delivered = 0;
     sendreq->req_pending = MCA_PML_OB1_SEND_PENDING_NONE;
+    sendreq->req_rndv_start = 0;
+    sendreq->req_rndv_ack = 0;
     sendreq->req_send.req_base.req_sequence = seqn;
 
     MCA_PML_BASE_SEND_START( &sendreq->req_send );
@@ -26,6 +26,7 @@
 #include "pml_ob1.h"
 #include "pml_ob1_recvreq.h"
 #include "pml_ob1_sendreq.h"
+#include "pml_ob1_coalesce.h"
 
 
 int mca_pml_ob1_start(size_t count, ompi_request_t** requests)
@@ -83,19 +84,19 @@ int mca_pml_ob1_start(size_t count, ompi_request_t** requests)
 
                     sendreq = (mca_pml_ob1_send_request_t *) request;
                     requests[i] = request;
-                } else if (sendreq->req_send.req_bytes_packed != 0) {
-                    size_t offset = 0;
-                    /**
-                     * Reset the convertor in case we're dealing with the original
-                     * request, which when completed do not reset the convertor.
-                     */
-                    opal_convertor_set_position (&sendreq->req_send.req_base.req_convertor,
-                                                 &offset);
                 }
+                /* the convertor prepared by isend_init is rewound when the
+                 * request starts, and the registrations of the buffer are
+                 * kept from the previous start */
 
                 /* reset the completion flag */
                 pml_request->req_pml_complete = false;
 
+                if (OPAL_UNLIKELY(mca_pml_ob1.coalesce)) {
+                    mca_pml_ob1_coalesce_flush_peer (mca_pml_ob1_peer_lookup (pml_request->req_comm,
+                                                                              pml_request->req_peer));
+                }
+
                 MCA_PML_OB1_SEND_REQUEST_START(sendreq, rc);
                 if(rc != OMPI_SUCCESS)
                     return rc;
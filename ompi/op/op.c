@@ -26,6 +26,8 @@
 
 #include "ompi_config.h"
 
+#include <limits.h>
+
 #include "opal/class/opal_pointer_array.h"
 #include "opal/util/string_copy.h"
 
@@ -405,6 +407,181 @@ void ompi_op_set_java_callback(ompi_op_t *op, void *jnienv,
 }
 
 
+/*
+ * State shared while walking the description of a derived datatype.
+ * All buffers have the same layout, so a single displacement locates
+ * a block in each of them.
+ */
+typedef struct ompi_op_derived_walk_t {
+    ompi_op_t *op;
+    ompi_datatype_t *predef;   /**< the single predefined type */
+    int dtype_id;              /**< its index in the op function tables */
+    size_t predef_size;
+    ptrdiff_t predef_extent;
+    bool dense;                /**< predef_size == predef_extent */
+    const char *source1;
+    const char *source2;       /**< NULL for the 2 buffers variant */
+    char *target;
+    ptrdiff_t partial_disp;    /**< start of a partially walked element */
+    size_t partial_bytes;      /**< bytes of this element seen so far */
+} ompi_op_derived_walk_t;
+
+/*
+ * Apply the predefined kernel on count consecutive predefined elements.
+ */
+static inline void derived_reduce_block(ompi_op_derived_walk_t *walk,
+                                        ptrdiff_t disp, size_t count)
+{
+    ompi_op_t *op = walk->op;
+    int id = walk->dtype_id;
+
+    while (count > 0) {
+        int n = (count > INT_MAX) ? INT_MAX : (int) count;
+
+        if (NULL == walk->source2) {
+            op->o_func.intrinsic.fns[id](walk->source1 + disp, walk->target + disp,
+                                         &n, &walk->predef,
+                                         op->o_func.intrinsic.modules[id]);
+        } else {
+            op->o_3buff_intrinsic.fns[id](walk->source1 + disp, walk->source2 + disp,
+                                          walk->target + disp, &n, &walk->predef,
+                                          op->o_3buff_intrinsic.modules[id]);
+        }
+        disp += (ptrdiff_t) n * walk->predef_extent;
+        count -= n;
+    }
+}
+
+/*
+ * A contiguous block of len bytes. For dense predefined types this is
+ * a whole number of elements. The pair types with padding (such as
+ * MPI_DOUBLE_INT) are described as several blocks per element, which
+ * are gathered until the element is complete.
+ */
+static inline void derived_reduce_bytes(ompi_op_derived_walk_t *walk,
+                                        ptrdiff_t disp, size_t len)
+{
+    if (walk->dense) {
+        assert(0 == (len % walk->predef_size));
+        derived_reduce_block(walk, disp, len / walk->predef_size);
+        return;
+    }
+    if (0 == walk->partial_bytes) {
+        walk->partial_disp = disp;
+    }
+    walk->partial_bytes += len;
+    if (walk->partial_bytes >= walk->predef_size) {
+        assert(walk->partial_bytes == walk->predef_size);
+        derived_reduce_block(walk, walk->partial_disp, 1);
+        walk->partial_bytes = 0;
+    }
+}
+
+static void derived_reduce_elem(ompi_op_derived_walk_t *walk,
+                                const ddt_elem_desc_t *elem, ptrdiff_t base)
+{
+    size_t blen = elem->blocklen * opal_datatype_basicDatatypes[elem->common.type]->size;
+    ptrdiff_t disp = base + elem->disp;
+
+    if (walk->dense && (1 == elem->count || (ptrdiff_t) blen == elem->extent)) {
+        derived_reduce_bytes(walk, disp, elem->count * blen);
+        return;
+    }
+    if (!walk->dense && 0 == walk->partial_bytes && blen == walk->predef_size
+        && elem->extent == walk->predef_extent) {
+        /* a run of complete elements with their natural stride */
+        derived_reduce_block(walk, disp, elem->count);
+        return;
+    }
+    for (uint32_t i = 0; i < elem->count; ++i) {
+        derived_reduce_bytes(walk, disp, blen);
+        disp += elem->extent;
+    }
+}
+
+/*
+ * Walk the description up to the matching END_LOOP, reducing each
+ * contiguous block in place.
+ */
+static void derived_reduce_desc(ompi_op_derived_walk_t *walk,
+                                const dt_elem_desc_t *elem, ptrdiff_t base)
+{
+    while (OPAL_DATATYPE_END_LOOP != elem->elem.common.type) {
+        if (OPAL_DATATYPE_LOOP == elem->elem.common.type) {
+            const ddt_endloop_desc_t *end_loop = &(elem + elem->loop.items)->end_loop;
+
+            if (elem->loop.common.flags & OPAL_DATATYPE_FLAG_CONTIGUOUS) {
+                ptrdiff_t disp = base + end_loop->first_elem_disp;
+
+                if (walk->dense && (1 == elem->loop.loops ||
+                                    (ptrdiff_t) end_loop->size == elem->loop.extent)) {
+                    derived_reduce_bytes(walk, disp, elem->loop.loops * end_loop->size);
+                } else {
+                    for (uint32_t i = 0; i < elem->loop.loops; ++i) {
+                        derived_reduce_bytes(walk, disp, end_loop->size);
+                        disp += elem->loop.extent;
+                    }
+                }
+            } else {
+                for (uint32_t i = 0; i < elem->loop.loops; ++i) {
+                    derived_reduce_desc(walk, elem + 1, base + i * elem->loop.extent);
+                }
+            }
+            elem += elem->loop.items + 1;
+            continue;
+        }
+        derived_reduce_elem(walk, &elem->elem, base);
+        elem++;
+    }
+}
+
+void ompi_op_reduce_derived(ompi_op_t *op, const void *source1, const void *source2,
+                            void *target, size_t count, ompi_datatype_t *dtype)
+{
+    ompi_op_derived_walk_t walk;
+    const dt_type_desc_t *description;
+    ptrdiff_t lb, extent;
+    size_t size;
+
+    walk.op = op;
+    walk.predef = ompi_datatype_get_single_predefined_type_from_args(dtype);
+    assert(NULL != walk.predef);
+    walk.dtype_id = ompi_op_ddt_map[walk.predef->id];
+    ompi_datatype_type_size(walk.predef, &walk.predef_size);
+    ompi_datatype_type_extent(walk.predef, &walk.predef_extent);
+    walk.dense = ((ptrdiff_t) walk.predef_size == walk.predef_extent);
+    walk.source1 = (const char *) source1;
+    walk.source2 = (const char *) source2;
+    walk.target = (char *) target;
+    walk.partial_bytes = 0;
+
+    if (0 == count) {
+        return;
+    }
+
+    ompi_datatype_type_size(dtype, &size);
+    if (walk.dense && count <= INT32_MAX &&
+        ompi_datatype_is_contiguous_memory_layout(dtype, (int32_t) count)) {
+        /* a single block, starting at the true lower bound */
+        ompi_datatype_get_true_extent(dtype, &lb, &extent);
+        derived_reduce_block(&walk, lb, count * (size / walk.predef_size));
+        return;
+    }
+
+    /* The optimized description merges the adjacent blocks. The
+       committed datatypes always have one, the fallback is only
+       there for safety. */
+    description = &dtype->super.opt_desc;
+    if (NULL == description->desc) {
+        description = &dtype->super.desc;
+    }
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    for (size_t i = 0; i < count; ++i) {
+        derived_reduce_desc(&walk, description->desc, (ptrdiff_t) i * extent);
+    }
+}
+
+
 /**************************************************************************
  *
  * Static functions
@@ -373,6 +373,29 @@ ompi_op_t *ompi_op_create_user(bool commute,
 OMPI_DECLSPEC void ompi_op_set_java_callback(ompi_op_t *op,  void *jnienv,
                                              void *object, int baseType);
 
+/**
+ * Apply an intrinsic operation on a derived datatype.
+ *
+ * @param op The intrinsic operation (IN)
+ * @param source1 First input buffer (IN)
+ * @param source2 Second input buffer, or NULL (IN)
+ * @param target Output buffer (IN/OUT)
+ * @param count Number of datatype elements (IN)
+ * @param dtype Derived datatype made of a single predefined type (IN)
+ *
+ * The optimized description of the datatype is walked and the
+ * predefined kernel of the op is applied in place on each contiguous
+ * block, without packing the buffers. When source2 is NULL this
+ * computes target = op(source1, target), otherwise target =
+ * op(source1, source2).
+ *
+ * This is the back-end of ompi_op_reduce() and ompi_3buff_op_reduce()
+ * for non-predefined datatypes.
+ */
+OMPI_DECLSPEC void ompi_op_reduce_derived(ompi_op_t *op, const void *source1,
+                                          const void *source2, void *target,
+                                          size_t count, ompi_datatype_t *dtype);
+
 /**
  * Check to see if an op is intrinsic.
  *
@@ -460,7 +483,13 @@ static inline bool ompi_op_is_valid(ompi_op_t * op, ompi_datatype_t * ddt,
                 return false;
             }
         } else {
-            /* Non-intrinsic ddt on intrinsic op */
+            /* Derived ddt on intrinsic op: supported when it is made of
+               a single predefined type valid for this op */
+            ompi_datatype_t *predef = ompi_datatype_get_single_predefined_type_from_args(ddt);
+            if (NULL != predef && -1 != ompi_op_ddt_map[predef->id] &&
+                NULL != op->o_func.intrinsic.fns[ompi_op_ddt_map[predef->id]]) {
+                return true;
+            }
             if ('\0' != ddt->name[0]) {
                 (void) opal_asprintf(msg,
                                 "%s: the reduction operation %s is not defined for non-intrinsic datatypes (attempted with datatype named \"%s\")",
@@ -541,12 +570,11 @@ static inline void ompi_op_reduce(ompi_op_t * op, void *source,
     /* For intrinsics, we also pass the corresponding op module */
     if (0 != (op->o_flags & OMPI_OP_FLAGS_INTRINSIC)) {
         int dtype_id;
-        if (!ompi_datatype_is_predefined(dtype)) {
-            ompi_datatype_t *dt = ompi_datatype_get_single_predefined_type_from_args(dtype);
-            dtype_id = ompi_op_ddt_map[dt->id];
-        } else {
-            dtype_id = ompi_op_ddt_map[dtype->id];
+        if (OPAL_UNLIKELY(!ompi_datatype_is_predefined(dtype))) {
+            ompi_op_reduce_derived(op, source, NULL, target, count, dtype);
+            return;
         }
+        dtype_id = ompi_op_ddt_map[dtype->id];
         op->o_func.intrinsic.fns[dtype_id](source, target,
                                            &count, &dtype,
                                            op->o_func.intrinsic.modules[dtype_id]);
@@ -612,6 +640,10 @@ static inline void ompi_3buff_op_reduce(ompi_op_t * op, void *source1,
     tgt = target;
 
     if (OPAL_LIKELY(ompi_op_is_intrinsic (op))) {
+        if (OPAL_UNLIKELY(!ompi_datatype_is_predefined(dtype))) {
+            ompi_op_reduce_derived(op, src1, src2, tgt, count, dtype);
+            return;
+        }
         op->o_3buff_intrinsic.fns[ompi_op_ddt_map[dtype->id]](src1, src2,
                                                               tgt, &count,
                                                               &dtype,
@@ -29,6 +29,7 @@
 #include <stdio.h>
 
 #include "opal/prefetch.h"
+#include "opal/mca/threads/thread_pool.h"
 #include "opal/util/arch.h"
 #include "opal/util/output.h"
 
@@ -214,6 +215,11 @@ opal_convertor_t *opal_convertor_create(int32_t remote_arch, int32_t mode)
             *(MAX_DATA) = 0;                                                        \
             return 1; /* nothing to do */                                           \
         }                                                                           \
+        if (OPAL_UNLIKELY((CONVERTOR)->flags & CONVERTOR_RAW_CACHED)) {             \
+            /* opal_convertor_raw left the stack behind bConverted */               \
+            size_t __position = (CONVERTOR)->bConverted;                            \
+            opal_convertor_set_position_nocheck((CONVERTOR), &__position);          \
+        }                                                                           \
         (CONVERTOR)->checksum = OPAL_CSUM_ZERO;                                     \
         (CONVERTOR)->csum_ui1 = 0;                                                  \
         (CONVERTOR)->csum_ui2 = 0;                                                  \
@@ -281,6 +287,12 @@ int32_t opal_convertor_pack(opal_convertor_t *pConv, struct iovec *iov, uint32_t
         return 1;
     }
 
+    if (OPAL_UNLIKELY(opal_thread_pool_size > 0)) {
+        int32_t rc = opal_convertor_mt_advance(pConv, iov, out_size, max_data);
+        if (OPAL_ERR_NOT_SUPPORTED != rc) {
+            return rc;
+        }
+    }
     return pConv->fAdvance(pConv, iov, out_size, max_data);
 }
 
@@ -331,6 +343,12 @@ int32_t opal_convertor_unpack(opal_convertor_t *pConv, struct iovec *iov, uint32
         return 1;
     }
 
+    if (OPAL_UNLIKELY(opal_thread_pool_size > 0)) {
+        int32_t rc = opal_convertor_mt_advance(pConv, iov, out_size, max_data);
+        if (OPAL_ERR_NOT_SUPPORTED != rc) {
+            return rc;
+        }
+    }
     return pConv->fAdvance(pConv, iov, out_size, max_data);
 }
 
@@ -429,10 +447,14 @@ int32_t opal_convertor_set_position_nocheck(opal_convertor_t *convertor, size_t
      * the beginning.
      */
     if (OPAL_LIKELY(convertor->flags & OPAL_DATATYPE_FLAG_CONTIGUOUS)) {
+        convertor->flags &= ~CONVERTOR_RAW_CACHED;
         rc = opal_convertor_create_stack_with_pos_contig(convertor, (*position),
                                                          opal_datatype_local_sizes);
     } else {
-        if ((0 == (*position)) || ((*position) < convertor->bConverted)) {
+        /* opal_convertor_raw does not maintain the stack when it uses its cache */
+        if ((0 == (*position)) || ((*position) < convertor->bConverted)
+            || (convertor->flags & CONVERTOR_RAW_CACHED)) {
+            convertor->flags &= ~CONVERTOR_RAW_CACHED;
             rc = opal_convertor_create_stack_at_begining(convertor, opal_datatype_local_sizes);
             if (0 == (*position)) {
                 return rc;
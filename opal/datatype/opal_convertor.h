@@ -57,6 +57,7 @@ BEGIN_C_DECLS
 #define CONVERTOR_CUDA_UNIFIED    0x10000000
 #define CONVERTOR_HAS_REMOTE_SIZE 0x20000000
 #define CONVERTOR_SKIP_CUDA_INIT  0x40000000
+#define CONVERTOR_RAW_CACHED      0x80000000 /* the stack is behind bConverted */
 
 union dt_elem_desc;
 typedef struct opal_convertor_t opal_convertor_t;
@@ -302,9 +303,11 @@ static inline int32_t opal_convertor_set_position(opal_convertor_t *convertor, s
     }
 
     /*
-     * If the convertor is already at the correct position we are happy.
+     * If the convertor is already at the correct position we are happy, unless
+     * opal_convertor_raw left its stack behind.
      */
-    if (OPAL_LIKELY((*position) == convertor->bConverted))
+    if (OPAL_LIKELY((*position) == convertor->bConverted)
+        && !(convertor->flags & CONVERTOR_RAW_CACHED))
         return OPAL_SUCCESS;
 
     /* Remove the completed flag if it's already set */
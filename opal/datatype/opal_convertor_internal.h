@@ -48,6 +48,49 @@ opal_convertor_master_t *opal_convertor_find_or_create_master(uint32_t remote_ar
  */
 void opal_convertor_destroy_masters(void);
 
+/*
+ * Maximum number of (datatype, count) layouts cached by opal_convertor_raw,
+ * and maximum number of iovecs of a cached layout.
+ */
+extern int opal_convertor_raw_cache_entries;
+extern int opal_convertor_raw_cache_max_iovecs;
+
+/*
+ * Drop the cached layouts of a datatype, or all of them if pData is NULL.
+ */
+void opal_convertor_raw_cache_purge(const struct opal_datatype_t *pData);
+
+/*
+ * Size above which the pack and unpack of large non-contiguous buffers
+ * are split across the helper threads of the opal thread pool.
+ */
+extern size_t opal_datatype_mt_threshold;
+
+/*
+ * Convert the single iovec provided to opal_convertor_pack or
+ * opal_convertor_unpack with the helper threads. Return
+ * OPAL_ERR_NOT_SUPPORTED, without touching the convertor, when the
+ * conversion must go through the convertor's fAdvance instead.
+ */
+int32_t opal_convertor_mt_advance(opal_convertor_t *pConv, struct iovec *iov, uint32_t *out_size,
+                                  size_t *max_data);
+
+/*
+ * Byte swapping of count contiguous elements of size bytes, from and to
+ * can be the same buffer. opal_datatype_swap_simd limits the instruction
+ * set used for the elements of 2, 4, 8 and 16 bytes (-1 for the best one
+ * available), opal_datatype_swap_init detects what the processor supports.
+ */
+#define OPAL_DATATYPE_SWAP_SCALAR 0
+#define OPAL_DATATYPE_SWAP_SSSE3  1
+#define OPAL_DATATYPE_SWAP_AVX2   2
+#define OPAL_DATATYPE_SWAP_AVX512 3
+
+extern int opal_datatype_swap_simd;
+
+void opal_datatype_swap_init(void);
+void opal_datatype_swap_bytes(void *to, const void *from, size_t size, size_t count);
+
 END_C_DECLS
 
 #endif /* OPAL_CONVERTOR_INTERNAL_HAS_BEEN_INCLUDED */
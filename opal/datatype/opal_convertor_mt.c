@@ -0,0 +1,189 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * Pack and unpack of large non-contiguous buffers with the opal pool of
+ * helper threads.
+ *
+ * The packed representation of a buffer is split in byte ranges, one
+ * per thread. Each range gets its own clone of the convertor, moved to
+ * the beginning of the range with the position machinery, and is then
+ * converted independently of the others. The ranges never overlap in
+ * the packed buffer. When packing, the user buffer is only read, and a
+ * range may start in the middle of a predefined datatype. When
+ * unpacking, the ranges are moved back to predefined datatype
+ * boundaries, so that no two threads write the same element of the user
+ * buffer. The last range is converted by the original
+ * convertor, which therefore ends up in exactly the same state as if
+ * the whole buffer was converted in a single call.
+ *
+ * Conversions that find the pool busy, or buffers that are not
+ * eligible, go through the usual single threaded path.
+ */
+
+#include "opal_config.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "opal/class/opal_object.h"
+#include "opal/mca/threads/thread_pool.h"
+#include "opal/sys/atomic.h"
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/datatype/opal_convertor_internal.h"
+#include "opal/datatype/opal_datatype_internal.h"
+#include "opal/datatype/opal_datatype_prototypes.h"
+
+size_t opal_datatype_mt_threshold = 16 * 1024 * 1024;
+
+typedef struct {
+    opal_convertor_t *convertors; /* one clone per part but the last */
+    opal_convertor_t *last;       /* the original convertor */
+    unsigned char *iov_base;
+    size_t *bounds;               /* nparts + 1 positions in the packed stream */
+    int nparts;
+    int32_t rc;                   /* returned by the original convertor */
+    opal_atomic_int32_t errors;
+} convertor_mt_job_t;
+
+static void convertor_mt_run_part(void *arg, int part)
+{
+    convertor_mt_job_t *job = (convertor_mt_job_t *) arg;
+    opal_convertor_t *conv = (part == job->nparts - 1) ? job->last : &job->convertors[part];
+    struct iovec iov;
+    uint32_t iov_count = 1;
+    size_t length = job->bounds[part + 1] - job->bounds[part];
+    int32_t rc;
+
+    iov.iov_base = (IOVBASE_TYPE *) (job->iov_base + (job->bounds[part] - job->bounds[0]));
+    iov.iov_len = length;
+    rc = conv->fAdvance(conv, &iov, &iov_count, &length);
+    if (rc < 0 || length != job->bounds[part + 1] - job->bounds[part]) {
+        (void) opal_atomic_add_fetch_32(&job->errors, 1);
+    }
+    if (conv == job->last) {
+        job->rc = rc;
+    }
+}
+
+/*
+ * Move the convertor to position. A receive convertor stopping inside a
+ * predefined datatype is moved back to the beginning of it, a send
+ * convertor is left where it stopped.
+ */
+static size_t convertor_mt_position(opal_convertor_t *conv, size_t position)
+{
+    opal_convertor_set_position(conv, &position);
+    if (0 != conv->partial_length) {
+        position -= conv->partial_length;
+        opal_convertor_set_position(conv, &position);
+    }
+    return position;
+}
+
+static inline bool convertor_mt_eligible(const opal_convertor_t *pConv, const struct iovec *iov,
+                                         uint32_t out_size)
+{
+    if (1 != out_size || NULL == iov[0].iov_base) {
+        return false;
+    }
+    if (pConv->flags & (CONVERTOR_WITH_CHECKSUM | CONVERTOR_CUDA | CONVERTOR_CUDA_UNIFIED)) {
+        return false;
+    }
+    if (pConv->flags & CONVERTOR_SEND) {
+        return opal_generic_simple_pack == pConv->fAdvance;
+    }
+    return (opal_generic_simple_unpack == pConv->fAdvance) && (0 == pConv->partial_length);
+}
+
+int32_t opal_convertor_mt_advance(opal_convertor_t *pConv, struct iovec *iov, uint32_t *out_size,
+                                  size_t *max_data)
+{
+    convertor_mt_job_t job;
+    size_t start = pConv->bConverted, total, length;
+    int32_t rc;
+    int nparts, ncloned = 0;
+
+    if (!convertor_mt_eligible(pConv, iov, *out_size)) {
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+    total = pConv->local_size - start;
+    if (total > iov[0].iov_len) {
+        total = iov[0].iov_len;
+    }
+    nparts = opal_thread_pool_concurrency();
+    if (total < opal_datatype_mt_threshold || nparts < 2) {
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+
+    job.convertors = (opal_convertor_t *) malloc((nparts - 1) * sizeof(opal_convertor_t));
+    job.bounds = (size_t *) malloc((nparts + 1) * sizeof(size_t));
+    if (NULL == job.convertors || NULL == job.bounds) {
+        free(job.convertors);
+        free(job.bounds);
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+
+    /* Place the boundaries of the parts, each part but the last gets a
+     * clone of the convertor positioned at its beginning. */
+    job.last = pConv;
+    job.iov_base = (unsigned char *) iov[0].iov_base;
+    job.errors = 0;
+    job.rc = 0;
+    job.nparts = nparts;
+    job.bounds[0] = start;
+    job.bounds[nparts] = start + total;
+    for (ncloned = 0; ncloned < nparts - 1; ++ncloned) {
+        OBJ_CONSTRUCT(&job.convertors[ncloned], opal_convertor_t);
+        opal_convertor_clone(pConv, &job.convertors[ncloned], 1);
+        if (ncloned > 0) {
+            job.bounds[ncloned] = convertor_mt_position(&job.convertors[ncloned],
+                                                        start + (total / nparts) * ncloned);
+        }
+    }
+    job.bounds[nparts - 1] = start + (total / nparts) * (nparts - 1);
+    job.bounds[nparts - 1] = convertor_mt_position(pConv, job.bounds[nparts - 1]);
+    for (int i = 1; i <= nparts; ++i) {
+        if (job.bounds[i] <= job.bounds[i - 1]) {
+            /* the predefined datatypes are too large for this many parts */
+            goto serial;
+        }
+    }
+
+    if (OPAL_SUCCESS != opal_thread_pool_submit(convertor_mt_run_part, &job, nparts)) {
+        goto serial;
+    }
+    opal_thread_pool_wait();
+    if (0 == job.errors) {
+        iov[0].iov_len = total;
+        *max_data = total;
+        rc = job.rc;
+        goto release;
+    }
+
+serial:
+    /* Something went wrong (or could not be split), redo everything
+     * from the original position in a single piece. */
+    length = start;
+    opal_convertor_set_position(pConv, &length);
+    rc = pConv->fAdvance(pConv, iov, out_size, max_data);
+
+release:
+    for (int i = 0; i < ncloned; ++i) {
+        OBJ_DESTRUCT(&job.convertors[i]);
+    }
+    free(job.convertors);
+    free(job.bounds);
+    return rc;
+}
@@ -20,6 +20,8 @@
 
 #include "opal/datatype/opal_convertor_internal.h"
 #include "opal/datatype/opal_datatype_internal.h"
+#include "opal/class/opal_list.h"
+#include "opal/mca/threads/mutex.h"
 #include "opal_stdint.h"
 
 #if OPAL_ENABLE_DEBUG
@@ -61,8 +63,8 @@ static inline int opal_convertor_merge_iov(struct iovec *iov, uint32_t *iov_coun
  * conversion (i.e. no heterogeneity) is taken into account, and that all
  * length we're working on are local.
  */
-int32_t opal_convertor_raw(opal_convertor_t *pConvertor, struct iovec *iov, uint32_t *iov_count,
-                           size_t *length)
+static int32_t opal_convertor_raw_generate(opal_convertor_t *pConvertor, struct iovec *iov,
+                                           uint32_t *iov_count, size_t *length)
 {
     const opal_datatype_t *pData = pConvertor->pDesc;
     dt_stack_t *pStack; /* pointer to the position on the stack */
@@ -131,8 +133,7 @@ int32_t opal_convertor_raw(opal_convertor_t *pConvertor, struct iovec *iov, uint
         if (count_desc
             != ((size_t) current->count
                 * current->blocklen)) { /* Not the full element description */
-            if ((do_now = count_desc % current->blocklen)) {
-                do_now = current->blocklen - do_now; /* how much left in the block */
+            if ((do_now = count_desc % current->blocklen)) { /* how much left in the block */
                 source_base += current->disp;
                 blength = do_now * opal_datatype_basicDatatypes[current->common.type]->size;
                 OPAL_DATATYPE_SAFEGUARD_POINTER(source_base, blength, pConvertor->pBaseBuf,
@@ -280,3 +281,250 @@ complete_loop:
                     pConvertor->stack_pos, pStack->index, pStack->count, (long) pStack->disp););
     return 0;
 }
+
+/*
+ * Cache of the merged iovec lists of the recently used (datatype, count)
+ * pairs. The btl RDMA paths, the one-sided components and ompio call
+ * opal_convertor_raw over and over for the same datatypes, and walking
+ * large descriptions dominates the cost of these calls. The iovecs are
+ * stored relative to the base pointer of the convertor, so that they can
+ * be reused for any buffer. The least recently used entries are evicted
+ * first, and the entries of a datatype are dropped when it is destroyed.
+ * A miss generates the whole layout before returning the first iovecs,
+ * so the cache is disabled by default, and the contiguous datatypes,
+ * described by a single iovec, never go through it.
+ */
+int opal_convertor_raw_cache_entries = 0;
+int opal_convertor_raw_cache_max_iovecs = 16 * 1024;
+
+typedef struct {
+    opal_list_item_t super;
+    const opal_datatype_t *pData;
+    size_t count;
+    uint32_t used;    /**< number of iovecs, 0 if the layout is too large to be cached */
+    ptrdiff_t *disp;  /**< displacement of each iovec from the base pointer */
+    size_t *len;      /**< length of each iovec */
+    size_t *position; /**< bytes before each iovec, used + 1 entries */
+} opal_convertor_raw_cache_entry_t;
+
+static void raw_cache_entry_construct(opal_convertor_raw_cache_entry_t *entry)
+{
+    entry->pData = NULL;
+    entry->count = 0;
+    entry->used = 0;
+    entry->disp = NULL;
+    entry->len = NULL;
+    entry->position = NULL;
+}
+
+static void raw_cache_entry_destruct(opal_convertor_raw_cache_entry_t *entry)
+{
+    free(entry->disp);
+    free(entry->len);
+    free(entry->position);
+}
+
+static OBJ_CLASS_INSTANCE(opal_convertor_raw_cache_entry_t, opal_list_item_t,
+                          raw_cache_entry_construct, raw_cache_entry_destruct);
+
+static opal_mutex_t raw_cache_lock = OPAL_MUTEX_STATIC_INIT;
+static opal_list_t raw_cache_list;
+static bool raw_cache_initialized = false;
+
+#define RAW_CACHE_CHUNK 128
+
+/*
+ * Generate the entire layout of the convertor's datatype with a private
+ * convertor. A layout exceeding the cache limits gives an empty entry, which
+ * remembers not to try again.
+ */
+static opal_convertor_raw_cache_entry_t *raw_cache_build(const opal_convertor_t *pConvertor)
+{
+    opal_convertor_raw_cache_entry_t *entry = OBJ_NEW(opal_convertor_raw_cache_entry_t);
+    size_t position = 0, allocated = 0;
+    struct iovec iov[RAW_CACHE_CHUNK];
+    opal_convertor_t convertor;
+    int32_t done = 0;
+
+    entry->pData = pConvertor->pDesc;
+    entry->count = pConvertor->count;
+
+    OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+    opal_convertor_clone(pConvertor, &convertor, 0);
+    convertor.flags &= ~CONVERTOR_RAW_CACHED;
+    opal_convertor_set_position(&convertor, &position);
+
+    while (!done) {
+        uint32_t iov_count = RAW_CACHE_CHUNK;
+        size_t length;
+
+        done = opal_convertor_raw_generate(&convertor, iov, &iov_count, &length);
+        if (entry->used + iov_count > (uint32_t) opal_convertor_raw_cache_max_iovecs) {
+            goto too_large;
+        }
+        if (entry->used + iov_count > allocated) {
+            allocated = (0 == allocated) ? RAW_CACHE_CHUNK : 2 * allocated;
+            if (allocated > (size_t) opal_convertor_raw_cache_max_iovecs) {
+                allocated = opal_convertor_raw_cache_max_iovecs;
+            }
+            entry->disp = (ptrdiff_t *) realloc(entry->disp, allocated * sizeof(ptrdiff_t));
+            entry->len = (size_t *) realloc(entry->len, allocated * sizeof(size_t));
+            entry->position = (size_t *) realloc(entry->position,
+                                                 (allocated + 1) * sizeof(size_t));
+            if (NULL == entry->disp || NULL == entry->len || NULL == entry->position) {
+                goto too_large;
+            }
+        }
+        for (uint32_t i = 0; i < iov_count; i++, entry->used++) {
+            entry->disp[entry->used] = (unsigned char *) iov[i].iov_base - convertor.pBaseBuf;
+            entry->len[entry->used] = iov[i].iov_len;
+            entry->position[entry->used] = position;
+            position += iov[i].iov_len;
+        }
+    }
+    entry->position[entry->used] = position;
+    OBJ_DESTRUCT(&convertor);
+    return entry;
+
+too_large:
+    free(entry->disp);
+    free(entry->len);
+    free(entry->position);
+    entry->disp = NULL;
+    entry->len = NULL;
+    entry->position = NULL;
+    entry->used = 0;
+    OBJ_DESTRUCT(&convertor);
+    return entry;
+}
+
+/*
+ * Find the entry of the convertor's datatype, building it on a miss. The
+ * returned entry is retained and should be released by the caller.
+ */
+static opal_convertor_raw_cache_entry_t *raw_cache_lookup(const opal_convertor_t *pConvertor)
+{
+    opal_convertor_raw_cache_entry_t *entry, *built;
+
+    OPAL_THREAD_LOCK(&raw_cache_lock);
+    if (!raw_cache_initialized) {
+        OBJ_CONSTRUCT(&raw_cache_list, opal_list_t);
+        raw_cache_initialized = true;
+    }
+    OPAL_LIST_FOREACH (entry, &raw_cache_list, opal_convertor_raw_cache_entry_t) {
+        if (entry->pData == pConvertor->pDesc && entry->count == pConvertor->count) {
+            /* move it in front of the list */
+            opal_list_remove_item(&raw_cache_list, &entry->super);
+            opal_list_prepend(&raw_cache_list, &entry->super);
+            OBJ_RETAIN(entry);
+            OPAL_THREAD_UNLOCK(&raw_cache_lock);
+            return entry;
+        }
+    }
+    OPAL_THREAD_UNLOCK(&raw_cache_lock);
+
+    built = raw_cache_build(pConvertor);
+
+    OPAL_THREAD_LOCK(&raw_cache_lock);
+    /* another thread might have inserted the same entry meanwhile */
+    OPAL_LIST_FOREACH (entry, &raw_cache_list, opal_convertor_raw_cache_entry_t) {
+        if (entry->pData == pConvertor->pDesc && entry->count == pConvertor->count) {
+            OBJ_RETAIN(entry);
+            OPAL_THREAD_UNLOCK(&raw_cache_lock);
+            OBJ_RELEASE(built);
+            return entry;
+        }
+    }
+    opal_list_prepend(&raw_cache_list, &built->super);
+    OBJ_RETAIN(built);
+    while (opal_list_get_size(&raw_cache_list) > (size_t) opal_convertor_raw_cache_entries) {
+        entry = (opal_convertor_raw_cache_entry_t *) opal_list_remove_last(&raw_cache_list);
+        OBJ_RELEASE(entry);
+    }
+    OPAL_THREAD_UNLOCK(&raw_cache_lock);
+    return built;
+}
+
+/*
+ * Fill the iovecs from the cached layout, starting at the current
+ * position of the convertor. The stack of the convertor is not updated,
+ * the CONVERTOR_RAW_CACHED flag tells set_position, pack and unpack to
+ * rebuild it.
+ */
+static int32_t raw_cache_fill(const opal_convertor_raw_cache_entry_t *entry,
+                              opal_convertor_t *pConvertor, struct iovec *iov,
+                              uint32_t *iov_count, size_t *length)
+{
+    size_t skip, sum_iov_len = 0;
+    uint32_t low = 0, high = entry->used - 1, index;
+
+    /* the last iovec starting at or before the current position */
+    while (low < high) {
+        uint32_t mid = low + (high - low + 1) / 2;
+        if (entry->position[mid] <= pConvertor->bConverted) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    skip = pConvertor->bConverted - entry->position[low];
+    for (index = 0; (index < *iov_count) && (low < entry->used); index++, low++) {
+        iov[index].iov_base = (IOVBASE_TYPE *) (pConvertor->pBaseBuf + entry->disp[low] + skip);
+        iov[index].iov_len = entry->len[low] - skip;
+        sum_iov_len += iov[index].iov_len;
+        skip = 0;
+    }
+    pConvertor->bConverted += sum_iov_len;
+    *length = sum_iov_len;
+    *iov_count = index;
+    if (pConvertor->bConverted == pConvertor->local_size) {
+        pConvertor->flags |= CONVERTOR_COMPLETED;
+        pConvertor->flags &= ~CONVERTOR_RAW_CACHED;
+        return 1;
+    }
+    pConvertor->flags |= CONVERTOR_RAW_CACHED;
+    return 0;
+}
+
+int32_t opal_convertor_raw(opal_convertor_t *pConvertor, struct iovec *iov, uint32_t *iov_count,
+                           size_t *length)
+{
+    assert((*iov_count) > 0);
+    if ((opal_convertor_raw_cache_entries > 0)
+        && !(pConvertor->flags & (CONVERTOR_COMPLETED | CONVERTOR_NO_OP))
+        && !(pConvertor->pDesc->flags & OPAL_DATATYPE_FLAG_CONTIGUOUS)) {
+        opal_convertor_raw_cache_entry_t *entry = raw_cache_lookup(pConvertor);
+        int32_t rc = -1;
+
+        if (0 != entry->used) {
+            rc = raw_cache_fill(entry, pConvertor, iov, iov_count, length);
+        }
+        OBJ_RELEASE(entry);
+        if (rc >= 0) {
+            return rc;
+        }
+    }
+    if (OPAL_UNLIKELY(pConvertor->flags & CONVERTOR_RAW_CACHED)) {
+        /* the previous calls were served from the cache, rebuild the stack */
+        size_t position = pConvertor->bConverted;
+        opal_convertor_set_position_nocheck(pConvertor, &position);
+    }
+    return opal_convertor_raw_generate(pConvertor, iov, iov_count, length);
+}
+
+void opal_convertor_raw_cache_purge(const opal_datatype_t *pData)
+{
+    opal_convertor_raw_cache_entry_t *entry, *next;
+
+    if (!raw_cache_initialized) {
+        return;
+    }
+    OPAL_THREAD_LOCK(&raw_cache_lock);
+    OPAL_LIST_FOREACH_SAFE (entry, next, &raw_cache_list, opal_convertor_raw_cache_entry_t) {
+        if ((NULL == pData) || (entry->pData == pData)) {
+            opal_list_remove_item(&raw_cache_list, &entry->super);
+            OBJ_RELEASE(entry);
+        }
+    }
+    OPAL_THREAD_UNLOCK(&raw_cache_lock);
+}
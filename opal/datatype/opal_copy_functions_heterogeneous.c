@@ -51,19 +51,14 @@ static inline void opal_dt_swap_bytes(void *to_p, const void *from_p, const size
     uint8_t *to = (uint8_t *) to_p;
     uint8_t *from = (uint8_t *) from_p;
 
-    /* Do the first element */
+    /* Arrays go through the vectorized kernels */
+    if (count > 1) {
+        opal_datatype_swap_bytes(to_p, from_p, size, count);
+        return;
+    }
     for (i = 0; i < size; i++, back_i--) {
         to[back_i] = from[i];
     }
-    /* Do all the others if any */
-    while (count > 1) {
-        to += size;
-        from += size;
-        count--;
-        for (i = 0, back_i = size - 1; i < size; i++, back_i--) {
-            to[back_i] = from[i];
-        }
-    }
 }
 
 #ifdef HAVE_IEEE754_H
@@ -140,10 +140,16 @@ struct opal_datatype_t {
                          all language interfaces (because Fortran is not known at the OPAL
                          layer). This field should never be initialized in homogeneous
                          environments */
-    /* --- cacheline 5 boundary (320 bytes) was 32-36 bytes ago --- */
-
-    /* size: 352, cachelines: 6, members: 15 */
-    /* last cacheline: 28-32 bytes */
+    struct opal_datatype_position_index_t *pos_index; /**< cumulative packed sizes of the top
+                                                           level elements of opt_desc, used to
+                                                           position the convertors (NULL if the
+                                                           description is too short to need it) */
+    struct opal_datatype_opt_cache_entry_t *opt_cache; /**< the cache entry owning opt_desc and
+                                                            pos_index, NULL if they are private */
+    /* --- cacheline 5 boundary (320 bytes) was 40-44 bytes ago --- */
+
+    /* size: 368, cachelines: 6, members: 17 */
+    /* last cacheline: 44-48 bytes */
 };
 
 typedef struct opal_datatype_t opal_datatype_t;
@@ -197,6 +203,12 @@ OPAL_DECLSPEC int32_t opal_datatype_init(void);
 OPAL_DECLSPEC opal_datatype_t *opal_datatype_create(int32_t expectedSize);
 OPAL_DECLSPEC int32_t opal_datatype_create_desc(opal_datatype_t *datatype, int32_t expectedSize);
 OPAL_DECLSPEC int32_t opal_datatype_commit(opal_datatype_t *pData);
+/*
+ * Give a committed datatype its own copy of the optimized description,
+ * if it shares one with other datatypes. Required before moving the
+ * description to another datatype.
+ */
+OPAL_DECLSPEC int32_t opal_datatype_unshare_opt_desc(opal_datatype_t *pData);
 OPAL_DECLSPEC int32_t opal_datatype_destroy(opal_datatype_t **);
 OPAL_DECLSPEC int32_t opal_datatype_is_monotonic(opal_datatype_t *type);
 
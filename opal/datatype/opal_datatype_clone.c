@@ -44,6 +44,8 @@ int32_t opal_datatype_clone(const opal_datatype_t *src_type, opal_datatype_t *de
 
     dest_type->flags &= (~OPAL_DATATYPE_FLAG_PREDEFINED);
     dest_type->ptypes = NULL;
+    dest_type->pos_index = NULL;
+    dest_type->opt_cache = NULL;
     dest_type->desc.desc = temp;
 
     /**
@@ -54,6 +56,11 @@ int32_t opal_datatype_clone(const opal_datatype_t *src_type, opal_datatype_t *de
         if (0 != src_type->opt_desc.used) {
             if (src_type->opt_desc.desc == src_type->desc.desc) {
                 dest_type->opt_desc = dest_type->desc;
+            } else if (NULL != src_type->opt_cache) {
+                /* the optimized description is shared, and so is the position index */
+                dest_type->opt_cache = src_type->opt_cache;
+                opal_datatype_opt_cache_retain(dest_type);
+                dest_type->pos_index = src_type->pos_index;
             } else {
                 desc_length = dest_type->opt_desc.used + 1;
                 dest_type->opt_desc.desc = (dt_elem_desc_t *) malloc(desc_length
@@ -73,5 +80,8 @@ int32_t opal_datatype_clone(const opal_datatype_t *src_type, opal_datatype_t *de
     }
     dest_type->id = src_type->id; /* preserve the default id. This allow us to
                                    * copy predefined types. */
+    if ((NULL != src_type->pos_index) && (NULL == dest_type->opt_cache)) {
+        (void) opal_datatype_build_position_index(dest_type);
+    }
     return OPAL_SUCCESS;
 }
@@ -26,6 +26,7 @@
 
 #include "limits.h"
 #include "opal/constants.h"
+#include "opal/datatype/opal_convertor_internal.h"
 #include "opal/datatype/opal_datatype.h"
 #include "opal/datatype/opal_datatype_internal.h"
 #include "opal/prefetch.h"
@@ -54,6 +55,8 @@ static void opal_datatype_construct(opal_datatype_t *pData)
     pData->opt_desc.used = 0;
 
     pData->ptypes = NULL;
+    pData->pos_index = NULL;
+    pData->opt_cache = NULL;
     pData->loops = 0;
 }
 
@@ -62,7 +65,12 @@ static void opal_datatype_destruct(opal_datatype_t *datatype)
     /**
      * As the default description and the optimized description might point to the
      * same data description we should start by cleaning the optimized description.
+     * A shared optimized description, and its position index, are released with
+     * the last datatype using them.
      */
+    if (NULL != datatype->opt_cache) {
+        opal_datatype_opt_cache_release(datatype);
+    }
     if (NULL != datatype->opt_desc.desc) {
         if (datatype->opt_desc.desc != datatype->desc.desc) {
             free(datatype->opt_desc.desc);
@@ -85,6 +93,15 @@ static void opal_datatype_destruct(opal_datatype_t *datatype)
         datatype->ptypes = NULL;
     }
 
+    /* drop the layouts cached by opal_convertor_raw */
+    if (!opal_datatype_is_predefined(datatype)) {
+        opal_convertor_raw_cache_purge(datatype);
+    }
+    if (NULL != datatype->pos_index) {
+        free(datatype->pos_index);
+        datatype->pos_index = NULL;
+    }
+
     /* make sure the name is set to empty */
     datatype->name[0] = '\0';
 }
@@ -556,8 +556,18 @@ struct opal_datatype_t;
             }                                                                                     \
         }
 
+/* NBLOCKS blocks STRIDE bytes apart: the blocks in between the first and
+ * the last one are within the bounds if these two are */
+#    define OPAL_DATATYPE_SAFEGUARD_STRIDED(ACTPTR, LENGTH, STRIDE, NBLOCKS, INITPTR, PDATA, COUNT) \
+        {                                                                                          \
+            OPAL_DATATYPE_SAFEGUARD_POINTER((ACTPTR), (LENGTH), (INITPTR), (PDATA), (COUNT));      \
+            OPAL_DATATYPE_SAFEGUARD_POINTER((ACTPTR) + (STRIDE) * (ptrdiff_t) ((NBLOCKS) -1),      \
+                                            (LENGTH), (INITPTR), (PDATA), (COUNT));                \
+        }
+
 #else
 #    define OPAL_DATATYPE_SAFEGUARD_POINTER(ACTPTR, LENGTH, INITPTR, PDATA, COUNT)
+#    define OPAL_DATATYPE_SAFEGUARD_STRIDED(ACTPTR, LENGTH, STRIDE, NBLOCKS, INITPTR, PDATA, COUNT)
 #endif /* OPAL_ENABLE_DEBUG */
 
 static inline int GET_FIRST_NON_LOOP(const union dt_elem_desc *_pElem)
@@ -583,6 +593,52 @@ static inline int GET_FIRST_NON_LOOP(const union dt_elem_desc *_pElem)
             (COUNTER) = (ELEMENT)->elem.count * (ELEMENT)->elem.blocklen; \
     } while (0)
 
+/*
+ * Index of the top level elements of the optimized description, with
+ * the number of packed bytes preceding each of them in a single
+ * instance of the datatype. It allows the position functions to jump
+ * directly to the element containing a given position instead of
+ * walking the whole description. It is only built for descriptions with
+ * at least OPAL_DATATYPE_POSITION_INDEX_MIN top level elements.
+ */
+#define OPAL_DATATYPE_POSITION_INDEX_MIN 64
+
+typedef struct {
+    size_t bytes;   /**< packed bytes before the element */
+    uint32_t index; /**< position of the element in the description */
+} opal_datatype_position_entry_t;
+
+struct opal_datatype_position_index_t {
+    const dt_elem_desc_t *desc; /**< the indexed description */
+    uint32_t used;              /**< number of entries */
+    opal_datatype_position_entry_t entries[];
+};
+typedef struct opal_datatype_position_index_t opal_datatype_position_index_t;
+
+int opal_datatype_build_position_index(struct opal_datatype_t *pData);
+
+/*
+ * Cache of the optimized descriptions, shared by the committed datatypes
+ * with identical descriptions. A datatype using a shared entry points to
+ * it with its opt_cache field, and its opt_desc and pos_index belong to
+ * the entry.
+ */
+extern bool opal_datatype_opt_cache_enabled;
+
+struct opal_datatype_opt_cache_entry_t {
+    uint64_t key;            /**< hash of the description */
+    uint32_t refcount;       /**< number of datatypes using the entry */
+    uint16_t flags;          /**< flags set on the datatypes by the optimization */
+    dt_type_desc_t desc;     /**< copy of the description, to check the hits */
+    dt_type_desc_t opt_desc; /**< the shared optimized description */
+    struct opal_datatype_position_index_t *pos_index;
+};
+typedef struct opal_datatype_opt_cache_entry_t opal_datatype_opt_cache_entry_t;
+
+void opal_datatype_opt_cache_retain(struct opal_datatype_t *pData);
+void opal_datatype_opt_cache_release(struct opal_datatype_t *pData);
+void opal_datatype_opt_cache_finalize(void);
+
 OPAL_DECLSPEC int opal_datatype_contain_basic_datatypes(const struct opal_datatype_t *pData,
                                                         char *ptr, size_t length);
 OPAL_DECLSPEC int opal_datatype_dump_data_flags(unsigned short usflags, char *ptr, size_t length);
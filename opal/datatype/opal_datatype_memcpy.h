@@ -14,6 +14,8 @@
 #ifndef OPAL_DATATYPE_MEMCPY_H_HAS_BEEN_INCLUDED
 #define OPAL_DATATYPE_MEMCPY_H_HAS_BEEN_INCLUDED
 
-#define MEMCPY(DST, SRC, BLENGTH) memcpy((DST), (SRC), (BLENGTH))
+#include "opal/mca/memcpy/base/base.h"
+
+#define MEMCPY(DST, SRC, BLENGTH) opal_memcpy((DST), (SRC), (BLENGTH))
 
 #endif /* OPAL_DATATYPE_MEMCPY_H_HAS_BEEN_INCLUDED */
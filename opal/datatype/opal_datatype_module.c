@@ -35,6 +35,7 @@
 #include "opal/datatype/opal_datatype.h"
 #include "opal/datatype/opal_datatype_internal.h"
 #include "opal/mca/base/mca_base_var.h"
+#include "opal/mca/threads/thread_pool.h"
 #include "opal/runtime/opal.h"
 #include "opal/util/arch.h"
 #include "opal/util/output.h"
@@ -171,9 +172,61 @@ OPAL_DECLSPEC const opal_datatype_t *opal_datatype_basicDatatypes[OPAL_DATATYPE_
 
 int opal_datatype_register_params(void)
 {
-#if OPAL_ENABLE_DEBUG
     int ret;
 
+    ret = mca_base_var_register(
+        "opal", "mpi", NULL, "ddt_pack_threshold",
+        "Size in bytes of the packed data above which a single pack or unpack is split across "
+        "the helper threads of the opal thread pool (default: 16MiB)",
+        MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_READONLY,
+        &opal_datatype_mt_threshold);
+    if (0 > ret) {
+        return ret;
+    }
+
+    ret = mca_base_var_register(
+        "opal", "mpi", NULL, "ddt_raw_cache_entries",
+        "Number of datatype layouts (iovec lists) kept by the raw convertor for the datatypes "
+        "used repeatedly, such as by the one-sided components and the file views. 0 disables "
+        "the cache (default: 0)",
+        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_READONLY,
+        &opal_convertor_raw_cache_entries);
+    if (0 > ret) {
+        return ret;
+    }
+
+    ret = mca_base_var_register(
+        "opal", "mpi", NULL, "ddt_raw_cache_max_iovecs",
+        "Maximum number of iovecs of a datatype layout kept by the raw convertor, larger "
+        "layouts are generated on each use (default: 16384)",
+        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_READONLY,
+        &opal_convertor_raw_cache_max_iovecs);
+    if (0 > ret) {
+        return ret;
+    }
+
+    ret = mca_base_var_register(
+        "opal", "mpi", NULL, "ddt_swap_simd",
+        "Highest instruction set used to swap the bytes of the data exchanged with a peer of "
+        "a different endianness or in the external32 representation: 0 none, 1 SSSE3, 2 AVX2, "
+        "3 AVX-512BW (default: -1, the best one supported by the processor)",
+        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_LOCAL,
+        &opal_datatype_swap_simd);
+    if (0 > ret) {
+        return ret;
+    }
+
+    ret = mca_base_var_register(
+        "opal", "mpi", NULL, "ddt_opt_cache",
+        "Whether the committed datatypes with identical descriptions share a single optimized "
+        "description (default: true)",
+        MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0, OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_READONLY,
+        &opal_datatype_opt_cache_enabled);
+    if (0 > ret) {
+        return ret;
+    }
+
+#if OPAL_ENABLE_DEBUG
     ret = mca_base_var_register(
         "opal", "mpi", NULL, "ddt_unpack_debug",
         "Whether to output debugging information in the ddt unpack functions (nonzero = enabled)",
@@ -254,6 +307,13 @@ static void opal_datatype_finalize(void)
     /* clear all master convertors */
     opal_convertor_destroy_masters();
 
+    opal_convertor_raw_cache_purge(NULL);
+
+    opal_datatype_opt_cache_finalize();
+
+    /* the pack/unpack helper threads are stopped with the last user of the pool */
+    opal_thread_pool_fini();
+
     opal_output_close(opal_datatype_dfd);
     opal_datatype_dfd = -1;
 }
@@ -289,12 +349,19 @@ int32_t opal_datatype_init(void)
         datatype->desc.desc[1].end_loop.size = datatype->size;
     }
 
+    /* Select the byte swapping kernels */
+    opal_datatype_swap_init();
+
     /* Enable a private output stream for datatype */
     if (opal_ddt_verbose > 0) {
         opal_datatype_dfd = opal_output_open(NULL);
         opal_output_set_verbosity(opal_datatype_dfd, opal_ddt_verbose);
     }
 
+    if (OPAL_SUCCESS != opal_thread_pool_init()) {
+        return OPAL_ERROR;
+    }
+
     opal_finalize_register_cleanup(opal_datatype_finalize);
 
     return OPAL_SUCCESS;
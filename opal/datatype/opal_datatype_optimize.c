@@ -26,9 +26,11 @@
 #include <stddef.h>
 #include <stdlib.h>
 
+#include "opal/class/opal_hash_table.h"
 #include "opal/datatype/opal_convertor.h"
 #include "opal/datatype/opal_datatype.h"
 #include "opal/datatype/opal_datatype_internal.h"
+#include "opal/mca/threads/mutex.h"
 
 static int32_t opal_datatype_optimize_short(opal_datatype_t *pData, size_t count,
                                             dt_type_desc_t *pTypeDesc)
@@ -288,6 +290,237 @@ static int32_t opal_datatype_optimize_short(opal_datatype_t *pData, size_t count
     return OPAL_SUCCESS;
 }
 
+/*
+ * Cache of the optimized descriptions. Applications and ompio file views
+ * often create and commit the same derived datatypes again and again, for
+ * instance at each timestep. The datatypes with identical descriptions
+ * share a single immutable optimized description, and its position index,
+ * instead of optimizing and storing their own. The entries are keyed by a
+ * hash of the description, a copy of which is kept to check the hits, and
+ * are released with the last datatype using them.
+ */
+bool opal_datatype_opt_cache_enabled = true;
+
+static opal_mutex_t opt_cache_lock = OPAL_MUTEX_STATIC_INIT;
+static opal_hash_table_t opt_cache_table;
+static bool opt_cache_initialized = false;
+
+#define OPT_CACHE_MIX(HASH, VALUE) (HASH) = ((HASH) ^ (uint64_t)(VALUE)) * 0x100000001b3ULL
+
+/* the unused fields of the loop markers are not part of the description */
+static uint64_t opt_cache_hash(const dt_elem_desc_t *desc, uint32_t nb_elems)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (uint32_t i = 0; i < nb_elems; i++) {
+        OPT_CACHE_MIX(hash, desc[i].elem.common.type);
+        OPT_CACHE_MIX(hash, desc[i].elem.common.flags);
+        if (OPAL_DATATYPE_LOOP == desc[i].elem.common.type) {
+            OPT_CACHE_MIX(hash, desc[i].loop.items);
+            OPT_CACHE_MIX(hash, desc[i].loop.loops);
+            OPT_CACHE_MIX(hash, desc[i].loop.extent);
+        } else if (OPAL_DATATYPE_END_LOOP == desc[i].elem.common.type) {
+            OPT_CACHE_MIX(hash, desc[i].end_loop.items);
+            OPT_CACHE_MIX(hash, desc[i].end_loop.size);
+            OPT_CACHE_MIX(hash, desc[i].end_loop.first_elem_disp);
+        } else {
+            OPT_CACHE_MIX(hash, desc[i].elem.count);
+            OPT_CACHE_MIX(hash, desc[i].elem.blocklen);
+            OPT_CACHE_MIX(hash, desc[i].elem.extent);
+            OPT_CACHE_MIX(hash, desc[i].elem.disp);
+        }
+    }
+    return hash;
+}
+
+static bool opt_cache_same_desc(const dt_elem_desc_t *a, const dt_elem_desc_t *b,
+                                uint32_t nb_elems)
+{
+    for (uint32_t i = 0; i < nb_elems; i++) {
+        if ((a[i].elem.common.type != b[i].elem.common.type)
+            || (a[i].elem.common.flags != b[i].elem.common.flags)) {
+            return false;
+        }
+        if (OPAL_DATATYPE_LOOP == a[i].elem.common.type) {
+            if ((a[i].loop.items != b[i].loop.items) || (a[i].loop.loops != b[i].loop.loops)
+                || (a[i].loop.extent != b[i].loop.extent)) {
+                return false;
+            }
+        } else if (OPAL_DATATYPE_END_LOOP == a[i].elem.common.type) {
+            if ((a[i].end_loop.items != b[i].end_loop.items)
+                || (a[i].end_loop.size != b[i].end_loop.size)
+                || (a[i].end_loop.first_elem_disp != b[i].end_loop.first_elem_disp)) {
+                return false;
+            }
+        } else if ((a[i].elem.count != b[i].elem.count) || (a[i].elem.blocklen != b[i].elem.blocklen)
+                   || (a[i].elem.extent != b[i].elem.extent) || (a[i].elem.disp != b[i].elem.disp)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void opt_cache_use_entry(opal_datatype_t *pData, opal_datatype_opt_cache_entry_t *entry)
+{
+    pData->opt_desc = entry->opt_desc;
+    pData->pos_index = entry->pos_index;
+    pData->flags |= entry->flags;
+    pData->opt_cache = entry;
+}
+
+/*
+ * Build the optimized description of the datatype, and the position index.
+ */
+static void opal_datatype_optimize_commit(opal_datatype_t *pData, ptrdiff_t first_elem_disp)
+{
+    ddt_endloop_desc_t *pLast;
+
+    (void) opal_datatype_optimize_short(pData, 1, &(pData->opt_desc));
+    if (0 != pData->opt_desc.used) {
+        /* let's add a fake element at the end just to avoid useless comparaisons
+         * in pack/unpack functions.
+         */
+        pLast = &(pData->opt_desc.desc[pData->opt_desc.used].end_loop);
+        pLast->common.type = OPAL_DATATYPE_END_LOOP;
+        pLast->common.flags = 0;
+        pLast->items = pData->opt_desc.used;
+        pLast->first_elem_disp = first_elem_disp;
+        pLast->size = pData->size;
+
+        (void) opal_datatype_build_position_index(pData);
+    }
+}
+
+/*
+ * Take the optimized description from the cache, or build it and make it
+ * available to the next datatypes with the same description.
+ */
+static void opal_datatype_cached_commit(opal_datatype_t *pData, ptrdiff_t first_elem_disp)
+{
+    uint32_t nb_elems = pData->desc.used + 1; /* with the fake END_LOOP */
+    uint64_t key = opt_cache_hash(pData->desc.desc, nb_elems);
+    opal_datatype_opt_cache_entry_t *entry = NULL;
+    void *value;
+
+    OPAL_THREAD_LOCK(&opt_cache_lock);
+    if (!opt_cache_initialized) {
+        OBJ_CONSTRUCT(&opt_cache_table, opal_hash_table_t);
+        opal_hash_table_init(&opt_cache_table, 256);
+        opt_cache_initialized = true;
+    }
+    if (OPAL_SUCCESS == opal_hash_table_get_value_uint64(&opt_cache_table, key, &value)) {
+        entry = (opal_datatype_opt_cache_entry_t *) value;
+        if ((entry->desc.used == pData->desc.used)
+            && opt_cache_same_desc(entry->desc.desc, pData->desc.desc, nb_elems)) {
+            entry->refcount++;
+            OPAL_THREAD_UNLOCK(&opt_cache_lock);
+            opt_cache_use_entry(pData, entry);
+            return;
+        }
+    }
+    OPAL_THREAD_UNLOCK(&opt_cache_lock);
+
+    opal_datatype_optimize_commit(pData, first_elem_disp);
+    if ((NULL != entry) || (0 == pData->opt_desc.used)) {
+        return; /* a different description with the same key keeps its own */
+    }
+
+    entry = (opal_datatype_opt_cache_entry_t *) malloc(sizeof(opal_datatype_opt_cache_entry_t));
+    if (NULL == entry) {
+        return;
+    }
+    entry->desc.desc = (dt_elem_desc_t *) malloc(nb_elems * sizeof(dt_elem_desc_t));
+    if (NULL == entry->desc.desc) {
+        free(entry);
+        return;
+    }
+    memcpy(entry->desc.desc, pData->desc.desc, nb_elems * sizeof(dt_elem_desc_t));
+    entry->desc.length = entry->desc.used = pData->desc.used;
+    entry->key = key;
+    entry->refcount = 1;
+    entry->flags = pData->flags & OPAL_DATATYPE_OPTIMIZED_RESTRICTED;
+    entry->opt_desc = pData->opt_desc;
+    entry->pos_index = pData->pos_index;
+
+    OPAL_THREAD_LOCK(&opt_cache_lock);
+    if (OPAL_SUCCESS == opal_hash_table_get_value_uint64(&opt_cache_table, key, &value)) {
+        /* inserted by another thread meanwhile, keep the private description */
+        OPAL_THREAD_UNLOCK(&opt_cache_lock);
+        free(entry->desc.desc);
+        free(entry);
+        return;
+    }
+    opal_hash_table_set_value_uint64(&opt_cache_table, key, entry);
+    OPAL_THREAD_UNLOCK(&opt_cache_lock);
+    pData->opt_cache = entry;
+}
+
+void opal_datatype_opt_cache_retain(opal_datatype_t *pData)
+{
+    OPAL_THREAD_LOCK(&opt_cache_lock);
+    pData->opt_cache->refcount++;
+    OPAL_THREAD_UNLOCK(&opt_cache_lock);
+}
+
+void opal_datatype_opt_cache_release(opal_datatype_t *pData)
+{
+    opal_datatype_opt_cache_entry_t *entry = pData->opt_cache;
+    bool last;
+
+    OPAL_THREAD_LOCK(&opt_cache_lock);
+    last = (0 == --entry->refcount);
+    if (last && opt_cache_initialized) {
+        opal_hash_table_remove_value_uint64(&opt_cache_table, entry->key);
+    }
+    OPAL_THREAD_UNLOCK(&opt_cache_lock);
+    if (last) {
+        free(entry->desc.desc);
+        free(entry->opt_desc.desc);
+        free(entry->pos_index);
+        free(entry);
+    }
+    pData->opt_desc.desc = NULL;
+    pData->opt_desc.length = 0;
+    pData->opt_desc.used = 0;
+    pData->pos_index = NULL;
+    pData->opt_cache = NULL;
+}
+
+/*
+ * The entries still in use belong to datatypes that were not released, they
+ * are freed when (and if) the last of them is.
+ */
+void opal_datatype_opt_cache_finalize(void)
+{
+    OPAL_THREAD_LOCK(&opt_cache_lock);
+    if (opt_cache_initialized) {
+        OBJ_DESTRUCT(&opt_cache_table);
+        opt_cache_initialized = false;
+    }
+    OPAL_THREAD_UNLOCK(&opt_cache_lock);
+}
+
+int32_t opal_datatype_unshare_opt_desc(opal_datatype_t *pData)
+{
+    dt_elem_desc_t *opt_desc;
+    uint32_t used;
+
+    if (NULL == pData->opt_cache) {
+        return OPAL_SUCCESS;
+    }
+    used = pData->opt_desc.used;
+    opt_desc = (dt_elem_desc_t *) malloc((used + 1) * sizeof(dt_elem_desc_t));
+    if (NULL == opt_desc) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    memcpy(opt_desc, pData->opt_desc.desc, (used + 1) * sizeof(dt_elem_desc_t));
+    opal_datatype_opt_cache_release(pData);
+    pData->opt_desc.desc = opt_desc;
+    pData->opt_desc.length = used;
+    pData->opt_desc.used = used;
+    return opal_datatype_build_position_index(pData);
+}
+
 int32_t opal_datatype_commit(opal_datatype_t *pData)
 {
     ddt_endloop_desc_t *pLast = &(pData->desc.desc[pData->desc.used].end_loop);
@@ -330,17 +563,10 @@ int32_t opal_datatype_commit(opal_datatype_t *pData)
     /* If the data is contiguous is useless to generate an optimized version. */
     /*if( pData->size == (pData->true_ub - pData->true_lb) ) return OPAL_SUCCESS; */
 
-    (void) opal_datatype_optimize_short(pData, 1, &(pData->opt_desc));
-    if (0 != pData->opt_desc.used) {
-        /* let's add a fake element at the end just to avoid useless comparaisons
-         * in pack/unpack functions.
-         */
-        pLast = &(pData->opt_desc.desc[pData->opt_desc.used].end_loop);
-        pLast->common.type = OPAL_DATATYPE_END_LOOP;
-        pLast->common.flags = 0;
-        pLast->items = pData->opt_desc.used;
-        pLast->first_elem_disp = first_elem_disp;
-        pLast->size = pData->size;
+    if (opal_datatype_opt_cache_enabled) {
+        opal_datatype_cached_commit(pData, first_elem_disp);
+    } else {
+        opal_datatype_optimize_commit(pData, first_elem_disp);
     }
     return OPAL_SUCCESS;
 }
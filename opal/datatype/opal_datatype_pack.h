@@ -20,6 +20,7 @@
 #define OPAL_DATATYPE_PACK_H_HAS_BEEN_INCLUDED
 
 #include "opal_config.h"
+#include "opal/datatype/opal_datatype_pack_unpack_blocks.h"
 #include "opal/datatype/opal_datatype_pack_unpack_predefined.h"
 
 #if !defined(CHECKSUM) && OPAL_CUDA_SUPPORT
@@ -104,6 +105,26 @@ static inline void pack_predefined_data(opal_convertor_t *CONVERTOR, const dt_el
     /* premptively update the number of COUNT we will return. */
     *(COUNT) -= cando_count;
 
+#if !defined(CHECKSUM)
+    if (!(CONVERTOR->flags & CONVERTOR_CUDA)
+        && opal_datatype_small_blocks_eligible(blocklen_bytes * _elem->blocklen, _elem->count)
+        && (_elem->blocklen <= cando_count)) {
+        size_t nblocks = cando_count / _elem->blocklen;
+        size_t block_bytes = blocklen_bytes * _elem->blocklen;
+
+        OPAL_DATATYPE_SAFEGUARD_STRIDED(_memory, block_bytes, _elem->extent, nblocks,
+                                        (CONVERTOR)->pBaseBuf, (CONVERTOR)->pDesc,
+                                        (CONVERTOR)->count);
+        if (OPAL_SUCCESS
+            == opal_datatype_small_blocks_copy(&_packed, block_bytes, &_memory, _elem->extent,
+                                               nblocks, block_bytes)) {
+            /* the epilog takes care of the leftover of the last block */
+            cando_count -= nblocks * _elem->blocklen;
+            goto do_epilog;
+        }
+    }
+#endif /* !defined(CHECKSUM) */
+
     if (_elem->blocklen < 9) {
         if ((!(CONVERTOR->flags & CONVERTOR_CUDA))
             && OPAL_LIKELY(
@@ -147,6 +168,9 @@ static inline void pack_predefined_data(opal_convertor_t *CONVERTOR, const dt_el
     /**
      * As an epilog do anything left from the last blocklen.
      */
+#if !defined(CHECKSUM)
+do_epilog:
+#endif /* !defined(CHECKSUM) */
     if (0 != cando_count) {
         assert((cando_count < _elem->blocklen)
                || ((1 == _elem->count) && (cando_count <= _elem->blocklen)));
@@ -178,6 +202,19 @@ static inline void pack_contiguous_loop(opal_convertor_t *CONVERTOR, const dt_el
 
     if ((_copy_loops * _end_loop->size) > *(SPACE))
         _copy_loops = (*(SPACE) / _end_loop->size);
+#if !defined(CHECKSUM)
+    if (!(CONVERTOR->flags & CONVERTOR_CUDA)
+        && opal_datatype_small_blocks_eligible(_end_loop->size, _copy_loops)) {
+        OPAL_DATATYPE_SAFEGUARD_STRIDED(_memory, _end_loop->size, _loop->extent, _copy_loops,
+                                        (CONVERTOR)->pBaseBuf, (CONVERTOR)->pDesc,
+                                        (CONVERTOR)->count);
+        if (OPAL_SUCCESS
+            == opal_datatype_small_blocks_copy(packed, _end_loop->size, &_memory, _loop->extent,
+                                               _copy_loops, _end_loop->size)) {
+            goto update_and_return;
+        }
+    }
+#endif /* !defined(CHECKSUM) */
     for (size_t _i = 0; _i < _copy_loops; _i++) {
         OPAL_DATATYPE_SAFEGUARD_POINTER(_memory, _end_loop->size, (CONVERTOR)->pBaseBuf,
                                         (CONVERTOR)->pDesc, (CONVERTOR)->count);
@@ -188,6 +225,9 @@ static inline void pack_contiguous_loop(opal_convertor_t *CONVERTOR, const dt_el
         *(packed) += _end_loop->size;
         _memory += _loop->extent;
     }
+#if !defined(CHECKSUM)
+update_and_return:
+#endif /* !defined(CHECKSUM) */
     *(memory) = _memory - _end_loop->first_elem_disp;
     *(SPACE) -= _copy_loops * _end_loop->size;
     *(COUNT) -= _copy_loops;
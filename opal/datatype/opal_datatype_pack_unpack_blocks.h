@@ -0,0 +1,92 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef OPAL_DATATYPE_PACK_UNPACK_BLOCKS_H_HAS_BEEN_INCLUDED
+#define OPAL_DATATYPE_PACK_UNPACK_BLOCKS_H_HAS_BEEN_INCLUDED
+
+#include "opal_config.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "opal/constants.h"
+
+/*
+ * Strided copies of small blocks, such as the rows of a vector or of a
+ * subarray. Going through memcpy for each block of a few bytes is
+ * dominated by the call overhead, and the typed copies of
+ * opal_datatype_pack_unpack_predefined.h require aligned buffers. With
+ * a block size known at compile time the compiler turns each copy into
+ * a couple of unaligned vector loads and stores.
+ *
+ * The eligibility is checked once per element of the description (and
+ * not once per block), by the pack and unpack functions for the
+ * predefined elements and for the contiguous loops.
+ */
+#define OPAL_DATATYPE_SMALL_BLOCKS_MAX 64
+
+static inline bool opal_datatype_small_blocks_eligible(size_t block_bytes, size_t nblocks)
+{
+    return (nblocks > 1) && (0 != block_bytes) && (block_bytes <= OPAL_DATATYPE_SMALL_BLOCKS_MAX)
+           && (0 == (block_bytes & 3));
+}
+
+#define OPAL_DATATYPE_SMALL_BLOCKS_CASE(BYTES) \
+    case BYTES:                                \
+        for (; nblocks > 0; nblocks--) {       \
+            memcpy(dst, src, BYTES);           \
+            dst += dst_stride;                 \
+            src += src_stride;                 \
+        }                                      \
+        break
+
+/**
+ * Copy nblocks blocks of block_bytes bytes, the consecutive blocks being
+ * dst_stride (respectively src_stride) bytes apart. Return OPAL_ERROR,
+ * without copying anything, if the block size is not supported.
+ */
+static inline int opal_datatype_small_blocks_copy(unsigned char **rtn_dst, ptrdiff_t dst_stride,
+                                                  unsigned char **rtn_src, ptrdiff_t src_stride,
+                                                  size_t nblocks, size_t block_bytes)
+{
+    unsigned char *dst = *rtn_dst;
+    const unsigned char *src = *rtn_src;
+
+    switch (block_bytes) {
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(4);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(8);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(12);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(16);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(20);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(24);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(28);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(32);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(36);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(40);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(44);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(48);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(52);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(56);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(60);
+        OPAL_DATATYPE_SMALL_BLOCKS_CASE(64);
+    default:
+        return OPAL_ERROR;
+    }
+    *rtn_dst = dst;
+    *rtn_src = (unsigned char *) src;
+    return OPAL_SUCCESS;
+}
+
+#undef OPAL_DATATYPE_SMALL_BLOCKS_CASE
+
+#endif /* OPAL_DATATYPE_PACK_UNPACK_BLOCKS_H_HAS_BEEN_INCLUDED */
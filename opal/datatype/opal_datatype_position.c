@@ -155,6 +155,71 @@ update_and_return:
     *(POINTER) = _memory - _elem->disp;
 }
 
+/*
+ * Build the index of the top level elements of the optimized description.
+ * Shorter descriptions are walked quickly enough, they are not indexed.
+ */
+int opal_datatype_build_position_index(opal_datatype_t *pData)
+{
+    const dt_elem_desc_t *desc = pData->opt_desc.desc;
+    opal_datatype_position_index_t *index;
+    uint32_t pos, used = 0;
+    size_t bytes = 0;
+
+    if (NULL == desc) {
+        return OPAL_SUCCESS;
+    }
+    for (pos = 0; OPAL_DATATYPE_END_LOOP != desc[pos].elem.common.type; used++) {
+        pos += (OPAL_DATATYPE_LOOP == desc[pos].elem.common.type) ? desc[pos].loop.items + 1 : 1;
+    }
+    if (used < OPAL_DATATYPE_POSITION_INDEX_MIN) {
+        return OPAL_SUCCESS;
+    }
+
+    index = (opal_datatype_position_index_t *) malloc(sizeof(opal_datatype_position_index_t)
+                                                      + used * sizeof(opal_datatype_position_entry_t));
+    if (NULL == index) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    index->desc = desc;
+    index->used = used;
+    for (pos = 0, used = 0; OPAL_DATATYPE_END_LOOP != desc[pos].elem.common.type; used++) {
+        index->entries[used].bytes = bytes;
+        index->entries[used].index = pos;
+        if (OPAL_DATATYPE_LOOP == desc[pos].elem.common.type) {
+            const ddt_endloop_desc_t *end_loop = &desc[pos + desc[pos].loop.items].end_loop;
+            bytes += (size_t) desc[pos].loop.loops * end_loop->size;
+            pos += desc[pos].loop.items + 1;
+        } else {
+            bytes += (size_t) desc[pos].elem.count * desc[pos].elem.blocklen
+                     * opal_datatype_basicDatatypes[desc[pos].elem.common.type]->size;
+            pos++;
+        }
+    }
+    pData->pos_index = index;
+    return OPAL_SUCCESS;
+}
+
+/*
+ * Find the last top level element starting at or before the offset
+ * (in packed bytes) inside a single instance of the datatype.
+ */
+static inline const opal_datatype_position_entry_t *
+position_index_lookup(const opal_datatype_position_index_t *index, size_t offset)
+{
+    uint32_t low = 0, high = index->used - 1;
+
+    while (low < high) {
+        uint32_t mid = low + (high - low + 1) / 2;
+        if (index->entries[mid].bytes <= offset) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return &index->entries[low];
+}
+
 int opal_convertor_generic_simple_position(opal_convertor_t *pConvertor, size_t *position)
 {
     dt_stack_t *pStack; /* pointer to the position on the stack */
@@ -212,6 +277,29 @@ int opal_convertor_generic_simple_position(opal_convertor_t *pConvertor, size_t
                          (unsigned long long) (base_pointer - pConvertor->pBaseBuf),
                          pConvertor->stack_pos, pStack->index, pStack->count,
                          (unsigned long long) pStack->disp););
+    /* On the top level of a datatype with an index, skip directly to the
+     * element containing the position. The elements of the top level are
+     * relative to the beginning of the current instance of the datatype.
+     */
+    if ((NULL != pConvertor->pDesc->pos_index) && (0 == pConvertor->stack_pos)
+        && (0 == pConvertor->partial_length)
+        && (pConvertor->pDesc->pos_index->desc == description)
+        && (OPAL_DATATYPE_END_LOOP != pElem->elem.common.type)) {
+        size_t offset = pConvertor->bConverted % pConvertor->pDesc->size;
+        if ((offset + iov_len_local) < pConvertor->pDesc->size) {
+            const opal_datatype_position_entry_t *entry
+                = position_index_lookup(pConvertor->pDesc->pos_index, offset + iov_len_local);
+            if (entry->index > pos_desc) {
+                DO_DEBUG(opal_output(0, "position index jump from pos_desc %d to %d (%" PRIsize_t
+                                        " bytes)\n",
+                                     pos_desc, entry->index, entry->bytes - offset););
+                iov_len_local -= entry->bytes - offset;
+                pos_desc = entry->index;
+                base_pointer = pConvertor->pBaseBuf + pStack->disp;
+                UPDATE_INTERNAL_COUNTERS(description, pos_desc, pElem, count_desc);
+            }
+        }
+    }
     /* Last data has been only partially converted. Compute the relative position */
     if (0 != pConvertor->partial_length) {
         size_t element_length = opal_datatype_basicDatatypes[pElem->elem.common.type]->size;
@@ -244,15 +332,27 @@ int opal_convertor_generic_simple_position(opal_convertor_t *pConvertor, size_t
                 pConvertor->stack_pos--;
                 pStack--;
                 pos_desc++;
+            } else if (pStack->index == -1) {
+                pStack->disp += extent;
+                pos_desc = 0; /* back to the first element */
             } else {
-                if (pStack->index == -1) {
-                    pStack->disp += extent;
-                    pos_desc = 0; /* back to the first element */
+                /* The loop is already on the stack, move forward by entire
+                 * loops here instead of going back to the loop start, which
+                 * would push it a second time.
+                 */
+                ddt_loop_desc_t *loop = &description[pStack->index].loop;
+                size_t full_loops = iov_len_local / pElem->end_loop.size;
+                assert(OPAL_DATATYPE_LOOP == loop->common.type);
+                if (full_loops >= pStack->count) { /* all the remaining loops fit */
+                    iov_len_local -= pStack->count * pElem->end_loop.size;
+                    pConvertor->stack_pos--;
+                    pStack--;
+                    pos_desc++;
                 } else {
-                    assert(OPAL_DATATYPE_LOOP == description[pStack->index].loop.common.type);
-                    pStack->disp += description[pStack->index].loop.extent;
-                    pos_desc = pStack->index; /* go back to the loop start itself to give a chance
-                                               * to move forward by entire loops */
+                    iov_len_local -= full_loops * pElem->end_loop.size;
+                    pStack->count -= full_loops;
+                    pStack->disp += (full_loops + 1) * loop->extent;
+                    pos_desc = pStack->index + 1;
                 }
             }
             base_pointer = pConvertor->pBaseBuf + pStack->disp;
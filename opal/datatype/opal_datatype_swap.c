@@ -0,0 +1,199 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor_internal.h"
+#include "opal/types.h"
+
+/*
+ * Byte swapping of arrays of predefined types, for external32 and for
+ * the peers with a different endianness. The elements of 2, 4, 8 and 16
+ * bytes are swapped with byte shuffles, several elements at once. All
+ * these sizes divide the 128 bits lanes of the shuffles, so the same
+ * in-lane mask serves the SSSE3, AVX2 and AVX-512BW kernels. The kernels
+ * are compiled with function target attributes and selected at runtime,
+ * so the library does not require any of these instruction sets.
+ */
+#if defined(__x86_64__) && !defined(__INTEL_COMPILER) && !defined(__PGI) \
+    && !defined(__NVCOMPILER) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ >= 5)))
+#    define OPAL_DATATYPE_SWAP_X86 1
+#    include <immintrin.h>
+#else
+#    define OPAL_DATATYPE_SWAP_X86 0
+#endif
+
+int opal_datatype_swap_simd = -1;
+
+/* the best level supported by the processor, set by opal_datatype_swap_init */
+static int opal_datatype_swap_hw_level = OPAL_DATATYPE_SWAP_SCALAR;
+
+static inline void swap_bytes_scalar(uint8_t *to, const uint8_t *from, size_t size, size_t count)
+{
+    size_t i, back_i;
+
+    switch (size) {
+    case 2:
+        for (; count > 0; count--, to += 2, from += 2) {
+            uint16_t val;
+            memcpy(&val, from, sizeof(uint16_t));
+            val = opal_swap_bytes2(val);
+            memcpy(to, &val, sizeof(uint16_t));
+        }
+        break;
+    case 4:
+        for (; count > 0; count--, to += 4, from += 4) {
+            uint32_t val;
+            memcpy(&val, from, sizeof(uint32_t));
+            val = opal_swap_bytes4(val);
+            memcpy(to, &val, sizeof(uint32_t));
+        }
+        break;
+    case 8:
+        for (; count > 0; count--, to += 8, from += 8) {
+            uint64_t val;
+            memcpy(&val, from, sizeof(uint64_t));
+            val = opal_swap_bytes8(val);
+            memcpy(to, &val, sizeof(uint64_t));
+        }
+        break;
+    case 16:
+        for (; count > 0; count--, to += 16, from += 16) {
+            uint64_t low, high;
+            memcpy(&low, from, sizeof(uint64_t));
+            memcpy(&high, from + 8, sizeof(uint64_t));
+            low = opal_swap_bytes8(low);
+            high = opal_swap_bytes8(high);
+            memcpy(to, &high, sizeof(uint64_t));
+            memcpy(to + 8, &low, sizeof(uint64_t));
+        }
+        break;
+    default: /* also correct in place */
+        for (; count > 0; count--, to += size, from += size) {
+            for (i = 0, back_i = size - 1; i < back_i; i++, back_i--) {
+                uint8_t first = from[i];
+                to[i] = from[back_i];
+                to[back_i] = first;
+            }
+            if (i == back_i) {
+                to[i] = from[i];
+            }
+        }
+    }
+}
+
+#if OPAL_DATATYPE_SWAP_X86
+/* reverse the bytes of each element of a 128 bits lane */
+static const uint8_t swap_masks[4][16] = {
+    {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14},
+    {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12},
+    {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8},
+    {15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0}};
+
+/* Each kernel swaps the largest multiple of its vector width and returns
+ * the number of bytes done, the caller completes the remaining elements. */
+__attribute__((target("ssse3"))) static size_t swap_bytes_ssse3(uint8_t *to, const uint8_t *from,
+                                                                 size_t length, const uint8_t *mask)
+{
+    const __m128i shuffle = _mm_loadu_si128((const __m128i *) mask);
+    size_t done;
+
+    for (done = 0; (done + 16) <= length; done += 16) {
+        __m128i data = _mm_loadu_si128((const __m128i *) (from + done));
+        _mm_storeu_si128((__m128i *) (to + done), _mm_shuffle_epi8(data, shuffle));
+    }
+    return done;
+}
+
+__attribute__((target("avx2"))) static size_t swap_bytes_avx2(uint8_t *to, const uint8_t *from,
+                                                              size_t length, const uint8_t *mask)
+{
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) mask));
+    size_t done = 0;
+
+    for (; (done + 64) <= length; done += 64) {
+        __m256i data0 = _mm256_loadu_si256((const __m256i *) (from + done));
+        __m256i data1 = _mm256_loadu_si256((const __m256i *) (from + done + 32));
+        _mm256_storeu_si256((__m256i *) (to + done), _mm256_shuffle_epi8(data0, shuffle));
+        _mm256_storeu_si256((__m256i *) (to + done + 32), _mm256_shuffle_epi8(data1, shuffle));
+    }
+    for (; (done + 32) <= length; done += 32) {
+        __m256i data = _mm256_loadu_si256((const __m256i *) (from + done));
+        _mm256_storeu_si256((__m256i *) (to + done), _mm256_shuffle_epi8(data, shuffle));
+    }
+    return done;
+}
+
+__attribute__((target("avx512f,avx512bw"))) static size_t
+swap_bytes_avx512(uint8_t *to, const uint8_t *from, size_t length, const uint8_t *mask)
+{
+    const __m512i shuffle = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *) mask));
+    size_t done = 0;
+
+    for (; (done + 64) <= length; done += 64) {
+        __m512i data = _mm512_loadu_si512((const void *) (from + done));
+        _mm512_storeu_si512((void *) (to + done), _mm512_shuffle_epi8(data, shuffle));
+    }
+    return done;
+}
+#endif /* OPAL_DATATYPE_SWAP_X86 */
+
+void opal_datatype_swap_init(void)
+{
+#if OPAL_DATATYPE_SWAP_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) {
+        opal_datatype_swap_hw_level = OPAL_DATATYPE_SWAP_AVX512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        opal_datatype_swap_hw_level = OPAL_DATATYPE_SWAP_AVX2;
+    } else if (__builtin_cpu_supports("ssse3")) {
+        opal_datatype_swap_hw_level = OPAL_DATATYPE_SWAP_SSSE3;
+    }
+#endif /* OPAL_DATATYPE_SWAP_X86 */
+}
+
+void opal_datatype_swap_bytes(void *to_p, const void *from_p, size_t size, size_t count)
+{
+    uint8_t *to = (uint8_t *) to_p;
+    const uint8_t *from = (const uint8_t *) from_p;
+#if OPAL_DATATYPE_SWAP_X86
+    int level = opal_datatype_swap_hw_level;
+    size_t done = 0;
+
+    if ((0 <= opal_datatype_swap_simd) && (opal_datatype_swap_simd < level)) {
+        level = opal_datatype_swap_simd;
+    }
+    if ((OPAL_DATATYPE_SWAP_SCALAR != level) && (0 == (size & (size - 1))) && (2 <= size)
+        && (size <= 16) && ((size * count) >= 16)) {
+        const uint8_t *mask = swap_masks[(2 == size) ? 0 : (4 == size) ? 1 : (8 == size) ? 2 : 3];
+
+        switch (level) {
+        case OPAL_DATATYPE_SWAP_AVX512:
+            done = swap_bytes_avx512(to, from, size * count, mask);
+            done += swap_bytes_avx2(to + done, from + done, size * count - done, mask);
+            break;
+        case OPAL_DATATYPE_SWAP_AVX2:
+            done = swap_bytes_avx2(to, from, size * count, mask);
+            break;
+        }
+        done += swap_bytes_ssse3(to + done, from + done, size * count - done, mask);
+        to += done;
+        from += done;
+        count -= done / size;
+    }
+#endif /* OPAL_DATATYPE_SWAP_X86 */
+    swap_bytes_scalar(to, from, size, count);
+}
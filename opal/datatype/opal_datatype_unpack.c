@@ -314,6 +314,9 @@ int32_t opal_generic_simple_unpack_function(opal_convertor_t *pConvertor, struct
                 conv_ptr = pConvertor->pBaseBuf + pStack->disp;
                 pos_desc++; /* advance to the next data */
                 UPDATE_INTERNAL_COUNTERS(description, pos_desc, pElem, count_desc);
+            } else if ((1 < pElem->elem.blocklen) && (0 == (count_desc % pElem->elem.blocklen))) {
+                /* the data completed a block, move to the beginning of the next one */
+                conv_ptr += pElem->elem.extent - pElem->elem.blocklen * element_length;
             }
             iov_ptr += missing_length;
             iov_len_local -= missing_length;
@@ -529,6 +532,39 @@ update_and_return:
     *(packed) = _packed;
 }
 
+/*
+ * The count of a datatype made of a single predefined element, such as a
+ * predefined type, is walked one instance per iteration of the top level
+ * loop. Convert at once all the instances that fit in the space, except
+ * the last one left to the caller to terminate the loop, so that the
+ * conversion function sees the whole array instead of one element.
+ */
+static inline void
+unpack_instances_heterogeneous(opal_convertor_t *CONVERTOR, const dt_elem_desc_t *ELEM,
+                               dt_stack_t *pStack, ptrdiff_t extent, unsigned char **packed,
+                               size_t *SPACE)
+{
+    const opal_convertor_master_t *master = (CONVERTOR)->master;
+    const ddt_elem_desc_t *_elem = &((ELEM)->elem);
+    size_t remote_elem_size = master->remote_sizes[_elem->common.type];
+    size_t count = pStack->count - 1;
+    unsigned char *_memory = (CONVERTOR)->pBaseBuf + pStack->disp + _elem->disp;
+    ptrdiff_t advance = 0;
+
+    if ((remote_elem_size * count) > *(SPACE))
+        count = (*SPACE) / remote_elem_size;
+    if (0 == count)
+        return;
+    OPAL_DATATYPE_SAFEGUARD_POINTER(_memory, count * extent, (CONVERTOR)->pBaseBuf,
+                                    (CONVERTOR)->pDesc, (CONVERTOR)->count);
+    master->pFunctions[_elem->common.type](CONVERTOR, count, *packed, *SPACE, remote_elem_size,
+                                           _memory, *SPACE, extent, &advance);
+    pStack->count -= count;
+    pStack->disp += count * extent;
+    *(SPACE) -= count * remote_elem_size;
+    *(packed) += count * remote_elem_size;
+}
+
 int32_t opal_unpack_general_function(opal_convertor_t *pConvertor, struct iovec *iov,
                                      uint32_t *out_size, size_t *max_data)
 {
@@ -638,6 +674,14 @@ int32_t opal_unpack_general_function(opal_convertor_t *pConvertor, struct iovec
                     pos_desc = pStack->index + 1;
                     if (pStack->index == -1) {
                         pStack->disp += (pData->ub - pData->lb);
+                        if ((description[0].elem.common.flags & OPAL_DATATYPE_FLAG_DATA)
+                            && (OPAL_DATATYPE_END_LOOP == description[1].elem.common.type)
+                            && (1 == description[0].elem.count)
+                            && (1 == description[0].elem.blocklen)) {
+                            unpack_instances_heterogeneous(pConvertor, description, pStack,
+                                                           pData->ub - pData->lb, &iov_ptr,
+                                                           &iov_len_local);
+                        }
                     } else {
                         assert(OPAL_DATATYPE_LOOP == description[pStack->index].loop.common.type);
                         pStack->disp += description[pStack->index].loop.extent;
@@ -19,6 +19,7 @@
 #define OPAL_DATATYPE_UNPACK_H_HAS_BEEN_INCLUDED
 
 #include "opal_config.h"
+#include "opal/datatype/opal_datatype_pack_unpack_blocks.h"
 #include "opal/datatype/opal_datatype_pack_unpack_predefined.h"
 
 #if !defined(CHECKSUM) && OPAL_CUDA_SUPPORT
@@ -99,6 +100,26 @@ static inline void unpack_predefined_data(opal_convertor_t *CONVERTOR, const dt_
     /* premptively update the number of COUNT we will return. */
     *(COUNT) -= cando_count;
 
+#if !defined(CHECKSUM)
+    if (!(CONVERTOR->flags & CONVERTOR_CUDA)
+        && opal_datatype_small_blocks_eligible(blocklen_bytes * _elem->blocklen, _elem->count)
+        && (_elem->blocklen <= cando_count)) {
+        size_t nblocks = cando_count / _elem->blocklen;
+        size_t block_bytes = blocklen_bytes * _elem->blocklen;
+
+        OPAL_DATATYPE_SAFEGUARD_STRIDED(_memory, block_bytes, _elem->extent, nblocks,
+                                        (CONVERTOR)->pBaseBuf, (CONVERTOR)->pDesc,
+                                        (CONVERTOR)->count);
+        if (OPAL_SUCCESS
+            == opal_datatype_small_blocks_copy(&_memory, _elem->extent, &_packed, block_bytes,
+                                               nblocks, block_bytes)) {
+            /* the epilog takes care of the leftover of the last block */
+            cando_count -= nblocks * _elem->blocklen;
+            goto do_epilog;
+        }
+    }
+#endif /* !defined(CHECKSUM) */
+
     if (_elem->blocklen < 9) {
         if ((!(CONVERTOR->flags & CONVERTOR_CUDA))
             && OPAL_LIKELY(OPAL_SUCCESS
@@ -142,6 +163,9 @@ static inline void unpack_predefined_data(opal_convertor_t *CONVERTOR, const dt_
     /**
      * As an epilog do anything left from the last blocklen.
      */
+#if !defined(CHECKSUM)
+do_epilog:
+#endif /* !defined(CHECKSUM) */
     if (0 != cando_count) {
         assert((cando_count < _elem->blocklen)
                || ((1 == _elem->count) && (cando_count <= _elem->blocklen)));
@@ -173,6 +197,19 @@ static inline void unpack_contiguous_loop(opal_convertor_t *CONVERTOR, const dt_
 
     if ((_copy_loops * _end_loop->size) > *(SPACE))
         _copy_loops = (*(SPACE) / _end_loop->size);
+#if !defined(CHECKSUM)
+    if (!(CONVERTOR->flags & CONVERTOR_CUDA)
+        && opal_datatype_small_blocks_eligible(_end_loop->size, _copy_loops)) {
+        OPAL_DATATYPE_SAFEGUARD_STRIDED(_memory, _end_loop->size, _loop->extent, _copy_loops,
+                                        (CONVERTOR)->pBaseBuf, (CONVERTOR)->pDesc,
+                                        (CONVERTOR)->count);
+        if (OPAL_SUCCESS
+            == opal_datatype_small_blocks_copy(&_memory, _loop->extent, packed, _end_loop->size,
+                                               _copy_loops, _end_loop->size)) {
+            goto update_and_return;
+        }
+    }
+#endif /* !defined(CHECKSUM) */
     for (size_t _i = 0; _i < _copy_loops; _i++) {
         OPAL_DATATYPE_SAFEGUARD_POINTER(_memory, _end_loop->size, (CONVERTOR)->pBaseBuf,
                                         (CONVERTOR)->pDesc, (CONVERTOR)->count);
@@ -183,6 +220,9 @@ static inline void unpack_contiguous_loop(opal_convertor_t *CONVERTOR, const dt_
         *(packed) += _end_loop->size;
         _memory += _loop->extent;
     }
+#if !defined(CHECKSUM)
+update_and_return:
+#endif /* !defined(CHECKSUM) */
     *(memory) = _memory - _end_loop->first_elem_disp;
     *(SPACE) -= _copy_loops * _end_loop->size;
     *(COUNT) -= _copy_loops;
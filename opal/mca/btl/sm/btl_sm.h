@@ -52,6 +52,7 @@
 #include "opal/mca/btl/base/btl_base_error.h"
 #include "opal/mca/btl/btl.h"
 #include "opal/mca/btl/sm/btl_sm_types.h"
+#include "opal/mca/memcpy/base/base.h"
 #include "opal/mca/mpool/base/base.h"
 #include "opal/mca/rcache/base/base.h"
 #include "opal/mca/rcache/base/rcache_base_vma.h"
@@ -88,7 +89,7 @@ OPAL_MODULE_DECLSPEC extern mca_btl_sm_t mca_btl_sm;
 static inline void sm_memmove(void *dst, void *src, size_t size)
 {
     if (size >= (size_t) mca_btl_sm_component.memcpy_limit) {
-        memcpy(dst, src, size);
+        opal_memcpy(dst, src, size);
     } else {
         memmove(dst, src, size);
     }
@@ -139,6 +140,24 @@ int mca_btl_sm_put_cma(mca_btl_base_module_t *btl, mca_btl_base_endpoint_t *endp
                        void *cbdata);
 #endif
 
+#if OPAL_BTL_SM_HAVE_CMA
+/**
+ * Copy a huge range from or to a peer with the helper threads of the
+ * opal thread pool.
+ *
+ * @param endpoint (IN)       BTL addressing information
+ * @param write (IN)          true to write to the peer, false to read from it
+ * @param local_address (IN)  local buffer
+ * @param remote_address (IN) peer buffer
+ * @param size (IN)           number of bytes to copy
+ *
+ * @returns OPAL_ERR_NOT_SUPPORTED if the range is too small, the helpers are
+ *          disabled or busy; the caller should then copy the range itself.
+ */
+int mca_btl_sm_cma_copy_mt(mca_btl_base_endpoint_t *endpoint, bool write, void *local_address,
+                           void *remote_address, size_t size);
+#endif
+
 #if OPAL_BTL_SM_HAVE_KNEM
 int mca_btl_sm_put_knem(mca_btl_base_module_t *btl, mca_btl_base_endpoint_t *endpoint,
                         void *local_address, uint64_t remote_address,
@@ -184,6 +203,93 @@ int mca_btl_sm_get_knem(mca_btl_base_module_t *btl, mca_btl_base_endpoint_t *end
 
 ino_t mca_btl_sm_get_user_ns_id(void);
 
+/**
+ * Bind a range of this rank's segment to a NUMA node.
+ *
+ * @param addr (IN)     start of the range (page aligned)
+ * @param size (IN)     size of the range
+ * @param node (IN)     NUMA node to place the range on
+ *
+ * The pages already touched are migrated. Failures are ignored, the range
+ * is then left where it is.
+ */
+void mca_btl_sm_numa_bind(void *addr, size_t size, int node);
+
+/**
+ * Complete the release of the send fast box of an endpoint.
+ *
+ * @param endpoint (IN)  endpoint with a fast box being released
+ *
+ * @returns true if the fast box is back in the free list, false if the peer
+ *          is still polling it.
+ */
+bool mca_btl_sm_fbox_reclaimed(struct mca_btl_base_endpoint_t *endpoint);
+
+/**
+ * Wake up a process sleeping on its doorbell.
+ *
+ * @param fifo (IN)     receive fifo of the process
+ */
+void mca_btl_sm_doorbell_ring(struct sm_fifo_t *fifo);
+
+/* wake up the owner of the fifo if it sleeps (called after writing a message) */
+static inline void mca_btl_sm_wake(struct sm_fifo_t *fifo)
+{
+#if OPAL_BTL_SM_HAVE_FUTEX
+    if (OPAL_UNLIKELY(mca_btl_sm_component.blocking_wait)) {
+        /* order the message before the read of the flag (the receiver does the opposite) */
+        opal_atomic_mb();
+        if (fifo->sleeping && opal_atomic_swap_32(&fifo->sleeping, 0)) {
+            mca_btl_sm_doorbell_ring(fifo);
+        }
+    }
+#endif
+}
+
+#if OPAL_HAVE_THREAD_LOCAL
+/* fifo index of the calling thread (-1 until the thread sends or receives) */
+extern opal_thread_local int mca_btl_sm_thread_fifo;
+#endif
+
+/**
+ * Select a receive fifo.
+ *
+ * @param order (IN)      btl order of the fragment
+ * @param num_fifos (IN)  number of receive fifos of the process
+ *
+ * Fragments with an order other than MCA_BTL_NO_ORDER use the fifo of their
+ * order. The others use a fifo picked once per thread, so the threads of a
+ * process do not contend on the tail and the head of the same fifo.
+ */
+static inline unsigned int mca_btl_sm_fifo_index(uint8_t order, unsigned int num_fifos)
+{
+    if (OPAL_LIKELY(1 == num_fifos)) {
+        return 0;
+    }
+
+    if (MCA_BTL_NO_ORDER != order) {
+        return order % num_fifos;
+    }
+
+#if OPAL_HAVE_THREAD_LOCAL
+    if (OPAL_UNLIKELY(mca_btl_sm_thread_fifo < 0)) {
+        mca_btl_sm_thread_fifo = opal_atomic_fetch_add_32(&mca_btl_sm_component.num_threads, 1);
+    }
+
+    return (unsigned int) mca_btl_sm_thread_fifo % num_fifos;
+#else
+    return 0;
+#endif
+}
+
+/* account the bytes sent to a peer (see the remote_numa_fraction pvar). the
+ * counter only feeds a statistic, it is updated without an atomic on the
+ * send path and may miss a few concurrent sends to the same peer. */
+static inline void mca_btl_sm_account_send(struct mca_btl_base_endpoint_t *endpoint, size_t size)
+{
+    endpoint->bytes_sent += size;
+}
+
 /**
  * Allocate a segment.
  *
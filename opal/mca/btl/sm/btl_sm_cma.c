@@ -0,0 +1,134 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * CMA get and put of huge messages with the opal pool of helper threads.
+ *
+ * A single process_vm_readv/writev is limited by the memory bandwidth
+ * of one core. Transfers of at least cma_parallel_threshold bytes are
+ * cut in chunks of cma_chunk_size bytes, each chunk is a task of the
+ * thread pool, taken in order by the caller and the helpers until none
+ * is left.
+ *
+ * Callers that find the pool busy go through the usual single threaded
+ * path.
+ */
+
+#include "opal_config.h"
+
+#include "opal/mca/threads/thread_pool.h"
+#include "opal/sys/atomic.h"
+
+#include "opal/mca/btl/sm/btl_sm.h"
+#include "opal/mca/btl/sm/btl_sm_endpoint.h"
+
+#if OPAL_BTL_SM_HAVE_CMA
+#    include <limits.h>
+#    include <sys/uio.h>
+
+#    if OPAL_CMA_NEED_SYSCALL_DEFS
+#        include "opal/sys/cma.h"
+#    endif /* OPAL_CMA_NEED_SYSCALL_DEFS */
+
+typedef struct {
+    pid_t pid;
+    bool write;
+    char *local;
+    char *remote;
+    size_t size;
+    size_t chunk;
+    /* errno of the first failed chunk */
+    opal_atomic_int32_t error;
+} btl_sm_cma_job_t;
+
+/* copy one range, see mca_btl_sm_get_cma() for why this loops */
+static int btl_sm_cma_copy(pid_t pid, bool write, void *local, void *remote, size_t size)
+{
+    struct iovec local_iov = {.iov_base = local, .iov_len = size};
+    struct iovec remote_iov = {.iov_base = remote, .iov_len = size};
+    ssize_t ret;
+
+    do {
+        if (write) {
+            ret = process_vm_writev(pid, &local_iov, 1, &remote_iov, 1, 0);
+        } else {
+            ret = process_vm_readv(pid, &local_iov, 1, &remote_iov, 1, 0);
+        }
+        if (0 > ret) {
+            return errno;
+        }
+        local_iov.iov_base = (void *) ((char *) local_iov.iov_base + ret);
+        local_iov.iov_len -= ret;
+        remote_iov.iov_base = (void *) ((char *) remote_iov.iov_base + ret);
+        remote_iov.iov_len -= ret;
+    } while (0 < local_iov.iov_len);
+
+    return 0;
+}
+
+static void btl_sm_cma_run_chunk(void *arg, int chunk)
+{
+    btl_sm_cma_job_t *job = (btl_sm_cma_job_t *) arg;
+    size_t offset = (size_t) chunk * job->chunk;
+    size_t length = job->size - offset < job->chunk ? job->size - offset : job->chunk;
+    int error;
+
+    /* the transfer already failed, skip the remaining chunks */
+    if (0 != job->error) {
+        return;
+    }
+    error = btl_sm_cma_copy(job->pid, job->write, job->local + offset, job->remote + offset,
+                            length);
+    if (OPAL_UNLIKELY(0 != error)) {
+        int32_t expected = 0;
+        (void) opal_atomic_compare_exchange_strong_32(&job->error, &expected, error);
+    }
+}
+
+int mca_btl_sm_cma_copy_mt(mca_btl_base_endpoint_t *endpoint, bool write, void *local_address,
+                           void *remote_address, size_t size)
+{
+    btl_sm_cma_job_t job = {.pid = endpoint->segment_data.other.seg_ds->seg_cpid,
+                            .write = write,
+                            .local = (char *) local_address,
+                            .remote = (char *) remote_address,
+                            .size = size,
+                            .chunk = mca_btl_sm_component.cma_chunk_size,
+                            .error = 0};
+    size_t nchunks;
+
+    if (opal_thread_pool_size <= 0 || size < mca_btl_sm_component.cma_parallel_threshold) {
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+    nchunks = (size + job.chunk - 1) / job.chunk;
+    if (nchunks < 2 || nchunks > INT_MAX
+        || OPAL_SUCCESS != opal_thread_pool_submit(btl_sm_cma_run_chunk, &job, (int) nchunks)) {
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+    opal_thread_pool_wait();
+
+    if (OPAL_UNLIKELY(0 != job.error)) {
+        if (ESRCH == job.error) {
+            BTL_PEER_ERROR(NULL, ("CMA %s of %lu bytes failed, errno = %d\n",
+                                  write ? "write" : "read", (unsigned long) size, job.error));
+        } else {
+            BTL_ERROR(("CMA %s of %lu bytes failed, errno = %d\n", write ? "write" : "read",
+                       (unsigned long) size, job.error));
+        }
+        return OPAL_ERROR;
+    }
+
+    return OPAL_SUCCESS;
+}
+
+#endif /* OPAL_BTL_SM_HAVE_CMA */
@@ -30,11 +30,16 @@
  */
 #include "opal_config.h"
 
+#include "opal/align.h"
+#include "opal/mca/base/mca_base_pvar.h"
 #include "opal/mca/btl/base/btl_base_error.h"
+#include "opal/mca/hwloc/base/base.h"
 #include "opal/mca/threads/mutex.h"
+#include "opal/mca/threads/thread_pool.h"
 #include "opal/util/output.h"
 #include "opal/util/printf.h"
 #include "opal/util/show_help.h"
+#include "opal/util/sys_limits.h"
 
 #include "opal/mca/btl/sm/btl_sm.h"
 #include "opal/mca/btl/sm/btl_sm_fbox.h"
@@ -53,6 +58,12 @@
 #    include <sys/prctl.h>
 #endif
 
+#if OPAL_BTL_SM_HAVE_FUTEX
+#    include <linux/futex.h>
+#    include <sys/syscall.h>
+#    include <time.h>
+#endif
+
 /* NTH: OS X does not define MAP_ANONYMOUS */
 #if !defined(MAP_ANONYMOUS)
 #    define MAP_ANONYMOUS MAP_ANON
@@ -64,6 +75,12 @@ static int mca_btl_sm_component_close(void);
 static int mca_btl_sm_component_register(void);
 static mca_btl_base_module_t **
 mca_btl_sm_component_init(int *num_btls, bool enable_progress_threads, bool enable_mpi_threads);
+static int mca_btl_sm_remote_numa_fraction(const struct mca_base_pvar_t *pvar, void *value,
+                                           void *obj);
+
+#if OPAL_HAVE_THREAD_LOCAL
+opal_thread_local int mca_btl_sm_thread_fifo = -1;
+#endif
 
 /* This enumeration is in order of preference */
 static mca_base_var_enum_value_t single_copy_mechanisms[] = {
@@ -211,6 +228,86 @@ static int mca_btl_sm_component_register(void)
                                            MCA_BASE_VAR_SCOPE_LOCAL,
                                            &mca_btl_sm_component.fbox_size);
 
+    mca_btl_sm_component.fbox_reclaim_interval = 100000;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version,
+                                           "fbox_reclaim_interval",
+                                           "Interval in microseconds between evaluations of the "
+                                           "eager send buffers. Buffers unused during an interval "
+                                           "are released, the least used buffer is given up for "
+                                           "a busier peer, and a peer needs fbox_threshold sends "
+                                           "within an interval to get a buffer "
+                                           "(0 = never release, default: 100000)",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.fbox_reclaim_interval);
+
+    mca_btl_sm_component.blocking_wait = false;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version,
+                                           "blocking_wait",
+                                           "Sleep in the progress engine after wait_spin_count "
+                                           "polls without a message, until a local peer sends a "
+                                           "message or wait_timeout expires. Other transports are "
+                                           "not progressed while sleeping, intended for "
+                                           "oversubscribed nodes (default: false)",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.blocking_wait);
+
+    mca_btl_sm_component.wait_spin_count = 1000;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version,
+                                           "wait_spin_count",
+                                           "Number of polls without a message before sleeping "
+                                           "when blocking_wait is set (default: 1000)",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.wait_spin_count);
+
+    mca_btl_sm_component.wait_timeout = 1000;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version,
+                                           "wait_timeout",
+                                           "Maximum time in microseconds to sleep when "
+                                           "blocking_wait is set (default: 1000)",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.wait_timeout);
+
+    mca_btl_sm_component.num_fifos = 1;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version, "num_fifos",
+                                           "Number of receive fifos per process. The threads of "
+                                           "a process send to and receive from different fifos "
+                                           "when more than one is used, the first fifo is always "
+                                           "polled under the progress lock (maximum: 64, "
+                                           "default: 1)",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.num_fifos);
+
+    mca_btl_sm_component.numa_placement = true;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version,
+                                           "numa_placement",
+                                           "Place the eager send buffers of a peer on the "
+                                           "NUMA node of the peer (default: true)",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.numa_placement);
+
+    (void) mca_base_component_pvar_register(&mca_btl_sm_component.super.btl_version,
+                                            "remote_numa_fraction",
+                                            "Fraction of the bytes sent to local peers that went "
+                                            "to a peer on a different NUMA node",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_PERCENTAGE,
+                                            MCA_BASE_VAR_TYPE_DOUBLE, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY
+                                                | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            mca_btl_sm_remote_numa_fraction, NULL, NULL, NULL);
+
     (void) mca_base_var_enum_create("btl_sm_single_copy_mechanisms", single_copy_mechanisms,
                                     &new_enum);
 
@@ -239,6 +336,29 @@ static int mca_btl_sm_component_register(void)
         MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0, OPAL_INFO_LVL_3, MCA_BASE_VAR_SCOPE_READONLY,
         &mca_btl_sm_component.backing_directory);
 
+#if OPAL_BTL_SM_HAVE_CMA
+    mca_btl_sm_component.cma_parallel_threshold = 16 * 1024 * 1024;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version,
+                                           "cma_parallel_threshold",
+                                           "Minimum size in bytes of a CMA get or put split "
+                                           "across the helper threads of the opal thread "
+                                           "pool (default: 16M)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.cma_parallel_threshold);
+
+    mca_btl_sm_component.cma_chunk_size = 2 * 1024 * 1024;
+    (void) mca_base_component_var_register(&mca_btl_sm_component.super.btl_version,
+                                           "cma_chunk_size",
+                                           "Size in bytes of the pieces of a CMA get or put "
+                                           "split across the helper threads (default: 2M)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_sm_component.cma_chunk_size);
+#endif
+
 #if OPAL_BTL_SM_HAVE_KNEM
     /* Currently disabling DMA mode by default; it's not clear that this is useful in all
      * applications and architectures. */
@@ -305,7 +425,12 @@ static int mca_btl_sm_component_open(void)
     mca_btl_sm.knem_fd = -1;
 #endif
 
+#if OPAL_BTL_SM_HAVE_CMA
+    /* the huge CMA transfers are split across the helper threads */
+    return opal_thread_pool_init();
+#else
     return OPAL_SUCCESS;
+#endif
 }
 
 /*
@@ -314,6 +439,10 @@ static int mca_btl_sm_component_open(void)
 
 static int mca_btl_sm_component_close(void)
 {
+#if OPAL_BTL_SM_HAVE_CMA
+    opal_thread_pool_fini();
+#endif
+
     OBJ_DESTRUCT(&mca_btl_sm_component.sm_frags_eager);
     OBJ_DESTRUCT(&mca_btl_sm_component.sm_frags_user);
     OBJ_DESTRUCT(&mca_btl_sm_component.sm_frags_max_send);
@@ -329,6 +458,8 @@ static int mca_btl_sm_component_close(void)
 
     mca_btl_sm_component.my_segment = NULL;
 
+    free(mca_btl_sm_component.fifo_locks);
+    mca_btl_sm_component.fifo_locks = NULL;
 #if OPAL_BTL_SM_HAVE_KNEM
     mca_btl_sm_knem_fini();
 #endif
@@ -360,6 +491,88 @@ ino_t mca_btl_sm_get_user_ns_id(void)
 
     return buf.st_ino;
 }
+/*
+ * mca_btl_sm_get_numa_node() returns the NUMA node this process is bound
+ * to, or -1 if it is not bound within a single NUMA node.
+ */
+static int mca_btl_sm_get_numa_node(void)
+{
+    hwloc_cpuset_t cpuset;
+    hwloc_nodeset_t nodeset;
+    int node = -1;
+
+    if (OPAL_SUCCESS != opal_hwloc_base_get_topology()) {
+        return -1;
+    }
+
+    cpuset = hwloc_bitmap_alloc();
+    nodeset = hwloc_bitmap_alloc();
+    if (NULL != cpuset && NULL != nodeset
+        && 0 == hwloc_get_cpubind(opal_hwloc_topology, cpuset, HWLOC_CPUBIND_PROCESS)) {
+        hwloc_cpuset_to_nodeset(opal_hwloc_topology, cpuset, nodeset);
+        if (1 == hwloc_bitmap_weight(nodeset)) {
+            node = hwloc_bitmap_first(nodeset);
+        }
+    }
+
+    if (NULL != cpuset) {
+        hwloc_bitmap_free(cpuset);
+    }
+    if (NULL != nodeset) {
+        hwloc_bitmap_free(nodeset);
+    }
+
+    return node;
+}
+
+void mca_btl_sm_numa_bind(void *addr, size_t size, int node)
+{
+    hwloc_nodeset_t nodeset;
+
+    if (OPAL_SUCCESS != opal_hwloc_base_get_topology()) {
+        return;
+    }
+
+    nodeset = hwloc_bitmap_alloc();
+    if (NULL == nodeset) {
+        return;
+    }
+
+    hwloc_bitmap_only(nodeset, node);
+#if HWLOC_API_VERSION < 0x20000
+    if (0 != hwloc_set_area_membind_nodeset(opal_hwloc_topology, addr, size, nodeset,
+                                            HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_MIGRATE)) {
+#else
+    if (0 != hwloc_set_area_membind(opal_hwloc_topology, addr, size, nodeset, HWLOC_MEMBIND_BIND,
+                                    HWLOC_MEMBIND_MIGRATE | HWLOC_MEMBIND_BYNODESET)) {
+#endif
+        BTL_VERBOSE(("could not bind %lu bytes at %p to NUMA node %d", (unsigned long) size, addr,
+                     node));
+    }
+
+    hwloc_bitmap_free(nodeset);
+}
+
+static int mca_btl_sm_remote_numa_fraction(const struct mca_base_pvar_t *pvar, void *value,
+                                           void *obj)
+{
+    mca_btl_base_endpoint_t *endpoints = mca_btl_sm_component.endpoints;
+    size_t total = 0, remote = 0;
+
+    if (NULL != endpoints) {
+        for (int i = 0; i < (int) (1 + MCA_BTL_SM_NUM_LOCAL_PEERS); ++i) {
+            total += endpoints[i].bytes_sent;
+            if (endpoints[i].remote_numa) {
+                remote += endpoints[i].bytes_sent;
+            }
+        }
+    }
+
+    *((double *) value) = total ? (double) remote / (double) total : 0.0;
+
+    return OPAL_SUCCESS;
+}
+
 static int mca_btl_base_sm_modex_send(void)
 {
     union sm_modex_t modex;
@@ -370,6 +583,8 @@ static int mca_btl_base_sm_modex_send(void)
         modex.xpmem.seg_id = mca_btl_sm_component.my_seg_id;
         modex.xpmem.segment_base = mca_btl_sm_component.my_segment;
         modex.xpmem.address_max = mca_btl_sm_component.my_address_max;
+        modex.xpmem.numa_node = mca_btl_sm_component.my_numa_node;
+        modex.xpmem.num_fifos = mca_btl_sm_component.num_fifos;
 
         modex_size = sizeof(modex.xpmem);
     } else {
@@ -377,6 +592,8 @@ static int mca_btl_base_sm_modex_send(void)
         modex.other.seg_ds_size = opal_shmem_sizeof_shmem_ds(&mca_btl_sm_component.seg_ds);
         memmove(&modex.other.seg_ds, &mca_btl_sm_component.seg_ds, modex.other.seg_ds_size);
         modex.other.user_ns_id = mca_btl_sm_get_user_ns_id();
+        modex.other.numa_node = mca_btl_sm_component.my_numa_node;
+        modex.other.num_fifos = mca_btl_sm_component.num_fifos;
         /*
          * If modex.other.user_ns_id is '0' something did not work out
          * during user namespace detection. Assuming there are no
@@ -538,9 +755,36 @@ mca_btl_sm_component_init(int *num_btls, bool enable_progress_threads, bool enab
         component->segment_size = 2ul << MCA_BTL_SM_OFFSET_BITS;
     }
 
+#if OPAL_BTL_SM_HAVE_CMA
+    if (component->cma_chunk_size < (size_t) opal_getpagesize()) {
+        component->cma_chunk_size = opal_getpagesize();
+    }
+#endif
+
     /* no fast boxes allocated initially */
     component->num_fbox_in_endpoints = 0;
 
+    if (0 == component->num_fifos) {
+        component->num_fifos = 1;
+    } else if (component->num_fifos > MCA_BTL_SM_MAX_FIFOS) {
+        component->num_fifos = MCA_BTL_SM_MAX_FIFOS;
+    }
+
+    component->num_threads = 0;
+    component->fifo_locks = (opal_atomic_int32_t *) calloc(component->num_fifos,
+                                                           sizeof(opal_atomic_int32_t));
+    if (NULL == component->fifo_locks) {
+        free(btls);
+        return NULL;
+    }
+
+#if !OPAL_BTL_SM_HAVE_FUTEX
+    if (component->blocking_wait) {
+        BTL_VERBOSE(("blocking wait is not supported on this platform"));
+        component->blocking_wait = false;
+    }
+#endif
+
     mca_btl_sm_check_single_copy();
 
     if (MCA_BTL_SM_XPMEM != mca_btl_sm_component.single_copy_mechanism) {
@@ -550,6 +794,8 @@ mca_btl_sm_component_init(int *num_btls, bool enable_progress_threads, bool enab
                            mca_btl_sm_component.backing_directory, opal_process_info.nodename,
                            OPAL_PROC_MY_NAME.jobid, MCA_BTL_SM_LOCAL_RANK);
         if (0 > rc) {
+            free(component->fifo_locks);
+            component->fifo_locks = NULL;
             free(btls);
             return NULL;
         }
@@ -559,6 +805,8 @@ mca_btl_sm_component_init(int *num_btls, bool enable_progress_threads, bool enab
         free(sm_file);
         if (OPAL_SUCCESS != rc) {
             BTL_VERBOSE(("Could not create shared memory segment"));
+            free(component->fifo_locks);
+            component->fifo_locks = NULL;
             free(btls);
             return NULL;
         }
@@ -574,13 +822,23 @@ mca_btl_sm_component_init(int *num_btls, bool enable_progress_threads, bool enab
                                      MAP_ANONYMOUS | MAP_SHARED, -1, 0);
         if ((void *) -1 == component->my_segment) {
             BTL_VERBOSE(("Could not create anonymous memory segment"));
+            free(component->fifo_locks);
+            component->fifo_locks = NULL;
             free(btls);
             return NULL;
         }
     }
 
-    /* initialize my fifo */
-    sm_fifo_init((struct sm_fifo_t *) component->my_segment);
+    component->my_numa_node = mca_btl_sm_get_numa_node();
+    if (component->numa_placement && 0 <= component->my_numa_node) {
+        /* the fifo heads are polled by this process */
+        size_t fifos_size = component->num_fifos * MCA_BTL_SM_FIFO_SIZE;
+        fifos_size = OPAL_ALIGN(fifos_size, (size_t) opal_getpagesize(), size_t);
+        mca_btl_sm_numa_bind(component->my_segment, fifos_size, component->my_numa_node);
+    }
+
+    /* initialize my fifos */
+    sm_fifo_init((struct sm_fifo_t *) component->my_segment, component->num_fifos);
 
     rc = mca_btl_base_sm_modex_send();
     if (OPAL_SUCCESS != rc) {
@@ -605,6 +863,9 @@ failed:
 #endif
         opal_shmem_unlink(&component->seg_ds);
 
+    free(component->fifo_locks);
+    component->fifo_locks = NULL;
+
     if (btls) {
         free(btls);
     }
@@ -660,14 +921,14 @@ void mca_btl_sm_poll_handle_frag(mca_btl_sm_hdr_t *hdr, struct mca_btl_base_endp
     sm_fifo_write_back(hdr, endpoint);
 }
 
-static int mca_btl_sm_poll_fifo(void)
+static int mca_btl_sm_poll_fifo(struct sm_fifo_t *fifo)
 {
     struct mca_btl_base_endpoint_t *endpoint;
     mca_btl_sm_hdr_t *hdr;
 
     /* poll the fifo until it is empty or a limit has been hit (8 is arbitrary) */
     for (int fifo_count = 0; fifo_count < 31; ++fifo_count) {
-        hdr = sm_fifo_read(mca_btl_sm_component.my_fifo, &endpoint);
+        hdr = sm_fifo_read(fifo, &endpoint);
         if (NULL == hdr) {
             return fifo_count;
         }
@@ -678,6 +939,54 @@ static int mca_btl_sm_poll_fifo(void)
     return 1;
 }
 
+/**
+ * Poll the receive fifos other than the first one
+ *
+ * These fifos never carry fast box setups so they can be polled without the
+ * progress lock. Each fifo has a single reader at a time, the threads start
+ * with their own fifo and skip the fifos another thread is polling.
+ */
+static int mca_btl_sm_poll_fifos(void)
+{
+    const unsigned int num_fifos = mca_btl_sm_component.num_fifos;
+    unsigned int first = mca_btl_sm_fifo_index(MCA_BTL_NO_ORDER, num_fifos - 1);
+    int count = 0;
+
+    for (unsigned int i = 0; i < num_fifos - 1; ++i) {
+        unsigned int index = 1 + (first + i) % (num_fifos - 1);
+        struct sm_fifo_t *fifo = sm_fifo_get(mca_btl_sm_component.my_fifo, index);
+        opal_atomic_int32_t *fifo_lock = mca_btl_sm_component.fifo_locks + index;
+
+        if (SM_FIFO_FREE == fifo->fifo_head) {
+            continue;
+        }
+
+        if (opal_using_threads()) {
+            if (opal_atomic_swap_32(fifo_lock, 1)) {
+                continue;
+            }
+        }
+
+        count += mca_btl_sm_poll_fifo(fifo);
+        opal_atomic_mb();
+        *fifo_lock = 0;
+    }
+
+    return count;
+}
+
+/* check if all the receive fifos are empty */
+static inline bool mca_btl_sm_fifos_empty(void)
+{
+    for (unsigned int i = 0; i < mca_btl_sm_component.num_fifos; ++i) {
+        if (SM_FIFO_FREE != sm_fifo_get(mca_btl_sm_component.my_fifo, i)->fifo_head) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /**
  * Progress pending messages on an endpoint
  *
@@ -735,30 +1044,203 @@ static void mca_btl_sm_progress_endpoints(void)
     OPAL_THREAD_UNLOCK(&mca_btl_sm_component.lock);
 }
 
+bool mca_btl_sm_fbox_reclaimed(mca_btl_base_endpoint_t *ep)
+{
+    opal_free_list_item_t *fbox = NULL;
+    bool reclaimed;
+
+    OPAL_THREAD_LOCK(&ep->lock);
+    if (ep->fbox_out.reclaim && MCA_BTL_SM_FBOX_RELEASED == ep->fbox_out.startp[0]) {
+        opal_atomic_rmb();
+        fbox = ep->fbox_out.fbox;
+        ep->fbox_out.buffer = NULL;
+        ep->fbox_out.fbox = NULL;
+        ep->fbox_out.reclaim = false;
+        /* the peer has to be busy again to get another fast box */
+        ep->send_count = 0;
+    }
+    reclaimed = !ep->fbox_out.reclaim;
+    OPAL_THREAD_UNLOCK(&ep->lock);
+
+    if (NULL != fbox) {
+        BTL_VERBOSE(("reclaimed fast box of peer %d", ep->peer_smp_rank));
+        if (mca_btl_sm_component.fbox_numa_bind && ep->remote_numa) {
+            /* the fast box is reused for other peers, and only bound again for the
+             * remote ones */
+            mca_btl_sm_numa_bind(fbox->ptr, mca_btl_sm_component.fbox_size,
+                                 mca_btl_sm_component.my_numa_node);
+        }
+        opal_free_list_return(&mca_btl_sm_component.sm_fboxes, fbox);
+    }
+
+    return reclaimed;
+}
+
+/**
+ * Evaluate the use of the send fast boxes since the last evaluation
+ *
+ * Fast boxes that were not used are released. When a peer without a fast
+ * box was denied one because they are all in use and it sent more than the
+ * peer with the least used fast box, that fast box is released too. The
+ * peers without a fast box start counting again so a fast box goes to the
+ * peers that send at least fbox_threshold messages in an interval.
+ */
+static void mca_btl_sm_fbox_evaluate(void)
+{
+    mca_btl_base_endpoint_t *coldest = NULL;
+    unsigned int coldest_count = UINT_MAX;
+    size_t denied_count = 0;
+
+    if (NULL == mca_btl_sm_component.endpoints) {
+        return;
+    }
+
+    for (int i = 0; i < (int) (1 + MCA_BTL_SM_NUM_LOCAL_PEERS); ++i) {
+        mca_btl_base_endpoint_t *ep = mca_btl_sm_component.endpoints + i;
+        unsigned int count;
+
+        if (NULL == ep->fifo || MCA_BTL_SM_LOCAL_RANK == i) {
+            continue;
+        }
+
+        if (ep->fbox_out.reclaim) {
+            (void) mca_btl_sm_fbox_reclaimed(ep);
+            continue;
+        }
+
+        if (NULL == ep->fbox_out.buffer) {
+            if (ep->fbox_out.denied && ep->send_count > denied_count) {
+                denied_count = ep->send_count;
+            }
+            ep->send_count = 0;
+            continue;
+        }
+
+        OPAL_THREAD_LOCK(&ep->lock);
+        count = ep->fbox_out.count;
+        ep->fbox_out.count = 0;
+        OPAL_THREAD_UNLOCK(&ep->lock);
+
+        if (0 == count) {
+            mca_btl_sm_fbox_release(ep);
+        } else if (count < coldest_count) {
+            coldest = ep;
+            coldest_count = count;
+        }
+    }
+
+    if (NULL != coldest && denied_count > coldest_count) {
+        mca_btl_sm_fbox_release(coldest);
+    }
+}
+
+void mca_btl_sm_doorbell_ring(struct sm_fifo_t *fifo)
+{
+#if OPAL_BTL_SM_HAVE_FUTEX
+    (void) opal_atomic_add_fetch_32(&fifo->doorbell, 1);
+    (void) syscall(SYS_futex, &fifo->doorbell, FUTEX_WAKE, 1, NULL, NULL, 0);
+#endif
+}
+
+#if OPAL_BTL_SM_HAVE_FUTEX
+/* check for a message in the fast boxes without processing it */
+static bool mca_btl_sm_fbox_pending(void)
+{
+    for (unsigned int i = 0; i < mca_btl_sm_component.num_fbox_in_endpoints; ++i) {
+        mca_btl_base_endpoint_t *ep = mca_btl_sm_component.fbox_in_endpoints[i];
+        const mca_btl_sm_fbox_hdr_t hdr = mca_btl_sm_fbox_read_header(MCA_BTL_SM_FBOX_HDR(
+            ep->fbox_in.buffer + (ep->fbox_in.start & MCA_BTL_SM_FBOX_OFFSET_MASK)));
+
+        if (0 != hdr.data.tag && hdr.data.seq == ep->fbox_in.seq) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Sleep until a local peer sends a message or the wait timeout expires
+ *
+ * The flag is set before checking for messages one last time, and the
+ * senders check the flag after writing a message, so either this process
+ * sees the message or the sender rings the doorbell. The doorbell value is
+ * read before the flag so a ring that happens before the futex call makes
+ * the call return immediately.
+ */
+static void mca_btl_sm_wait(void)
+{
+    struct sm_fifo_t *fifo = mca_btl_sm_component.my_fifo;
+    const unsigned int timeout = mca_btl_sm_component.wait_timeout;
+    struct timespec ts = {.tv_sec = timeout / 1000000, .tv_nsec = (timeout % 1000000) * 1000};
+    int32_t doorbell = fifo->doorbell;
+
+    fifo->sleeping = 1;
+    opal_atomic_mb();
+
+    if (mca_btl_sm_fifos_empty() && !mca_btl_sm_fbox_pending()) {
+        (void) syscall(SYS_futex, &fifo->doorbell, FUTEX_WAIT, doorbell, &ts, NULL, 0);
+    }
+
+    fifo->sleeping = 0;
+}
+#endif
+
 static int mca_btl_sm_component_progress(void)
 {
     static opal_atomic_int32_t lock = 0;
+    static unsigned int progress_count = 0;
+    static unsigned int idle_count = 0;
     int count = 0;
 
+    if (mca_btl_sm_component.num_fifos > 1) {
+        count = mca_btl_sm_poll_fifos();
+    }
+
     if (opal_using_threads()) {
         if (opal_atomic_swap_32(&lock, 1)) {
-            return 0;
+            return count;
+        }
+    }
+
+    /* check the time only every 64 calls */
+    if (mca_btl_sm_component.fbox_reclaim_interval && 0 == (++progress_count & 0x3f)) {
+        opal_timer_t now = opal_timer_base_get_usec();
+        if (now - mca_btl_sm_component.fbox_last_evaluation
+            >= mca_btl_sm_component.fbox_reclaim_interval) {
+            mca_btl_sm_component.fbox_last_evaluation = now;
+            mca_btl_sm_fbox_evaluate();
         }
     }
 
     /* check for messages in fast boxes */
     if (mca_btl_sm_component.num_fbox_in_endpoints) {
-        count = mca_btl_sm_check_fboxes();
+        count += mca_btl_sm_check_fboxes();
     }
 
     mca_btl_sm_progress_endpoints();
 
     if (SM_FIFO_FREE == mca_btl_sm_component.my_fifo->fifo_head) {
+#if OPAL_BTL_SM_HAVE_FUTEX
+        /* spin then sleep. do not sleep with fragments waiting for space in a peer's fast
+         * box as the peer does not ring this process when it makes space */
+        if (OPAL_UNLIKELY(mca_btl_sm_component.blocking_wait)) {
+            if (count) {
+                idle_count = 0;
+            } else if (++idle_count >= mca_btl_sm_component.wait_spin_count
+                       && 0 == opal_list_get_size(&mca_btl_sm_component.pending_endpoints)
+                       && mca_btl_sm_fifos_empty()) {
+                idle_count = 0;
+                mca_btl_sm_wait();
+            }
+        }
+#endif
         lock = 0;
         return count;
     }
 
-    count += mca_btl_sm_poll_fifo();
+    count += mca_btl_sm_poll_fifo(mca_btl_sm_component.my_fifo);
+    idle_count = 0;
     opal_atomic_mb();
     lock = 0;
 
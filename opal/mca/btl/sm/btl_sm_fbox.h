@@ -22,6 +22,15 @@
 #define MCA_BTL_SM_FBOX_ALIGNMENT      32
 #define MCA_BTL_SM_FBOX_ALIGNMENT_MASK (MCA_BTL_SM_FBOX_ALIGNMENT - 1)
 
+/* the start offset at the beginning of the fast box is written by the receiver. keep
+ * it on its own cache line so it is not invalidated by the sender writing messages */
+#define MCA_BTL_SM_FBOX_DATA_OFFSET MCA_BTL_SM_CACHE_LINE_SIZE
+
+/* fragment header value marking the end of a fast box that is returned to the sender */
+#define MCA_BTL_SM_FBOX_RELEASE ((fifo_value_t) -1)
+/* start offset written by the receiver once it no longer polls a released fast box */
+#define MCA_BTL_SM_FBOX_RELEASED 0xffffffff
+
 /**
  *  An abstraction that represents a connection to a endpoint process.
  *  An instance of mca_ptl_base_endpoint_t is associated w/ each process
@@ -32,7 +41,7 @@ static inline void mca_btl_sm_endpoint_setup_fbox_recv(struct mca_btl_base_endpo
                                                        void *base)
 {
     endpoint->fbox_in.startp = (uint32_t *) base;
-    endpoint->fbox_in.start = MCA_BTL_SM_FBOX_ALIGNMENT;
+    endpoint->fbox_in.start = MCA_BTL_SM_FBOX_DATA_OFFSET;
     endpoint->fbox_in.seq = 0;
     opal_atomic_wmb();
     endpoint->fbox_in.buffer = base;
@@ -43,15 +52,16 @@ static inline void mca_btl_sm_endpoint_setup_fbox_send(struct mca_btl_base_endpo
 {
     void *base = fbox->ptr;
 
-    endpoint->fbox_out.start = MCA_BTL_SM_FBOX_ALIGNMENT;
-    endpoint->fbox_out.end = MCA_BTL_SM_FBOX_ALIGNMENT;
+    endpoint->fbox_out.start = MCA_BTL_SM_FBOX_DATA_OFFSET;
+    endpoint->fbox_out.end = MCA_BTL_SM_FBOX_DATA_OFFSET;
     endpoint->fbox_out.startp = (uint32_t *) base;
-    endpoint->fbox_out.startp[0] = MCA_BTL_SM_FBOX_ALIGNMENT;
+    endpoint->fbox_out.startp[0] = MCA_BTL_SM_FBOX_DATA_OFFSET;
     endpoint->fbox_out.seq = 0;
+    endpoint->fbox_out.count = 0;
     endpoint->fbox_out.fbox = fbox;
 
     /* zero out the first header in the fast box */
-    memset((char *) base + MCA_BTL_SM_FBOX_ALIGNMENT, 0, MCA_BTL_SM_FBOX_ALIGNMENT);
+    memset((char *) base + MCA_BTL_SM_FBOX_DATA_OFFSET, 0, MCA_BTL_SM_FBOX_ALIGNMENT);
 
     opal_atomic_wmb();
     endpoint->fbox_out.buffer = base;
@@ -113,10 +123,11 @@ static inline mca_btl_sm_fbox_hdr_t mca_btl_sm_fbox_read_header(mca_btl_sm_fbox_
     return tmp;
 }
 
-/* attempt to reserve a contiguous segment from the remote ep */
-static inline bool mca_btl_sm_fbox_sendi(mca_btl_base_endpoint_t *ep, unsigned char tag,
-                                         void *restrict header, const size_t header_size,
-                                         void *restrict payload, const size_t payload_size)
+/* attempt to reserve a contiguous segment from the remote ep. must be called with the
+ * endpoint lock held */
+static inline bool mca_btl_sm_fbox_sendi_locked(mca_btl_base_endpoint_t *ep, unsigned char tag,
+                                                void *restrict header, const size_t header_size,
+                                                void *restrict payload, const size_t payload_size)
 {
     const unsigned int fbox_size = mca_btl_sm_component.fbox_size;
     size_t size = header_size + payload_size;
@@ -125,14 +136,6 @@ static inline bool mca_btl_sm_fbox_sendi(mca_btl_base_endpoint_t *ep, unsigned c
     unsigned char *dst, *data;
     bool hbs, hbm;
 
-    /* don't try to use the per-peer buffer for messages that will fill up more than 25% of the
-     * buffer */
-    if (OPAL_UNLIKELY(NULL == ep->fbox_out.buffer || size > (fbox_size >> 2))) {
-        return false;
-    }
-
-    OPAL_THREAD_LOCK(&ep->lock);
-
     /* the high bit helps determine if the buffer is empty or full */
     hbs = MCA_BTL_SM_FBOX_OFFSET_HBS(ep->fbox_out.end);
     hbm = MCA_BTL_SM_FBOX_OFFSET_HBS(ep->fbox_out.start) == hbs;
@@ -174,7 +177,7 @@ static inline bool mca_btl_sm_fbox_sendi(mca_btl_base_endpoint_t *ep, unsigned c
             mca_btl_sm_fbox_set_header(MCA_BTL_SM_FBOX_HDR(dst), 0xff, ep->fbox_out.seq++,
                                        buffer_free - sizeof(mca_btl_sm_fbox_hdr_t));
 
-            end = MCA_BTL_SM_FBOX_ALIGNMENT;
+            end = MCA_BTL_SM_FBOX_DATA_OFFSET;
             /* toggle the high bit */
             hbs = !hbs;
             /* toggle the high bit match */
@@ -185,7 +188,6 @@ static inline bool mca_btl_sm_fbox_sendi(mca_btl_base_endpoint_t *ep, unsigned c
         if (OPAL_UNLIKELY(buffer_free < size)) {
             ep->fbox_out.end = (hbs << 31) | end;
             opal_atomic_wmb();
-            OPAL_THREAD_UNLOCK(&ep->lock);
             return false;
         }
     }
@@ -208,7 +210,7 @@ static inline bool mca_btl_sm_fbox_sendi(mca_btl_base_endpoint_t *ep, unsigned c
         /* toggle the high bit */
         hbs = !hbs;
         /* reset the end pointer to the beginning of the buffer */
-        end = MCA_BTL_SM_FBOX_ALIGNMENT;
+        end = MCA_BTL_SM_FBOX_DATA_OFFSET;
     } else if (buffer_free > size) {
         MCA_BTL_SM_FBOX_HDR(ep->fbox_out.buffer + end)->ival = 0;
     }
@@ -218,12 +220,59 @@ static inline bool mca_btl_sm_fbox_sendi(mca_btl_base_endpoint_t *ep, unsigned c
 
     /* align the buffer */
     ep->fbox_out.end = ((uint32_t) hbs << 31) | end;
+    ++ep->fbox_out.count;
     opal_atomic_wmb();
-    OPAL_THREAD_UNLOCK(&ep->lock);
 
     return true;
 }
 
+static inline bool mca_btl_sm_fbox_sendi(mca_btl_base_endpoint_t *ep, unsigned char tag,
+                                         void *restrict header, const size_t header_size,
+                                         void *restrict payload, const size_t payload_size)
+{
+    bool ret = false;
+
+    /* don't try to use the per-peer buffer for messages that will fill up more than 25% of the
+     * buffer */
+    if (OPAL_UNLIKELY(NULL == ep->fbox_out.buffer
+                      || header_size + payload_size > (mca_btl_sm_component.fbox_size >> 2))) {
+        return false;
+    }
+
+    OPAL_THREAD_LOCK(&ep->lock);
+    /* nothing can be written after the release marker (see mca_btl_sm_fbox_release) */
+    if (OPAL_LIKELY(NULL != ep->fbox_out.buffer && !ep->fbox_out.reclaim)) {
+        ret = mca_btl_sm_fbox_sendi_locked(ep, tag, header, header_size, payload, payload_size);
+    }
+    OPAL_THREAD_UNLOCK(&ep->lock);
+
+    if (ret) {
+        mca_btl_sm_wake(ep->fifo);
+    }
+
+    return ret;
+}
+
+/**
+ * Return the send fast box of an endpoint. A release marker is written to the fast box,
+ * the receiver stops polling the fast box when it reads the marker and lets the sender
+ * know (see mca_btl_sm_fbox_reclaimed). Until then messages to the peer are queued on
+ * the endpoint to keep them ordered.
+ */
+static inline void mca_btl_sm_fbox_release(mca_btl_base_endpoint_t *ep)
+{
+    fifo_value_t marker = MCA_BTL_SM_FBOX_RELEASE;
+
+    OPAL_THREAD_LOCK(&ep->lock);
+    if (NULL != ep->fbox_out.buffer && !ep->fbox_out.reclaim
+        && mca_btl_sm_fbox_sendi_locked(ep, 0xfe, &marker, sizeof(marker), NULL, 0)) {
+        ep->fbox_out.reclaim = true;
+    }
+    OPAL_THREAD_UNLOCK(&ep->lock);
+
+    mca_btl_sm_wake(ep->fifo);
+}
+
 static inline bool mca_btl_sm_check_fboxes(void)
 {
     const unsigned int fbox_size = mca_btl_sm_component.fbox_size;
@@ -235,6 +284,7 @@ static inline bool mca_btl_sm_check_fboxes(void)
 
         /* save the current high bit state */
         bool hbs = MCA_BTL_SM_FBOX_OFFSET_HBS(ep->fbox_in.start);
+        bool released = false;
         int poll_count;
 
         for (poll_count = 0; poll_count <= MCA_BTL_SM_POLL_COUNT; ++poll_count) {
@@ -279,6 +329,11 @@ static inline bool mca_btl_sm_check_fboxes(void)
             } else if (OPAL_LIKELY(0xfe == hdr.data.tag)) {
                 /* process fragment header */
                 fifo_value_t *value = (fifo_value_t *) (ep->fbox_in.buffer + start + sizeof(hdr));
+                if (OPAL_UNLIKELY(MCA_BTL_SM_FBOX_RELEASE == *value)) {
+                    /* the sender takes the fast box back. nothing follows the marker */
+                    released = true;
+                    break;
+                }
                 mca_btl_sm_hdr_t *sm_hdr = relative2virtual(*value);
                 mca_btl_sm_poll_handle_frag(sm_hdr, ep);
             }
@@ -287,12 +342,31 @@ static inline bool mca_btl_sm_check_fboxes(void)
                     & ~MCA_BTL_SM_FBOX_ALIGNMENT_MASK;
             if (OPAL_UNLIKELY(fbox_size == start)) {
                 /* jump to the beginning of the buffer */
-                start = MCA_BTL_SM_FBOX_ALIGNMENT;
+                start = MCA_BTL_SM_FBOX_DATA_OFFSET;
                 /* toggle the high bit */
                 hbs = !hbs;
             }
         }
 
+        if (OPAL_UNLIKELY(released)) {
+            BTL_VERBOSE(("releasing fast box of peer %d", ep->peer_smp_rank));
+
+            ep->fbox_in.buffer = NULL;
+            mca_btl_sm_component.fbox_in_endpoints[i]
+                = mca_btl_sm_component.fbox_in_endpoints[--mca_btl_sm_component
+                                                             .num_fbox_in_endpoints];
+            /* the swapped in endpoint still has to be polled */
+            --i;
+
+            /* the sender may setup another fast box with this process once it sees the
+             * release */
+            opal_atomic_add_fetch_32(&mca_btl_sm_component.my_fifo->fbox_available, 1);
+            opal_atomic_mb();
+            ep->fbox_in.startp[0] = MCA_BTL_SM_FBOX_RELEASED;
+            processed = true;
+            continue;
+        }
+
         if (poll_count) {
             BTL_VERBOSE(("left off at offset %u (hbs: %d)", start, hbs));
 
@@ -320,7 +394,17 @@ static inline void mca_btl_sm_try_fbox_setup(mca_btl_base_endpoint_t *ep, mca_bt
         if (0 <= opal_atomic_add_fetch_32(&ep->fifo->fbox_available, -1)) {
             opal_free_list_item_t *fbox = opal_free_list_get(&mca_btl_sm_component.sm_fboxes);
 
+            ep->fbox_out.denied = (NULL == fbox);
             if (NULL != fbox) {
+                if (mca_btl_sm_component.fbox_numa_bind && ep->numa_node >= 0
+                    && (ep->remote_numa || mca_btl_sm_component.my_numa_node < 0)) {
+                    /* the receiver polls the fast box so place it in its memory. the free
+                     * fast boxes are on the node of this process when it is known (see
+                     * mca_btl_sm_fbox_reclaimed), otherwise they may be anywhere. */
+                    mca_btl_sm_numa_bind(fbox->ptr, mca_btl_sm_component.fbox_size,
+                                         ep->numa_node);
+                }
+
                 /* zero out the fast box */
                 memset(fbox->ptr, 0, mca_btl_sm_component.fbox_size);
                 mca_btl_sm_endpoint_setup_fbox_send(ep, fbox);
@@ -332,6 +416,9 @@ static inline void mca_btl_sm_try_fbox_setup(mca_btl_base_endpoint_t *ep, mca_bt
             }
 
             opal_atomic_wmb();
+        } else {
+            /* the setup may be tried again once the peer releases a fast box */
+            opal_atomic_add_fetch_32(&ep->fifo->fbox_available, 1);
         }
 
         OPAL_THREAD_UNLOCK(&mca_btl_sm_component.lock);
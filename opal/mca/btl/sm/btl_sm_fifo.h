@@ -56,6 +56,12 @@
 /* large enough to ensure the fifo is on its own cache line */
 #define MCA_BTL_SM_FIFO_SIZE 128
 
+/* the receive fifos of a process are at the beginning of its segment */
+static inline sm_fifo_t *sm_fifo_get(sm_fifo_t *fifos, unsigned int index)
+{
+    return (sm_fifo_t *) ((char *) fifos + index * MCA_BTL_SM_FIFO_SIZE);
+}
+
 /**
  * sm_fifo_read:
  *
@@ -106,15 +112,21 @@ static inline mca_btl_sm_hdr_t *sm_fifo_read(sm_fifo_t *fifo, struct mca_btl_bas
     return hdr;
 }
 
-static inline void sm_fifo_init(sm_fifo_t *fifo)
+static inline void sm_fifo_init(sm_fifo_t *fifos, unsigned int num_fifos)
 {
-    /* due to a compiler bug in Oracle C 5.15 the following line was broken into two. Not
-     * ideal but oh well. See #5814 */
-    /* fifo->fifo_head = fifo->fifo_tail = SM_FIFO_FREE; */
-    fifo->fifo_head = SM_FIFO_FREE;
-    fifo->fifo_tail = SM_FIFO_FREE;
-    fifo->fbox_available = mca_btl_sm_component.fbox_max;
-    mca_btl_sm_component.my_fifo = fifo;
+    for (unsigned int i = 0; i < num_fifos; ++i) {
+        sm_fifo_t *fifo = sm_fifo_get(fifos, i);
+        /* due to a compiler bug in Oracle C 5.15 the following line was broken into two. Not
+         * ideal but oh well. See #5814 */
+        /* fifo->fifo_head = fifo->fifo_tail = SM_FIFO_FREE; */
+        fifo->fifo_head = SM_FIFO_FREE;
+        fifo->fifo_tail = SM_FIFO_FREE;
+        /* the fast box count and the doorbell of the process are in the first fifo */
+        fifo->fbox_available = mca_btl_sm_component.fbox_max;
+        fifo->sleeping = 0;
+        fifo->doorbell = 0;
+    }
+    mca_btl_sm_component.my_fifo = fifos;
 }
 
 static inline void sm_fifo_write(sm_fifo_t *fifo, fifo_value_t value)
@@ -151,6 +163,10 @@ static inline void sm_fifo_write(sm_fifo_t *fifo, fifo_value_t value)
 static inline bool sm_fifo_write_ep(mca_btl_sm_hdr_t *hdr, struct mca_btl_base_endpoint_t *ep)
 {
     fifo_value_t rhdr = virtual2relative((char *) hdr);
+    if (OPAL_UNLIKELY(ep->fbox_out.reclaim) && !mca_btl_sm_fbox_reclaimed(ep)) {
+        /* the peer has not yet processed the messages sent through the fast box */
+        return false;
+    }
     if (ep->fbox_out.buffer) {
         /* if there is a fast box for this peer then use the fast box to send the fragment header.
          * this is done to ensure fragment ordering */
@@ -159,7 +175,13 @@ static inline bool sm_fifo_write_ep(mca_btl_sm_hdr_t *hdr, struct mca_btl_base_e
     }
     mca_btl_sm_try_fbox_setup(ep, hdr);
     hdr->next = SM_FIFO_FREE;
-    sm_fifo_write(ep->fifo, rhdr);
+    /* fast box setups always go through the first fifo (see mca_btl_sm_component_progress) */
+    sm_fifo_write(sm_fifo_get(ep->fifo, (hdr->flags & MCA_BTL_SM_FLAG_SETUP_FBOX)
+                                            ? 0
+                                            : mca_btl_sm_fifo_index(hdr->frag->base.order,
+                                                                    ep->num_fifos)),
+                  rhdr);
+    mca_btl_sm_wake(ep->fifo);
 
     return true;
 }
@@ -178,7 +200,9 @@ static inline bool sm_fifo_write_ep(mca_btl_sm_hdr_t *hdr, struct mca_btl_base_e
 static inline void sm_fifo_write_back(mca_btl_sm_hdr_t *hdr, struct mca_btl_base_endpoint_t *ep)
 {
     hdr->next = SM_FIFO_FREE;
-    sm_fifo_write(ep->fifo, virtual2relativepeer(ep, (char *) hdr));
+    sm_fifo_write(sm_fifo_get(ep->fifo, mca_btl_sm_fifo_index(MCA_BTL_NO_ORDER, ep->num_fifos)),
+                  virtual2relativepeer(ep, (char *) hdr));
+    mca_btl_sm_wake(ep->fifo);
 }
 
 #endif /* MCA_BTL_SM_FIFO_H */
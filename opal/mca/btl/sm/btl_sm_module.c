@@ -30,6 +30,7 @@
 
 #include "opal_config.h"
 #include "opal/util/show_help.h"
+#include "opal/util/sys_limits.h"
 
 #include "opal/mca/btl/sm/btl_sm.h"
 #include "opal/mca/btl/sm/btl_sm_endpoint.h"
@@ -88,6 +89,7 @@ static void sm_btl_exit(mca_btl_sm_t *btl)
 static int sm_btl_first_time_init(mca_btl_sm_t *sm_btl, int n)
 {
     mca_btl_sm_component_t *component = &mca_btl_sm_component;
+    size_t fbox_alignment = opal_cache_line_size;
     int rc;
 
     /* generate the endpoints */
@@ -105,18 +107,28 @@ static int sm_btl_first_time_init(mca_btl_sm_t *sm_btl, int n)
     }
 
     component->mpool = mca_mpool_basic_create((void *) (component->my_segment
-                                                        + MCA_BTL_SM_FIFO_SIZE),
+                                                        + component->num_fifos
+                                                              * MCA_BTL_SM_FIFO_SIZE),
                                               (unsigned long) (mca_btl_sm_component.segment_size
-                                                               - MCA_BTL_SM_FIFO_SIZE),
+                                                               - component->num_fifos
+                                                                     * MCA_BTL_SM_FIFO_SIZE),
                                               64);
     if (NULL == component->mpool) {
         free(component->endpoints);
         return OPAL_ERR_OUT_OF_RESOURCE;
     }
 
+    /* fast boxes are bound to the NUMA node of the receiver so they can not share pages.
+     * when the size is not a multiple of the page size they are left unbound. */
+    component->fbox_numa_bind = component->numa_placement
+                                && 0 == component->fbox_size % opal_getpagesize();
+    if (component->fbox_numa_bind) {
+        fbox_alignment = opal_getpagesize();
+    }
+
     rc = opal_free_list_init(&component->sm_fboxes, sizeof(opal_free_list_item_t), 8,
                              OBJ_CLASS(opal_free_list_item_t), mca_btl_sm_component.fbox_size,
-                             opal_cache_line_size, 0, mca_btl_sm_component.fbox_max, 4,
+                             fbox_alignment, 0, mca_btl_sm_component.fbox_max, 4,
                              component->mpool, 0, NULL, NULL, NULL);
     if (OPAL_SUCCESS != rc) {
         return rc;
@@ -195,6 +207,8 @@ static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal
     OBJ_CONSTRUCT(ep, mca_btl_sm_endpoint_t);
 
     ep->peer_smp_rank = peer_local_rank;
+    ep->numa_node = component->my_numa_node;
+    ep->num_fifos = component->num_fifos;
 
     if (peer_local_rank != MCA_BTL_SM_LOCAL_RANK) {
         OPAL_MODEX_RECV_IMMEDIATE(rc, &component->super.btl_version, &proc->proc_name,
@@ -210,6 +224,8 @@ static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal
             ep->segment_data.xpmem.apid = xpmem_get(modex->xpmem.seg_id, XPMEM_RDWR,
                                                     XPMEM_PERMIT_MODE, (void *) 0666);
             ep->segment_data.xpmem.address_max = modex->xpmem.address_max;
+            ep->numa_node = modex->xpmem.numa_node;
+            ep->num_fifos = modex->xpmem.num_fifos;
             (void) sm_get_registation(ep, modex->xpmem.segment_base,
                                       mca_btl_sm_component.segment_size, MCA_RCACHE_FLAGS_PERSIST,
                                       (void **) &ep->segment_base);
@@ -222,6 +238,8 @@ static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal
             }
 
             memcpy(ep->segment_data.other.seg_ds, &modex->other.seg_ds, modex->other.seg_ds_size);
+            ep->numa_node = modex->other.numa_node;
+            ep->num_fifos = modex->other.num_fifos;
 
             ep->segment_base = opal_shmem_segment_attach(ep->segment_data.other.seg_ds);
             if (NULL == ep->segment_base) {
@@ -269,6 +287,9 @@ static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal
 #endif
         OBJ_CONSTRUCT(&ep->lock, opal_mutex_t);
 
+        ep->remote_numa = 0 <= ep->numa_node && 0 <= component->my_numa_node
+                          && ep->numa_node != component->my_numa_node;
+
         free(modex);
     } else {
         /* set up the segment base so we can calculate a virtual to real for local pointers */
@@ -586,6 +607,9 @@ static void mca_btl_sm_endpoint_constructor(mca_btl_sm_endpoint_t *ep)
     OBJ_CONSTRUCT(&ep->pending_frags_lock, opal_mutex_t);
     ep->fifo = NULL;
     ep->fbox_out.fbox = NULL;
+    ep->fbox_out.count = 0;
+    ep->fbox_out.reclaim = false;
+    ep->fbox_out.denied = false;
 }
 
 #if OPAL_BTL_SM_HAVE_XPMEM
@@ -76,6 +76,17 @@ int mca_btl_sm_put_cma(mca_btl_base_module_t *btl, mca_btl_base_endpoint_t *endp
     struct iovec src_iov = {.iov_base = local_address, .iov_len = size};
     struct iovec dst_iov = {.iov_base = (void *) (intptr_t) remote_address, .iov_len = size};
     ssize_t ret;
+    int rc;
+
+    rc = mca_btl_sm_cma_copy_mt(endpoint, true, local_address, (void *) (intptr_t) remote_address,
+                                size);
+    if (OPAL_ERR_NOT_SUPPORTED != rc) {
+        if (OPAL_SUCCESS != rc) {
+            return rc;
+        }
+        cbfunc(btl, endpoint, local_address, local_handle, cbcontext, cbdata, OPAL_SUCCESS);
+        return OPAL_SUCCESS;
+    }
 
     /* This should not be needed, see the rationale in mca_btl_sm_get_cma() */
     do {
@@ -61,6 +61,7 @@ int mca_btl_sm_sendi(struct mca_btl_base_module_t *btl, struct mca_btl_base_endp
 
     if (!(payload_size && opal_convertor_need_buffers(convertor))
         && mca_btl_sm_fbox_sendi(endpoint, tag, header, header_size, data_ptr, payload_size)) {
+        mca_btl_sm_account_send(endpoint, header_size + payload_size);
         return OPAL_SUCCESS;
     }
 
@@ -111,5 +112,7 @@ int mca_btl_sm_sendi(struct mca_btl_base_module_t *btl, struct mca_btl_base_endp
         return OPAL_ERR_OUT_OF_RESOURCE;
     }
 
+    mca_btl_sm_account_send(endpoint, header_size + payload_size);
+
     return OPAL_SUCCESS;
 }
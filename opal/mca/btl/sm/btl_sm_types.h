@@ -35,6 +35,7 @@
 #include "opal_config.h"
 #include "opal/class/opal_free_list.h"
 #include "opal/mca/btl/btl.h"
+#include "opal/mca/timer/base/base.h"
 
 #if OPAL_BTL_SM_HAVE_XPMEM
 
@@ -59,10 +60,14 @@ union sm_modex_t {
         xpmem_segid_t seg_id;
         void *segment_base;
         uintptr_t address_max;
+        int numa_node;
+        int num_fifos;
     } xpmem;
 #endif
     struct sm_modex_other_t {
         ino_t user_ns_id;
+        int numa_node;
+        int num_fifos;
         int seg_ds_size;
         /* seg_ds needs to be the last element */
         opal_shmem_ds_t seg_ds;
@@ -96,15 +101,22 @@ typedef struct mca_btl_base_endpoint_t {
         unsigned int start, end;
         uint16_t seq;
         opal_free_list_item_t *fbox; /**< fast-box free list item */
+        unsigned int count;          /**< messages sent since the last fast box evaluation */
+        bool reclaim;                /**< release marker written, waiting for the peer */
+        bool denied;                 /**< last setup failed for lack of fast boxes */
     } fbox_out;
 
     uint16_t peer_smp_rank;        /**< my peer's SMP process rank.  Used for accessing
                                     *   SMP specfic data structures. */
     opal_atomic_size_t send_count; /**< number of fragments sent to this peer */
+    size_t bytes_sent;             /**< number of bytes sent to this peer (not atomic) */
+    int numa_node;                 /**< NUMA node of the peer (-1 if unknown) */
+    bool remote_numa;              /**< peer is on a different NUMA node than this process */
     char *segment_base;            /**< start of the peer's segment (in the address space
                                     *   of this process) */
 
-    struct sm_fifo_t *fifo; /**< */
+    struct sm_fifo_t *fifo; /**< first receive fifo of the peer */
+    unsigned int num_fifos; /**< number of receive fifos of the peer */
 
     opal_mutex_t lock; /**< lock to protect endpoint structures from concurrent
                         *   access */
@@ -159,6 +171,16 @@ struct mca_btl_sm_component_t {
         fbox_threshold; /**< number of sends required before we setup a send fast box for a peer */
     unsigned int fbox_max;  /**< maximum number of send fast boxes to allocate */
     unsigned int fbox_size; /**< size of each peer fast box allocation */
+    unsigned int fbox_reclaim_interval; /**< interval (usec) between fast box evaluations */
+    opal_timer_t fbox_last_evaluation;  /**< time of the last fast box evaluation */
+
+    bool blocking_wait;           /**< sleep on the doorbell when there is nothing to do */
+    unsigned int wait_spin_count; /**< number of idle polls before sleeping */
+    unsigned int wait_timeout;    /**< maximum time (usec) to sleep */
+
+    bool numa_placement; /**< bind the fast boxes to the NUMA node of the receiving peer */
+    bool fbox_numa_bind; /**< the fast boxes own whole pages and can be bound */
+    int my_numa_node;    /**< NUMA node of this process (-1 if unknown) */
 
     int single_copy_mechanism; /**< single copy mechanism to use */
 
@@ -170,13 +192,21 @@ struct mca_btl_sm_component_t {
         *endpoints; /**< array of local endpoints (one for each local peer including myself) */
     mca_btl_base_endpoint_t **fbox_in_endpoints; /**< array of fast box in endpoints */
     unsigned int num_fbox_in_endpoints;          /**< number of fast boxes to poll */
-    struct sm_fifo_t *my_fifo;                   /**< pointer to the local fifo */
+    struct sm_fifo_t *my_fifo;                   /**< pointer to the first local fifo */
+    unsigned int num_fifos;                      /**< number of local receive fifos */
+    opal_atomic_int32_t *fifo_locks;             /**< reader locks of the local fifos */
+    opal_atomic_int32_t num_threads;             /**< threads that picked a fifo */
 
     opal_list_t pending_endpoints; /**< list of endpoints with pending fragments */
     opal_list_t pending_fragments; /**< fragments pending remote completion */
 
     char *backing_directory; /**< directory to place shared memory backing files */
 
+#if OPAL_BTL_SM_HAVE_CMA
+    size_t cma_parallel_threshold; /**< minimum size of a CMA transfer split across threads */
+    size_t cma_chunk_size;         /**< size of the pieces of a split CMA transfer */
+#endif
+
     /* knem stuff */
 #if OPAL_BTL_SM_HAVE_KNEM
     unsigned int knem_dma_min; /**< minimum size to enable DMA for knem transfers (0 disables) */
@@ -294,11 +324,20 @@ typedef struct mca_btl_sm_registration_handle_t mca_btl_sm_registration_handle_t
 typedef opal_atomic_intptr_t atomic_fifo_value_t;
 typedef intptr_t fifo_value_t;
 
-/* lock free fifo */
+/* maximum number of receive fifos per process */
+#define MCA_BTL_SM_MAX_FIFOS 64
+
+/* lock free fifo. the head is polled by the receiver and the tail is
+ * swapped by the senders so keep them on separate cache lines */
+#define MCA_BTL_SM_CACHE_LINE_SIZE 64
+
 struct sm_fifo_t {
     atomic_fifo_value_t fifo_head;
+    char padding[MCA_BTL_SM_CACHE_LINE_SIZE - sizeof(atomic_fifo_value_t)];
     atomic_fifo_value_t fifo_tail;
     opal_atomic_int32_t fbox_available;
+    opal_atomic_int32_t sleeping; /**< the receiver waits on the doorbell */
+    opal_atomic_int32_t doorbell; /**< futex rung by the senders to wake up the receiver */
 };
 typedef struct sm_fifo_t sm_fifo_t;
 
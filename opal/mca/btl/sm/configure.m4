@@ -21,7 +21,7 @@
 AC_DEFUN([MCA_opal_btl_sm_CONFIG],[
     AC_CONFIG_FILES([opal/mca/btl/sm/Makefile])
 
-    OPAL_VAR_SCOPE_PUSH([btl_sm_xpmem_happy btl_sm_cma_happy btl_sm_knem_happy])
+    OPAL_VAR_SCOPE_PUSH([btl_sm_xpmem_happy btl_sm_cma_happy btl_sm_knem_happy btl_sm_futex_happy])
 
     # Check for single-copy APIs
 
@@ -38,6 +38,13 @@ AC_DEFUN([MCA_opal_btl_sm_CONFIG],[
     AC_DEFINE_UNQUOTED([OPAL_BTL_SM_HAVE_KNEM], [$btl_sm_knem_happy],
 	[If KNEM support can be enabled within sm])
 
+    # Check for futexes (blocking wait)
+    btl_sm_futex_happy=1
+    AC_CHECK_HEADERS([linux/futex.h sys/syscall.h], [], [btl_sm_futex_happy=0])
+
+    AC_DEFINE_UNQUOTED([OPAL_BTL_SM_HAVE_FUTEX], [$btl_sm_futex_happy],
+        [If futexes can be used for the blocking wait within sm])
+
     OPAL_VAR_SCOPE_POP
 
     # always happy
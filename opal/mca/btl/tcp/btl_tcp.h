@@ -133,6 +133,10 @@ struct mca_btl_tcp_component_t {
     opal_free_list_t tcp_frag_user;
 
     int tcp_enable_progress_thread; /** Support for tcp progress thread flag */
+#if OPAL_BTL_TCP_HAVE_IO_URING
+    bool tcp_io_uring;                 /**< drive the connected sockets with io_uring */
+    unsigned int tcp_io_uring_entries; /**< size of the io_uring submission queue */
+#endif /* OPAL_BTL_TCP_HAVE_IO_URING */
 
     opal_event_t tcp_recv_thread_async_event;
     opal_mutex_t tcp_frag_eager_mutex;
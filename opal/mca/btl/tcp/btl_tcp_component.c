@@ -85,6 +85,7 @@
 #include "btl_tcp_endpoint.h"
 #include "btl_tcp_frag.h"
 #include "btl_tcp_proc.h"
+#include "btl_tcp_uring.h"
 #include "opal/constants.h"
 #include "opal/mca/btl/base/base.h"
 #include "opal/mca/btl/base/btl_base_error.h"
@@ -309,6 +310,20 @@ static int mca_btl_tcp_component_register(void)
     /* Check if we should support async progress */
     mca_btl_tcp_param_register_int("progress_thread", NULL, 0, OPAL_INFO_LVL_1,
                                    &mca_btl_tcp_component.tcp_enable_progress_thread);
+#if OPAL_BTL_TCP_HAVE_IO_URING
+    mca_btl_tcp_component.tcp_io_uring = false;
+    (void) mca_base_component_var_register(
+        &mca_btl_tcp_component.super.btl_version, "io_uring",
+        "Send and receive on the connected sockets through io_uring instead of libevent. The "
+        "transfers of all the peers are submitted in batches and their completions reaped by "
+        "the progress function, saving most of the system calls of small messages. Not used "
+        "with the progress thread (default: false)",
+        MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0, OPAL_INFO_LVL_4, MCA_BASE_VAR_SCOPE_READONLY,
+        &mca_btl_tcp_component.tcp_io_uring);
+    mca_btl_tcp_param_register_uint(
+        "io_uring_entries", "Number of entries of the io_uring submission queue (default: 256)",
+        256, OPAL_INFO_LVL_5, &mca_btl_tcp_component.tcp_io_uring_entries);
+#endif /* OPAL_BTL_TCP_HAVE_IO_URING */
     mca_btl_tcp_component.report_all_unfound_interfaces = false;
     (void) mca_base_component_var_register(
         &mca_btl_tcp_component.super.btl_version, "warn_all_unfound_interfaces",
@@ -467,6 +482,11 @@ static int mca_btl_tcp_component_close(void)
         OBJ_RELEASE(event);
     }
 
+#if OPAL_BTL_TCP_HAVE_IO_URING
+    mca_btl_tcp_uring_fini();
+    mca_btl_tcp_component.super.btl_progress = NULL;
+#endif /* OPAL_BTL_TCP_HAVE_IO_URING */
+
     opal_proc_table_remove_value(&mca_btl_tcp_component.tcp_procs,
                                  opal_proc_local_get()->proc_name);
 
@@ -1285,6 +1305,19 @@ mca_btl_base_module_t **mca_btl_tcp_component_init(int *num_btl_modules,
         return NULL;
     }
 
+#if OPAL_BTL_TCP_HAVE_IO_URING
+    /* The io_uring engine is progressed by the progress function of the
+     * component, the sockets handled by the progress thread stay with it. */
+    if (mca_btl_tcp_component.tcp_io_uring) {
+        if (mca_btl_tcp_event_base != opal_sync_event_base) {
+            opal_output_verbose(1, opal_btl_base_framework.framework_output,
+                                "btl:tcp: io_uring is not used with the progress thread");
+        } else if (OPAL_SUCCESS == mca_btl_tcp_uring_init()) {
+            mca_btl_tcp_component.super.btl_progress = mca_btl_tcp_uring_progress;
+        }
+    }
+#endif /* OPAL_BTL_TCP_HAVE_IO_URING */
+
     /* Register the btl to support the progress_thread */
     if (0 < mca_btl_tcp_progress_thread_trigger) {
         for (i = 0; i < mca_btl_tcp_component.tcp_num_btls; i++) {
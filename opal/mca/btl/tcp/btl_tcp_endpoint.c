@@ -66,6 +66,7 @@
 #include "btl_tcp_endpoint.h"
 #include "btl_tcp_frag.h"
 #include "btl_tcp_proc.h"
+#include "btl_tcp_uring.h"
 
 /*
  * Magic ID string send during connect/accept handshake
@@ -94,6 +95,11 @@ static void mca_btl_tcp_endpoint_construct(mca_btl_tcp_endpoint_t *endpoint)
     endpoint->endpoint_cache_pos = NULL;
     endpoint->endpoint_cache_length = 0;
 #endif /* MCA_BTL_TCP_ENDPOINT_CACHE */
+#if OPAL_BTL_TCP_HAVE_IO_URING
+    endpoint->endpoint_uring = false;
+    endpoint->endpoint_uring_send = NULL;
+    endpoint->endpoint_uring_recv = NULL;
+#endif /* OPAL_BTL_TCP_HAVE_IO_URING */
     OBJ_CONSTRUCT(&endpoint->endpoint_frags, opal_list_t);
     OBJ_CONSTRUCT(&endpoint->endpoint_send_lock, opal_mutex_t);
     OBJ_CONSTRUCT(&endpoint->endpoint_recv_lock, opal_mutex_t);
@@ -363,6 +369,15 @@ int mca_btl_tcp_endpoint_send(mca_btl_base_endpoint_t *btl_endpoint, mca_btl_tcp
         break;
     case MCA_BTL_TCP_CONNECTED:
         if (NULL == btl_endpoint->endpoint_send_frag) {
+#if OPAL_BTL_TCP_HAVE_IO_URING
+            if (btl_endpoint->endpoint_uring) {
+                /* submitted with the next batch */
+                btl_endpoint->endpoint_send_frag = frag;
+                frag->base.des_flags |= MCA_BTL_DES_SEND_ALWAYS_CALLBACK;
+                mca_btl_tcp_uring_send(btl_endpoint);
+                break;
+            }
+#endif /* OPAL_BTL_TCP_HAVE_IO_URING */
             if (frag->base.des_flags & MCA_BTL_DES_FLAGS_PRIORITY
                 && mca_btl_tcp_frag_send(frag, btl_endpoint->endpoint_sd)) {
                 int btl_ownership = (frag->base.des_flags & MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
@@ -534,6 +549,11 @@ void mca_btl_tcp_endpoint_close(mca_btl_base_endpoint_t *btl_endpoint)
         return;
     }
     btl_endpoint->endpoint_retries++;
+#if OPAL_BTL_TCP_HAVE_IO_URING
+    if (btl_endpoint->endpoint_uring) {
+        mca_btl_tcp_uring_close(btl_endpoint);
+    }
+#endif /* OPAL_BTL_TCP_HAVE_IO_URING */
     MCA_BTL_TCP_ENDPOINT_DUMP(1, btl_endpoint, false, "event_del(recv) [close]");
     opal_event_del(&btl_endpoint->endpoint_recv_event);
     if (mca_btl_tcp_event_base == opal_sync_event_base) {
@@ -608,6 +628,13 @@ static void mca_btl_tcp_endpoint_connected(mca_btl_base_endpoint_t *btl_endpoint
     btl_endpoint->endpoint_retries = 0;
     MCA_BTL_TCP_ENDPOINT_DUMP(1, btl_endpoint, true, "READY [endpoint_connected]");
 
+#if OPAL_BTL_TCP_HAVE_IO_URING
+    /* the engine also starts the pending sends */
+    if (mca_btl_tcp_uring_enabled() && OPAL_SUCCESS == mca_btl_tcp_uring_start(btl_endpoint)) {
+        return;
+    }
+#endif /* OPAL_BTL_TCP_HAVE_IO_URING */
+
     if (opal_list_get_size(&btl_endpoint->endpoint_frags) > 0) {
         if (NULL == btl_endpoint->endpoint_send_frag) {
             btl_endpoint->endpoint_send_frag = (mca_btl_tcp_frag_t *) opal_list_remove_first(
@@ -935,6 +962,65 @@ static int mca_btl_tcp_endpoint_complete_connect(mca_btl_base_endpoint_t *btl_en
     return OPAL_ERROR;
 }
 
+/*
+ * Receive and deliver the fragments of a connected endpoint. Without a
+ * socket (sd < 0, io_uring engine) only the data already in the endpoint
+ * cache is consumed. Called with the recv lock held.
+ */
+void mca_btl_tcp_endpoint_recv_frags(mca_btl_base_endpoint_t *btl_endpoint, int sd)
+{
+    mca_btl_tcp_frag_t *frag;
+
+    frag = btl_endpoint->endpoint_recv_frag;
+    if (NULL == frag) {
+        if (mca_btl_tcp_module.super.btl_max_send_size > mca_btl_tcp_module.super.btl_eager_limit) {
+            MCA_BTL_TCP_FRAG_ALLOC_MAX(frag);
+        } else {
+            MCA_BTL_TCP_FRAG_ALLOC_EAGER(frag);
+        }
+
+        if (NULL == frag) {
+            return;
+        }
+        MCA_BTL_TCP_FRAG_INIT_DST(frag, btl_endpoint);
+    }
+
+#if MCA_BTL_TCP_ENDPOINT_CACHE
+    assert(sd < 0 || 0 == btl_endpoint->endpoint_cache_length);
+data_still_pending_on_endpoint:
+#endif /* MCA_BTL_TCP_ENDPOINT_CACHE */
+    /* check for completion of non-blocking recv on the current fragment */
+    if (mca_btl_tcp_frag_recv(frag, sd) == false) {
+        btl_endpoint->endpoint_recv_frag = frag;
+    } else {
+        btl_endpoint->endpoint_recv_frag = NULL;
+        if (MCA_BTL_TCP_HDR_TYPE_SEND == frag->hdr.type) {
+            mca_btl_active_message_callback_t *reg = mca_btl_base_active_message_trigger
+                                                     + frag->hdr.base.tag;
+            const mca_btl_base_receive_descriptor_t desc
+                = {.endpoint = btl_endpoint,
+                   .des_segments = frag->base.des_segments,
+                   .des_segment_count = frag->base.des_segment_count,
+                   .tag = frag->hdr.base.tag,
+                   .cbdata = reg->cbdata};
+            reg->cbfunc(&frag->btl->super, &desc);
+        }
+#if MCA_BTL_TCP_ENDPOINT_CACHE
+        if (0 != btl_endpoint->endpoint_cache_length) {
+            /* If the cache still contain some data we can reuse the same fragment
+             * until we flush it completly.
+             */
+            MCA_BTL_TCP_FRAG_INIT_DST(frag, btl_endpoint);
+            goto data_still_pending_on_endpoint;
+        }
+#endif /* MCA_BTL_TCP_ENDPOINT_CACHE */
+        MCA_BTL_TCP_FRAG_RETURN(frag);
+    }
+#if MCA_BTL_TCP_ENDPOINT_CACHE
+    assert(0 == btl_endpoint->endpoint_cache_length);
+#endif /* MCA_BTL_TCP_ENDPOINT_CACHE */
+}
+
 /*
  * A file descriptor is available/ready for recv. Check the state
  * of the socket and take the appropriate action.
@@ -1005,62 +1091,10 @@ static void mca_btl_tcp_endpoint_recv_handler(int sd, short flags, void *user)
         OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_recv_lock);
         return;
     }
-    case MCA_BTL_TCP_CONNECTED: {
-        mca_btl_tcp_frag_t *frag;
-
-        frag = btl_endpoint->endpoint_recv_frag;
-        if (NULL == frag) {
-            if (mca_btl_tcp_module.super.btl_max_send_size
-                > mca_btl_tcp_module.super.btl_eager_limit) {
-                MCA_BTL_TCP_FRAG_ALLOC_MAX(frag);
-            } else {
-                MCA_BTL_TCP_FRAG_ALLOC_EAGER(frag);
-            }
-
-            if (NULL == frag) {
-                OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_recv_lock);
-                return;
-            }
-            MCA_BTL_TCP_FRAG_INIT_DST(frag, btl_endpoint);
-        }
-
-#if MCA_BTL_TCP_ENDPOINT_CACHE
-        assert(0 == btl_endpoint->endpoint_cache_length);
-    data_still_pending_on_endpoint:
-#endif /* MCA_BTL_TCP_ENDPOINT_CACHE */
-        /* check for completion of non-blocking recv on the current fragment */
-        if (mca_btl_tcp_frag_recv(frag, btl_endpoint->endpoint_sd) == false) {
-            btl_endpoint->endpoint_recv_frag = frag;
-        } else {
-            btl_endpoint->endpoint_recv_frag = NULL;
-            if (MCA_BTL_TCP_HDR_TYPE_SEND == frag->hdr.type) {
-                mca_btl_active_message_callback_t *reg = mca_btl_base_active_message_trigger
-                                                         + frag->hdr.base.tag;
-                const mca_btl_base_receive_descriptor_t desc
-                    = {.endpoint = btl_endpoint,
-                       .des_segments = frag->base.des_segments,
-                       .des_segment_count = frag->base.des_segment_count,
-                       .tag = frag->hdr.base.tag,
-                       .cbdata = reg->cbdata};
-                reg->cbfunc(&frag->btl->super, &desc);
-            }
-#if MCA_BTL_TCP_ENDPOINT_CACHE
-            if (0 != btl_endpoint->endpoint_cache_length) {
-                /* If the cache still contain some data we can reuse the same fragment
-                 * until we flush it completly.
-                 */
-                MCA_BTL_TCP_FRAG_INIT_DST(frag, btl_endpoint);
-                goto data_still_pending_on_endpoint;
-            }
-#endif /* MCA_BTL_TCP_ENDPOINT_CACHE */
-            MCA_BTL_TCP_FRAG_RETURN(frag);
-        }
-#if MCA_BTL_TCP_ENDPOINT_CACHE
-        assert(0 == btl_endpoint->endpoint_cache_length);
-#endif /* MCA_BTL_TCP_ENDPOINT_CACHE */
+    case MCA_BTL_TCP_CONNECTED:
+        mca_btl_tcp_endpoint_recv_frags(btl_endpoint, btl_endpoint->endpoint_sd);
         OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_recv_lock);
         break;
-    }
     case MCA_BTL_TCP_CLOSED:
         /* This is a thread-safety issue. As multiple threads are allowed
          * to generate events (in the lib event) we endup with several
@@ -72,6 +72,11 @@ struct mca_btl_base_endpoint_t {
     opal_event_t endpoint_send_event;   /**< event for async processing of send frags */
     opal_event_t endpoint_recv_event;   /**< event for async processing of recv frags */
     bool endpoint_nbo;                  /**< convert headers to network byte order? */
+#if OPAL_BTL_TCP_HAVE_IO_URING
+    bool endpoint_uring; /**< the connected socket is driven by the io_uring engine */
+    struct mca_btl_tcp_uring_op_t *endpoint_uring_send; /**< io_uring send operation */
+    struct mca_btl_tcp_uring_op_t *endpoint_uring_recv; /**< io_uring receive operation */
+#endif /* OPAL_BTL_TCP_HAVE_IO_URING */
 };
 
 typedef struct mca_btl_base_endpoint_t mca_btl_base_endpoint_t;
@@ -91,6 +96,7 @@ void mca_btl_tcp_endpoint_close(mca_btl_base_endpoint_t *);
 int mca_btl_tcp_endpoint_send(mca_btl_base_endpoint_t *, struct mca_btl_tcp_frag_t *);
 void mca_btl_tcp_endpoint_accept(mca_btl_base_endpoint_t *, struct sockaddr *, int);
 void mca_btl_tcp_endpoint_shutdown(mca_btl_base_endpoint_t *);
+void mca_btl_tcp_endpoint_recv_frags(mca_btl_base_endpoint_t *, int sd);
 
 /*
  * Diagnostics: change this to "1" to enable the function
@@ -202,6 +202,11 @@ repeat:
     num_vecs++;
 #endif /* MCA_BTL_TCP_ENDPOINT_CACHE */
 
+    /* the io_uring engine receives in the endpoint cache, only consume it */
+    if (sd < 0) {
+        return false;
+    }
+
     /* non-blocking read, but continue if interrupted */
     do {
         cnt = readv(sd, frag->iov_ptr, num_vecs);
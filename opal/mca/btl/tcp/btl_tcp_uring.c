@@ -0,0 +1,751 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include "btl_tcp_uring.h"
+
+#if OPAL_BTL_TCP_HAVE_IO_URING
+
+#    include <errno.h>
+#    include <linux/io_uring.h>
+#    include <poll.h>
+#    include <stdlib.h>
+#    include <string.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+
+#    include "opal/mca/btl/base/btl_base_error.h"
+#    include "opal/runtime/opal_progress.h"
+#    include "opal/util/output.h"
+#    include "opal/util/proc.h"
+#    include "opal/util/show_help.h"
+
+#    include "btl_tcp.h"
+#    include "btl_tcp_endpoint.h"
+#    include "btl_tcp_frag.h"
+#    include "btl_tcp_proc.h"
+
+#    if !MCA_BTL_TCP_ENDPOINT_CACHE
+#        error "the io_uring engine receives in the endpoint cache"
+#    endif
+
+/* Completions processed by a call to the progress function */
+#    define MCA_BTL_TCP_URING_REAP_MAX 64
+
+/* What an operation is waiting for */
+typedef enum {
+    MCA_BTL_TCP_URING_STEP_IO,   /* the sendmsg or the recv */
+    MCA_BTL_TCP_URING_STEP_POLL, /* readiness of the socket, after an EAGAIN */
+    MCA_BTL_TCP_URING_STEP_NOP,  /* another look at the data left in the cache */
+} mca_btl_tcp_uring_step_t;
+
+typedef struct {
+    int fd;
+    unsigned int entries;
+    /* submission queue, shared with the kernel */
+    volatile unsigned int *sq_head;
+    volatile unsigned int *sq_tail;
+    unsigned int sq_mask;
+    unsigned int *sq_array;
+    struct io_uring_sqe *sqes;
+    /* completion queue, shared with the kernel */
+    volatile unsigned int *cq_head;
+    volatile unsigned int *cq_tail;
+    unsigned int cq_mask;
+    struct io_uring_cqe *cqes;
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+    /* entries filled but not yet handed to the kernel */
+    unsigned int to_submit;
+    /* operations waiting for room in the submission queue */
+    mca_btl_tcp_uring_op_t *deferred_head;
+    mca_btl_tcp_uring_op_t *deferred_tail;
+    /* operations of closed endpoints not released yet */
+    mca_btl_tcp_uring_op_t *detached;
+    opal_mutex_t lock;
+} mca_btl_tcp_uring_t;
+
+static mca_btl_tcp_uring_t mca_btl_tcp_uring = {
+    .fd = -1,
+    .lock = OPAL_MUTEX_STATIC_INIT,
+};
+
+static inline int mca_btl_tcp_uring_sys_setup(unsigned int entries, struct io_uring_params *params)
+{
+    return (int) syscall(__NR_io_uring_setup, entries, params);
+}
+
+static inline int mca_btl_tcp_uring_sys_enter(int fd, unsigned int to_submit,
+                                              unsigned int min_complete, unsigned int flags)
+{
+    return (int) syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+bool mca_btl_tcp_uring_enabled(void)
+{
+    return 0 <= mca_btl_tcp_uring.fd;
+}
+
+int mca_btl_tcp_uring_init(void)
+{
+    mca_btl_tcp_uring_t *ring = &mca_btl_tcp_uring;
+    struct io_uring_params params;
+    char *sq_ring, *cq_ring;
+
+    if (0 >= mca_btl_tcp_component.tcp_endpoint_cache) {
+        opal_output_verbose(10, opal_btl_base_framework.framework_output,
+                            "btl:tcp: the io_uring engine needs the endpoint cache");
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+
+    memset(&params, 0, sizeof(params));
+    ring->fd = mca_btl_tcp_uring_sys_setup(mca_btl_tcp_component.tcp_io_uring_entries, &params);
+    if (0 > ring->fd) {
+        opal_output_verbose(1, opal_btl_base_framework.framework_output,
+                            "btl:tcp: io_uring_setup failed: %s (%d), using libevent",
+                            strerror(errno), errno);
+        ring->fd = -1;
+        return OPAL_ERR_NOT_AVAILABLE;
+    }
+    /* without it a completion queue overflow loses completions */
+    if (!(params.features & IORING_FEAT_NODROP)) {
+        opal_output_verbose(1, opal_btl_base_framework.framework_output,
+                            "btl:tcp: io_uring without IORING_FEAT_NODROP, using libevent");
+        close(ring->fd);
+        ring->fd = -1;
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    ring->sqes = (struct io_uring_sqe *) mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                                              MAP_SHARED | MAP_POPULATE, ring->fd,
+                                              IORING_OFF_SQES);
+    if (MAP_FAILED == ring->sq_ring || MAP_FAILED == ring->cq_ring
+        || MAP_FAILED == (void *) ring->sqes) {
+        BTL_ERROR(("mmap of the io_uring queues failed: %s (%d)", strerror(errno), errno));
+        if (MAP_FAILED != ring->sq_ring) {
+            munmap(ring->sq_ring, ring->sq_ring_size);
+        }
+        if (MAP_FAILED != ring->cq_ring) {
+            munmap(ring->cq_ring, ring->cq_ring_size);
+        }
+        if (MAP_FAILED != (void *) ring->sqes) {
+            munmap(ring->sqes, ring->sqes_size);
+        }
+        close(ring->fd);
+        ring->fd = -1;
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    sq_ring = (char *) ring->sq_ring;
+    ring->sq_head = (volatile unsigned int *) (sq_ring + params.sq_off.head);
+    ring->sq_tail = (volatile unsigned int *) (sq_ring + params.sq_off.tail);
+    ring->sq_mask = *(unsigned int *) (sq_ring + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned int *) (sq_ring + params.sq_off.array);
+    ring->entries = params.sq_entries;
+
+    cq_ring = (char *) ring->cq_ring;
+    ring->cq_head = (volatile unsigned int *) (cq_ring + params.cq_off.head);
+    ring->cq_tail = (volatile unsigned int *) (cq_ring + params.cq_off.tail);
+    ring->cq_mask = *(unsigned int *) (cq_ring + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *) (cq_ring + params.cq_off.cqes);
+
+    ring->to_submit = 0;
+    ring->deferred_head = ring->deferred_tail = NULL;
+    ring->detached = NULL;
+
+    opal_output_verbose(10, opal_btl_base_framework.framework_output,
+                        "btl:tcp: io_uring engine with %u submission and %u completion entries",
+                        params.sq_entries, params.cq_entries);
+    return OPAL_SUCCESS;
+}
+
+/* Free an operation whose endpoint is gone, with the cache it received in.
+ * Ring lock held. */
+static void mca_btl_tcp_uring_op_release(mca_btl_tcp_uring_t *ring, mca_btl_tcp_uring_op_t *op)
+{
+    for (mca_btl_tcp_uring_op_t **prev = &ring->detached; NULL != *prev;
+         prev = &(*prev)->next_detached) {
+        if (*prev == op) {
+            *prev = op->next_detached;
+            break;
+        }
+    }
+    if (MCA_BTL_TCP_URING_RECV == op->type) {
+        free(op->buffer);
+    }
+    free(op);
+}
+
+/* Hand the filled entries to the kernel. Ring lock held. */
+static int mca_btl_tcp_uring_submit(mca_btl_tcp_uring_t *ring)
+{
+    while (0 < ring->to_submit) {
+        int rc = mca_btl_tcp_uring_sys_enter(ring->fd, ring->to_submit, 0, 0);
+        if (0 > rc) {
+            if (EINTR == errno) {
+                continue;
+            }
+            if (EAGAIN != errno && EBUSY != errno) {
+                BTL_ERROR(("io_uring_enter failed: %s (%d)", strerror(errno), errno));
+            }
+            /* try again once the completions are reaped */
+            return OPAL_ERR_TEMP_OUT_OF_RESOURCE;
+        }
+        ring->to_submit -= rc;
+    }
+    return OPAL_SUCCESS;
+}
+
+/* Ring lock held. NULL if the queue is full and the kernel does not take
+ * more entries for now. */
+static struct io_uring_sqe *mca_btl_tcp_uring_get_sqe(mca_btl_tcp_uring_t *ring)
+{
+    unsigned int tail = *ring->sq_tail;
+    struct io_uring_sqe *sqe;
+
+    if (tail - *ring->sq_head >= ring->entries) {
+        (void) mca_btl_tcp_uring_submit(ring);
+        if (tail - *ring->sq_head >= ring->entries) {
+            return NULL;
+        }
+    }
+    sqe = &ring->sqes[tail & ring->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+/* Queue the entry returned by mca_btl_tcp_uring_get_sqe. Ring lock held. */
+static void mca_btl_tcp_uring_commit_sqe(mca_btl_tcp_uring_t *ring)
+{
+    unsigned int tail = *ring->sq_tail;
+
+    ring->sq_array[tail & ring->sq_mask] = tail & ring->sq_mask;
+    opal_atomic_wmb();
+    *ring->sq_tail = tail + 1;
+    ring->to_submit++;
+}
+
+/* Fill the entry of the current step of the operation and queue it. Ring
+ * lock held. */
+static void mca_btl_tcp_uring_push(mca_btl_tcp_uring_t *ring, struct io_uring_sqe *sqe,
+                                   mca_btl_tcp_uring_op_t *op)
+{
+    sqe->fd = op->fd;
+    sqe->user_data = (uint64_t) (uintptr_t) op;
+    switch (op->step) {
+    case MCA_BTL_TCP_URING_STEP_IO:
+        if (MCA_BTL_TCP_URING_SEND == op->type) {
+            sqe->opcode = IORING_OP_SENDMSG;
+            sqe->addr = (uint64_t) (uintptr_t) &op->msg;
+            sqe->len = 1;
+            sqe->msg_flags = MSG_NOSIGNAL;
+        } else {
+            sqe->opcode = IORING_OP_RECV;
+            sqe->addr = (uint64_t) (uintptr_t) op->buffer;
+            sqe->len = (uint32_t) op->length;
+        }
+        break;
+    case MCA_BTL_TCP_URING_STEP_POLL:
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->poll_events = (MCA_BTL_TCP_URING_SEND == op->type) ? POLLOUT : POLLIN;
+        break;
+    case MCA_BTL_TCP_URING_STEP_NOP:
+        sqe->opcode = IORING_OP_NOP;
+        break;
+    }
+
+    mca_btl_tcp_uring_commit_sqe(ring);
+}
+
+/* Queue the current step of an operation, it reaches the kernel with the
+ * next batch. A detached operation is left to the completion processing
+ * it. Ring lock held. */
+static void mca_btl_tcp_uring_post_locked(mca_btl_tcp_uring_t *ring, mca_btl_tcp_uring_op_t *op,
+                                          mca_btl_tcp_uring_step_t step)
+{
+    struct io_uring_sqe *sqe;
+
+    if (OPAL_UNLIKELY(NULL == op->endpoint)) {
+        op->inflight = false;
+        return;
+    }
+    op->step = step;
+    op->inflight = true;
+    sqe = mca_btl_tcp_uring_get_sqe(ring);
+    if (OPAL_UNLIKELY(NULL == sqe)) {
+        op->next = NULL;
+        if (NULL == ring->deferred_tail) {
+            ring->deferred_head = op;
+        } else {
+            ring->deferred_tail->next = op;
+        }
+        ring->deferred_tail = op;
+    } else {
+        mca_btl_tcp_uring_push(ring, sqe, op);
+    }
+}
+
+static void mca_btl_tcp_uring_post(mca_btl_tcp_uring_op_t *op, mca_btl_tcp_uring_step_t step)
+{
+    mca_btl_tcp_uring_t *ring = &mca_btl_tcp_uring;
+
+    OPAL_THREAD_LOCK(&ring->lock);
+    mca_btl_tcp_uring_post_locked(ring, op, step);
+    OPAL_THREAD_UNLOCK(&ring->lock);
+}
+
+/* Receive in the (empty) endpoint cache. Recv lock held. The cache is
+ * detached from the endpoint under the ring lock when it closes. */
+static void mca_btl_tcp_uring_post_recv(mca_btl_base_endpoint_t *btl_endpoint,
+                                        mca_btl_tcp_uring_op_t *op)
+{
+    mca_btl_tcp_uring_t *ring = &mca_btl_tcp_uring;
+
+    OPAL_THREAD_LOCK(&ring->lock);
+    if (OPAL_LIKELY(NULL != op->endpoint)) {
+        assert(0 == btl_endpoint->endpoint_cache_length);
+        btl_endpoint->endpoint_cache_pos = btl_endpoint->endpoint_cache;
+        op->buffer = btl_endpoint->endpoint_cache;
+        op->length = mca_btl_tcp_component.tcp_endpoint_cache;
+    }
+    mca_btl_tcp_uring_post_locked(ring, op, MCA_BTL_TCP_URING_STEP_IO);
+    OPAL_THREAD_UNLOCK(&ring->lock);
+}
+
+/* The completion of the operation was processed. Release it if its
+ * endpoint closed meanwhile and it was not posted again. */
+static void mca_btl_tcp_uring_complete_done(mca_btl_tcp_uring_op_t *op)
+{
+    mca_btl_tcp_uring_t *ring = &mca_btl_tcp_uring;
+
+    OPAL_THREAD_LOCK(&ring->lock);
+    op->completing--;
+    if (NULL == op->endpoint && !op->inflight && 0 == op->completing) {
+        mca_btl_tcp_uring_op_release(ring, op);
+    }
+    OPAL_THREAD_UNLOCK(&ring->lock);
+}
+
+void mca_btl_tcp_uring_send(mca_btl_base_endpoint_t *btl_endpoint)
+{
+    mca_btl_tcp_uring_op_t *op = btl_endpoint->endpoint_uring_send;
+    opal_list_item_t *item = opal_list_get_first(&btl_endpoint->endpoint_frags);
+    mca_btl_tcp_frag_t *frag = btl_endpoint->endpoint_send_frag;
+    size_t count = 0;
+
+    /* the fragments queued meanwhile go with the next sendmsg */
+    if (NULL == op || op->inflight) {
+        return;
+    }
+
+    /* gather the pending fragments, the first one always fits */
+    for (;;) {
+        if (count + frag->iov_cnt > MCA_BTL_TCP_URING_IOV_MAX) {
+            break;
+        }
+        memcpy(op->iov + count, frag->iov_ptr, frag->iov_cnt * sizeof(struct iovec));
+        count += frag->iov_cnt;
+        if (item == opal_list_get_end(&btl_endpoint->endpoint_frags)) {
+            break;
+        }
+        frag = (mca_btl_tcp_frag_t *) item;
+        item = opal_list_get_next(item);
+    }
+
+    memset(&op->msg, 0, sizeof(op->msg));
+    op->msg.msg_iov = op->iov;
+    op->msg.msg_iovlen = count;
+    mca_btl_tcp_uring_post(op, MCA_BTL_TCP_URING_STEP_IO);
+}
+
+int mca_btl_tcp_uring_start(mca_btl_base_endpoint_t *btl_endpoint)
+{
+    mca_btl_tcp_uring_op_t *send_op, *recv_op;
+
+    send_op = (mca_btl_tcp_uring_op_t *) calloc(1, sizeof(mca_btl_tcp_uring_op_t));
+    recv_op = (mca_btl_tcp_uring_op_t *) calloc(1, sizeof(mca_btl_tcp_uring_op_t));
+    if (NULL == send_op || NULL == recv_op) {
+        free(send_op);
+        free(recv_op);
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    send_op->endpoint = recv_op->endpoint = btl_endpoint;
+    send_op->fd = recv_op->fd = btl_endpoint->endpoint_sd;
+    send_op->type = MCA_BTL_TCP_URING_SEND;
+    recv_op->type = MCA_BTL_TCP_URING_RECV;
+
+    btl_endpoint->endpoint_uring_send = send_op;
+    btl_endpoint->endpoint_uring_recv = recv_op;
+    btl_endpoint->endpoint_uring = true;
+
+    /* The socket is watched by the ring from now on. Without a progress
+     * thread (the only case the engine is used) the default progress
+     * engine no longer needs to poll libevent for this endpoint. */
+    opal_event_del(&btl_endpoint->endpoint_recv_event);
+    opal_event_del(&btl_endpoint->endpoint_send_event);
+    opal_progress_event_users_decrement();
+
+    mca_btl_tcp_uring_post_recv(btl_endpoint, recv_op);
+
+    if (NULL == btl_endpoint->endpoint_send_frag) {
+        btl_endpoint->endpoint_send_frag = (mca_btl_tcp_frag_t *) opal_list_remove_first(
+            &btl_endpoint->endpoint_frags);
+    }
+    if (NULL != btl_endpoint->endpoint_send_frag) {
+        mca_btl_tcp_uring_send(btl_endpoint);
+    }
+    return OPAL_SUCCESS;
+}
+
+void mca_btl_tcp_uring_close(mca_btl_base_endpoint_t *btl_endpoint)
+{
+    mca_btl_tcp_uring_op_t *send_op = btl_endpoint->endpoint_uring_send;
+    mca_btl_tcp_uring_op_t *recv_op = btl_endpoint->endpoint_uring_recv;
+
+    OPAL_THREAD_LOCK(&mca_btl_tcp_uring.lock);
+    btl_endpoint->endpoint_uring_send = NULL;
+    btl_endpoint->endpoint_uring_recv = NULL;
+    /* The operations in flight complete once the socket is shut down, and
+     * the completions being processed finish. The receive keeps the cache
+     * it writes to. */
+    if (recv_op->inflight || 0 < recv_op->completing) {
+        recv_op->endpoint = NULL;
+        recv_op->buffer = btl_endpoint->endpoint_cache;
+        btl_endpoint->endpoint_cache = NULL;
+        recv_op->next_detached = mca_btl_tcp_uring.detached;
+        mca_btl_tcp_uring.detached = recv_op;
+    } else {
+        free(recv_op);
+    }
+    if (send_op->inflight || 0 < send_op->completing) {
+        send_op->endpoint = NULL;
+        send_op->next_detached = mca_btl_tcp_uring.detached;
+        mca_btl_tcp_uring.detached = send_op;
+    } else {
+        free(send_op);
+    }
+    OPAL_THREAD_UNLOCK(&mca_btl_tcp_uring.lock);
+
+    btl_endpoint->endpoint_uring = false;
+    /* balanced by the decrement of mca_btl_tcp_endpoint_close */
+    opal_progress_event_users_increment();
+}
+
+/* The socket failed or the peer went away, as in mca_btl_tcp_frag_recv */
+static void mca_btl_tcp_uring_recv_error(mca_btl_base_endpoint_t *btl_endpoint, int error)
+{
+    char *errhost;
+
+    switch (error) {
+    case 0:
+        break;
+    case ECONNRESET:
+        if (mca_btl_base_warn_peer_error || mca_btl_base_verbose > 0) {
+            errhost = opal_get_proc_hostname(btl_endpoint->endpoint_proc->proc_opal);
+            opal_show_help("help-mpi-btl-tcp.txt", "peer hung up", true,
+                           opal_process_info.nodename, getpid(), errhost);
+            free(errhost);
+        }
+        break;
+    default:
+        BTL_PEER_ERROR(btl_endpoint->endpoint_proc->proc_opal,
+                       ("mca_btl_tcp_uring: recv failed: %s (%d)", strerror(error), error));
+        break;
+    }
+    OPAL_THREAD_LOCK(&btl_endpoint->endpoint_send_lock);
+    if (0 != error || MCA_BTL_TCP_CONNECTED == btl_endpoint->endpoint_state) {
+        btl_endpoint->endpoint_state = MCA_BTL_TCP_FAILED;
+    }
+    mca_btl_tcp_endpoint_close(btl_endpoint);
+    OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_send_lock);
+}
+
+static void mca_btl_tcp_uring_recv_complete(mca_btl_tcp_uring_op_t *op,
+                                            mca_btl_base_endpoint_t *btl_endpoint, int res)
+{
+    mca_btl_tcp_uring_t *ring = &mca_btl_tcp_uring;
+    bool detached;
+
+    OPAL_THREAD_LOCK(&btl_endpoint->endpoint_recv_lock);
+    op->inflight = false;
+    switch (op->step) {
+    case MCA_BTL_TCP_URING_STEP_POLL:
+        /* readable (or in error, which the recv reports) */
+        mca_btl_tcp_uring_post_recv(btl_endpoint, op);
+        goto done;
+    case MCA_BTL_TCP_URING_STEP_NOP:
+        break;
+    case MCA_BTL_TCP_URING_STEP_IO:
+        if (0 < res) {
+            /* the data is in the endpoint cache unless the endpoint closed */
+            OPAL_THREAD_LOCK(&ring->lock);
+            detached = (NULL == op->endpoint);
+            if (!detached) {
+                btl_endpoint->endpoint_cache_length = res;
+            }
+            OPAL_THREAD_UNLOCK(&ring->lock);
+            if (detached) {
+                goto done;
+            }
+            break;
+        }
+        if (-EINTR == res) {
+            mca_btl_tcp_uring_post_recv(btl_endpoint, op);
+        } else if (-EAGAIN == res) {
+            /* older kernels do not wait on non-blocking sockets */
+            mca_btl_tcp_uring_post(op, MCA_BTL_TCP_URING_STEP_POLL);
+        } else {
+            mca_btl_tcp_uring_recv_error(btl_endpoint, -res);
+        }
+        goto done;
+    }
+
+    mca_btl_tcp_endpoint_recv_frags(btl_endpoint, -1);
+
+    /* Receive again, or come back to the data left in the cache when no
+     * fragment could be allocated. The endpoint may have been closed while
+     * delivering (FIN or error), the operation is then not posted again. */
+    if (0 == btl_endpoint->endpoint_cache_length) {
+        mca_btl_tcp_uring_post_recv(btl_endpoint, op);
+    } else {
+        mca_btl_tcp_uring_post(op, MCA_BTL_TCP_URING_STEP_NOP);
+    }
+
+done:
+    OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_recv_lock);
+    mca_btl_tcp_uring_complete_done(op);
+}
+
+static void mca_btl_tcp_uring_send_complete(mca_btl_tcp_uring_op_t *op,
+                                            mca_btl_base_endpoint_t *btl_endpoint, int res)
+{
+    mca_btl_tcp_frag_t *completed[MCA_BTL_TCP_URING_IOV_MAX];
+    mca_btl_tcp_frag_t *frag;
+    int ncompleted = 0;
+    size_t cnt;
+
+    OPAL_THREAD_LOCK(&btl_endpoint->endpoint_send_lock);
+    op->inflight = false;
+    if (MCA_BTL_TCP_URING_STEP_IO != op->step) {
+        /* writable (or in error, which the sendmsg reports) */
+        mca_btl_tcp_uring_send(btl_endpoint);
+        goto done;
+    }
+    if (0 > res) {
+        if (-EINTR == res) {
+            mca_btl_tcp_uring_post(op, MCA_BTL_TCP_URING_STEP_IO);
+        } else if (-EAGAIN == res) {
+            mca_btl_tcp_uring_post(op, MCA_BTL_TCP_URING_STEP_POLL);
+        } else {
+            BTL_PEER_ERROR(btl_endpoint->endpoint_proc->proc_opal,
+                           ("mca_btl_tcp_uring: sendmsg failed: %s (%d)", strerror(-res), -res));
+            btl_endpoint->endpoint_state = MCA_BTL_TCP_FAILED;
+            mca_btl_tcp_endpoint_close(btl_endpoint);
+        }
+        goto done;
+    }
+
+    /* advance the fragments over the bytes written, as mca_btl_tcp_frag_send */
+    cnt = (size_t) res;
+    while (NULL != (frag = btl_endpoint->endpoint_send_frag)
+           && ncompleted < MCA_BTL_TCP_URING_IOV_MAX) {
+        while (0 < frag->iov_cnt && cnt >= frag->iov_ptr->iov_len) {
+            cnt -= frag->iov_ptr->iov_len;
+            frag->iov_ptr++;
+            frag->iov_idx++;
+            frag->iov_cnt--;
+        }
+        if (0 < frag->iov_cnt) {
+            frag->iov_ptr->iov_base = (opal_iov_base_ptr_t)(
+                ((unsigned char *) frag->iov_ptr->iov_base) + cnt);
+            frag->iov_ptr->iov_len -= cnt;
+            break;
+        }
+        completed[ncompleted++] = frag;
+        btl_endpoint->endpoint_send_frag = (mca_btl_tcp_frag_t *) opal_list_remove_first(
+            &btl_endpoint->endpoint_frags);
+    }
+
+    if (NULL != btl_endpoint->endpoint_send_frag
+        && MCA_BTL_TCP_CONNECTED == btl_endpoint->endpoint_state) {
+        mca_btl_tcp_uring_send(btl_endpoint);
+    }
+
+done:
+    OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_send_lock);
+    mca_btl_tcp_uring_complete_done(op);
+
+    /* if required - update request status and release fragment */
+    for (int i = 0; i < ncompleted; ++i) {
+        int btl_ownership;
+
+        frag = completed[i];
+        btl_ownership = (frag->base.des_flags & MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
+        assert(frag->base.des_flags & MCA_BTL_DES_SEND_ALWAYS_CALLBACK);
+        if (NULL != frag->base.des_cbfunc) {
+            frag->base.des_cbfunc(&frag->btl->super, frag->endpoint, &frag->base, frag->rc);
+        }
+        if (btl_ownership) {
+            MCA_BTL_TCP_FRAG_RETURN(frag);
+        }
+    }
+}
+
+int mca_btl_tcp_uring_progress(void)
+{
+    mca_btl_tcp_uring_t *ring = &mca_btl_tcp_uring;
+    struct {
+        mca_btl_tcp_uring_op_t *op;
+        mca_btl_base_endpoint_t *endpoint;
+        int32_t res;
+    } reaped[MCA_BTL_TCP_URING_REAP_MAX];
+    unsigned int head, tail;
+    int count = 0, nreaped = 0;
+
+    if (OPAL_THREAD_TRYLOCK(&ring->lock)) {
+        return 0;
+    }
+
+    while (NULL != ring->deferred_head) {
+        mca_btl_tcp_uring_op_t *op = ring->deferred_head;
+        struct io_uring_sqe *sqe;
+
+        if (NULL == op->endpoint) {
+            ring->deferred_head = op->next;
+            op->inflight = false;
+            if (0 == op->completing) {
+                mca_btl_tcp_uring_op_release(ring, op);
+            }
+            continue;
+        }
+        if (NULL == (sqe = mca_btl_tcp_uring_get_sqe(ring))) {
+            break;
+        }
+        ring->deferred_head = op->next;
+        mca_btl_tcp_uring_push(ring, sqe, op);
+    }
+    if (NULL == ring->deferred_head) {
+        ring->deferred_tail = NULL;
+    }
+
+    if (0 < ring->to_submit) {
+        (void) mca_btl_tcp_uring_submit(ring);
+    }
+
+    /* The endpoint of an operation is read, and the operation handed to its
+     * completion, under the ring lock: an endpoint closing from now on
+     * detaches the operation instead of releasing it. */
+    head = *ring->cq_head;
+    tail = *ring->cq_tail;
+    opal_atomic_rmb();
+    while (head != tail && nreaped < MCA_BTL_TCP_URING_REAP_MAX) {
+        struct io_uring_cqe *cqe = &ring->cqes[head & ring->cq_mask];
+        mca_btl_tcp_uring_op_t *op = (mca_btl_tcp_uring_op_t *) (uintptr_t) cqe->user_data;
+
+        ++head;
+        ++nreaped;
+        if (NULL == op) {
+            /* a cancellation from mca_btl_tcp_uring_fini */
+            continue;
+        }
+        if (NULL == op->endpoint) {
+            op->inflight = false;
+            if (0 == op->completing) {
+                mca_btl_tcp_uring_op_release(ring, op);
+            }
+            continue;
+        }
+        op->completing++;
+        reaped[count].op = op;
+        reaped[count].endpoint = op->endpoint;
+        reaped[count].res = cqe->res;
+        ++count;
+    }
+    if (0 < nreaped) {
+        opal_atomic_mb();
+        *ring->cq_head = head;
+    }
+    OPAL_THREAD_UNLOCK(&ring->lock);
+
+    for (int i = 0; i < count; ++i) {
+        if (MCA_BTL_TCP_URING_SEND == reaped[i].op->type) {
+            mca_btl_tcp_uring_send_complete(reaped[i].op, reaped[i].endpoint, reaped[i].res);
+        } else {
+            mca_btl_tcp_uring_recv_complete(reaped[i].op, reaped[i].endpoint, reaped[i].res);
+        }
+    }
+
+    return nreaped;
+}
+
+void mca_btl_tcp_uring_fini(void)
+{
+    mca_btl_tcp_uring_t *ring = &mca_btl_tcp_uring;
+    struct io_uring_sqe *sqe;
+
+    if (0 > ring->fd) {
+        return;
+    }
+
+    /* All the endpoints are closed and their sockets shut down, the
+     * operations left are detached. Cancel the ones in the kernel and
+     * release them as they complete. */
+    OPAL_THREAD_LOCK(&ring->lock);
+    for (mca_btl_tcp_uring_op_t *op = ring->detached; NULL != op; op = op->next_detached) {
+        if (NULL == (sqe = mca_btl_tcp_uring_get_sqe(ring))) {
+            break;
+        }
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = (uint64_t) (uintptr_t) op;
+        sqe->user_data = 0;
+        mca_btl_tcp_uring_commit_sqe(ring);
+    }
+    OPAL_THREAD_UNLOCK(&ring->lock);
+
+    while (NULL != ring->detached) {
+        if (0 < mca_btl_tcp_uring_progress()) {
+            continue;
+        }
+        if (NULL != ring->detached
+            && 0 > mca_btl_tcp_uring_sys_enter(ring->fd, 0, 1, IORING_ENTER_GETEVENTS)
+            && EINTR != errno) {
+            break;
+        }
+    }
+
+    munmap(ring->sqes, ring->sqes_size);
+    munmap(ring->cq_ring, ring->cq_ring_size);
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+    ring->fd = -1;
+
+    /* closing the ring cancelled whatever did not complete */
+    while (NULL != ring->detached) {
+        mca_btl_tcp_uring_op_release(ring, ring->detached);
+    }
+}
+
+#endif /* OPAL_BTL_TCP_HAVE_IO_URING */
@@ -0,0 +1,115 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * io_uring engine of the TCP BTL.
+ *
+ * The connections are established through libevent as usual. Once an
+ * endpoint is connected its socket is handed to the engine: the pending
+ * fragments are gathered in a single sendmsg, and a recv in the endpoint
+ * cache is always posted. The operations of all the endpoints are handed
+ * to the kernel in batches, and their completions reaped, by the progress
+ * function of the component, so a fragment costs no system call of its own
+ * when the traffic is steady.
+ */
+
+#ifndef MCA_BTL_TCP_URING_H
+#define MCA_BTL_TCP_URING_H
+
+#include "opal_config.h"
+
+#if OPAL_BTL_TCP_HAVE_IO_URING
+
+#    include <stdbool.h>
+#    include <stdint.h>
+#    include <sys/socket.h>
+#    include <sys/uio.h>
+
+BEGIN_C_DECLS
+
+struct mca_btl_base_endpoint_t;
+
+/** Number of iovecs gathered by a sendmsg */
+#    define MCA_BTL_TCP_URING_IOV_MAX 64
+
+typedef enum {
+    MCA_BTL_TCP_URING_SEND,
+    MCA_BTL_TCP_URING_RECV,
+} mca_btl_tcp_uring_op_type_t;
+
+/**
+ * An operation of an endpoint. Each connected endpoint has one send and
+ * one receive operation, at most one of each is submitted at any time.
+ */
+typedef struct mca_btl_tcp_uring_op_t {
+    /** NULL once the endpoint closed while the operation was in flight */
+    struct mca_btl_base_endpoint_t *endpoint;
+    /** chaining while the operation waits for room in the submission queue */
+    struct mca_btl_tcp_uring_op_t *next;
+    /** chaining of the detached operations, released once the kernel is done with them */
+    struct mca_btl_tcp_uring_op_t *next_detached;
+    int fd;
+    uint8_t type;
+    uint8_t step;
+    bool inflight;
+    /** completions of the operation being processed (ring lock) */
+    uint8_t completing;
+    /** receive buffer (the endpoint cache), owned by the operation once detached */
+    char *buffer;
+    size_t length;
+    struct msghdr msg;
+    struct iovec iov[MCA_BTL_TCP_URING_IOV_MAX];
+} mca_btl_tcp_uring_op_t;
+
+/**
+ * Create the ring. Returns an error if io_uring is not available, in
+ * which case the sockets stay with libevent.
+ */
+int mca_btl_tcp_uring_init(void);
+
+/** Destroy the ring, after all the endpoints closed */
+void mca_btl_tcp_uring_fini(void);
+
+/** Whether the ring was created */
+bool mca_btl_tcp_uring_enabled(void);
+
+/**
+ * Submit the pending operations and process the completions.
+ */
+int mca_btl_tcp_uring_progress(void);
+
+/**
+ * Hand a newly connected endpoint to the engine: post the receive and the
+ * pending sends. Called with the send and recv locks held. On error the
+ * endpoint is left to libevent.
+ */
+int mca_btl_tcp_uring_start(struct mca_btl_base_endpoint_t *endpoint);
+
+/**
+ * Send the endpoint_send_frag of the endpoint and the fragments queued
+ * behind it. Called with the send lock held.
+ */
+void mca_btl_tcp_uring_send(struct mca_btl_base_endpoint_t *endpoint);
+
+/**
+ * Release the operations of a closing endpoint. The operations in flight,
+ * or whose completion is being processed, are detached and released once
+ * the kernel and the completion are done with them.
+ */
+void mca_btl_tcp_uring_close(struct mca_btl_base_endpoint_t *endpoint);
+
+END_C_DECLS
+
+#endif /* OPAL_BTL_TCP_HAVE_IO_URING */
+
+#endif /* MCA_BTL_TCP_URING_H */
@@ -37,4 +37,21 @@ AC_DEFUN([MCA_opal_btl_tcp_CONFIG],[
 #endif
 		   ])
     OPAL_SUMMARY_ADD([[Transports]],[[TCP]],[[btl_tcp]],[$opal_btl_tcp_happy])
+
+    # Check for io_uring (alternative send/receive engine). Only the
+    # kernel headers are needed, the rings are set up with the raw
+    # system calls.
+    OPAL_VAR_SCOPE_PUSH([btl_tcp_io_uring_happy])
+    btl_tcp_io_uring_happy=1
+    AC_CHECK_HEADERS([linux/io_uring.h sys/syscall.h], [], [btl_tcp_io_uring_happy=0])
+    AS_IF([test $btl_tcp_io_uring_happy -eq 1],
+          [AC_CHECK_DECLS([IORING_OP_RECV, __NR_io_uring_setup, __NR_io_uring_enter],
+                          [], [btl_tcp_io_uring_happy=0],
+                          [#include <linux/io_uring.h>
+#include <sys/syscall.h>
+                          ])])
+
+    AC_DEFINE_UNQUOTED([OPAL_BTL_TCP_HAVE_IO_URING], [$btl_tcp_io_uring_happy],
+        [If the io_uring engine can be enabled within tcp])
+    OPAL_VAR_SCOPE_POP
 ])dnl
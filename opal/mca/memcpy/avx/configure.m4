@@ -0,0 +1,138 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2026      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+AC_DEFUN([MCA_opal_memcpy_avx_PRIORITY], [30])
+
+AC_DEFUN([MCA_opal_memcpy_avx_COMPILE_MODE], [
+    AC_MSG_CHECKING([for MCA component $2:$3 compile mode])
+    $4="static"
+    AC_MSG_RESULT([$$4])
+])
+
+AC_DEFUN([MCA_opal_memcpy_avx_POST_CONFIG],[
+    AS_IF([test "$1" = "1"], [memcpy_base_include="avx/memcpy_avx.h"])
+])dnl
+
+# MCA_memcpy_avx_CONFIG(action-if-can-compile,
+#                       [action-if-cant-compile])
+# ------------------------------------------------
+# The kernels are built for AVX2 and AVX512 with the flags the compiler
+# needs, and the most suitable one is selected at runtime.
+AC_DEFUN([MCA_opal_memcpy_avx_CONFIG],[
+    AC_CONFIG_FILES([opal/mca/memcpy/avx/Makefile])
+
+    MCA_BUILD_MEMCPY_AVX2_FLAGS=""
+    MCA_BUILD_MEMCPY_AVX512_FLAGS=""
+    memcpy_avx2_support=0
+    memcpy_avx512_support=0
+
+    OPAL_VAR_SCOPE_PUSH([memcpy_avx_cflags_save])
+
+    AS_IF([test "$opal_cv_asm_arch" = "X86_64"],
+          [AC_LANG_PUSH([C])
+
+           #
+           # Check for AVX512 streaming stores
+           #
+           AC_MSG_CHECKING([for AVX512 streaming stores (no additional flags)])
+           AC_LINK_IFELSE(
+               [AC_LANG_PROGRAM([[#include <immintrin.h>]],
+                                [[
+#if defined(__ICC) && !defined(__AVX512F__)
+#error "icc needs the -m flags to provide the AVX* detection macros
+#endif
+    long long A[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    __m512i vA = _mm512_loadu_si512((void*)&A);
+    _mm512_stream_si512((void*)&A, vA)
+                                ]])],
+               [memcpy_avx512_support=1
+                AC_MSG_RESULT([yes])],
+               [AC_MSG_RESULT([no])])
+           AS_IF([test $memcpy_avx512_support -eq 0],
+                 [AC_MSG_CHECKING([for AVX512 streaming stores (with -mavx512f)])
+                  memcpy_avx_cflags_save="$CFLAGS"
+                  CFLAGS="-mavx512f $CFLAGS"
+                  AC_LINK_IFELSE(
+                      [AC_LANG_PROGRAM([[#include <immintrin.h>]],
+                                       [[
+#if defined(__ICC) && !defined(__AVX512F__)
+#error "icc needs the -m flags to provide the AVX* detection macros
+#endif
+    long long A[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    __m512i vA = _mm512_loadu_si512((void*)&A);
+    _mm512_stream_si512((void*)&A, vA)
+                                       ]])],
+                      [memcpy_avx512_support=1
+                       MCA_BUILD_MEMCPY_AVX512_FLAGS="-mavx512f"
+                       AC_MSG_RESULT([yes])],
+                      [AC_MSG_RESULT([no])])
+                  CFLAGS="$memcpy_avx_cflags_save"])
+
+           #
+           # Check for AVX2 streaming stores
+           #
+           AC_MSG_CHECKING([for AVX2 streaming stores (no additional flags)])
+           AC_LINK_IFELSE(
+               [AC_LANG_PROGRAM([[#include <immintrin.h>]],
+                                [[
+#if defined(__ICC) && !defined(__AVX2__)
+#error "icc needs the -m flags to provide the AVX* detection macros
+#endif
+    int A[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    __m256i vA = _mm256_loadu_si256((__m256i*)&A);
+    _mm256_stream_si256((__m256i*)&A, vA)
+                                ]])],
+               [memcpy_avx2_support=1
+                AC_MSG_RESULT([yes])],
+               [AC_MSG_RESULT([no])])
+           AS_IF([test $memcpy_avx2_support -eq 0],
+                 [AC_MSG_CHECKING([for AVX2 streaming stores (with -mavx2)])
+                  memcpy_avx_cflags_save="$CFLAGS"
+                  CFLAGS="-mavx2 $CFLAGS"
+                  AC_LINK_IFELSE(
+                      [AC_LANG_PROGRAM([[#include <immintrin.h>]],
+                                       [[
+#if defined(__ICC) && !defined(__AVX2__)
+#error "icc needs the -m flags to provide the AVX* detection macros
+#endif
+    int A[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    __m256i vA = _mm256_loadu_si256((__m256i*)&A);
+    _mm256_stream_si256((__m256i*)&A, vA)
+                                       ]])],
+                      [memcpy_avx2_support=1
+                       MCA_BUILD_MEMCPY_AVX2_FLAGS="-mavx2"
+                       AC_MSG_RESULT([yes])],
+                      [AC_MSG_RESULT([no])])
+                  CFLAGS="$memcpy_avx_cflags_save"])
+
+           AC_LANG_POP([C])
+          ])
+
+    AC_DEFINE_UNQUOTED([OPAL_MCA_MEMCPY_HAVE_AVX512],
+                       [$memcpy_avx512_support],
+                       [AVX512 memcpy kernels built])
+    AC_DEFINE_UNQUOTED([OPAL_MCA_MEMCPY_HAVE_AVX2],
+                       [$memcpy_avx2_support],
+                       [AVX2 memcpy kernels built])
+    AM_CONDITIONAL([MCA_BUILD_opal_memcpy_has_avx512_support],
+                   [test "$memcpy_avx512_support" = "1"])
+    AM_CONDITIONAL([MCA_BUILD_opal_memcpy_has_avx2_support],
+                   [test "$memcpy_avx2_support" = "1"])
+    AC_SUBST(MCA_BUILD_MEMCPY_AVX512_FLAGS)
+    AC_SUBST(MCA_BUILD_MEMCPY_AVX2_FLAGS)
+
+    AS_IF([test $memcpy_avx2_support -eq 1 || test $memcpy_avx512_support -eq 1],
+          [$1],
+          [$2])
+
+    OPAL_VAR_SCOPE_POP
+])dnl
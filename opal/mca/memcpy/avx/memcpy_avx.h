@@ -0,0 +1,82 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * Copies larger than the non-temporal threshold go through a kernel
+ * using streaming stores, so a copy that would evict the whole last
+ * level cache does not pollute the cache of the reader. Smaller copies
+ * use the C library. The kernel and the threshold are selected when the
+ * component is opened; until then every copy uses the C library.
+ */
+
+#ifndef OPAL_MCA_MEMCPY_AVX_MEMCPY_AVX_H
+#define OPAL_MCA_MEMCPY_AVX_MEMCPY_AVX_H
+
+#include "opal_config.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "opal/mca/memcpy/memcpy.h"
+
+BEGIN_C_DECLS
+
+#define OPAL_MEMCPY_AVX_HAS_AVX2_FLAG    0x020
+#define OPAL_MEMCPY_AVX_HAS_AVX512F_FLAG 0x100
+
+typedef void *(*opal_memcpy_avx_fn_t)(void *dst, const void *src, size_t length);
+
+/** Size from which the copies use streaming stores */
+OPAL_DECLSPEC extern size_t opal_memcpy_avx_nt_threshold;
+/** Streaming store kernel selected for this processor */
+OPAL_DECLSPEC extern opal_memcpy_avx_fn_t opal_memcpy_avx_nt;
+
+/** The kernels, one per instruction set built */
+OPAL_DECLSPEC void *opal_memcpy_avx2_nt(void *dst, const void *src, size_t length);
+OPAL_DECLSPEC void *opal_memcpy_avx512_nt(void *dst, const void *src, size_t length);
+
+static inline void *opal_memcpy_avx(void *dst, const void *src, size_t length)
+{
+    if (OPAL_LIKELY(length < opal_memcpy_avx_nt_threshold)) {
+        return memcpy(dst, src, length);
+    }
+    return opal_memcpy_avx_nt(dst, src, length);
+}
+
+#define opal_memcpy(dst, src, length) opal_memcpy_avx((dst), (src), (length))
+
+#define opal_memcpy_tov(dst_iov, src, count)                              \
+    do {                                                                  \
+        int _i;                                                           \
+        char *_src = (char *) src;                                        \
+                                                                          \
+        for (_i = 0; _i < count; _i++) {                                  \
+            opal_memcpy(dst_iov[_i].iov_base, _src, dst_iov[_i].iov_len); \
+            _src += dst_iov[_i].iov_len;                                  \
+        }                                                                 \
+    } while (0)
+
+#define opal_memcpy_fromv(dst, src_iov, count)                            \
+    do {                                                                  \
+        int _i;                                                           \
+        char *_dst = (char *) dst;                                        \
+                                                                          \
+        for (_i = 0; _i < count; _i++) {                                  \
+            opal_memcpy(_dst, src_iov[_i].iov_base, src_iov[_i].iov_len); \
+            _dst += src_iov[_i].iov_len;                                  \
+        }                                                                 \
+    } while (0)
+
+END_C_DECLS
+
+#endif /* OPAL_MCA_MEMCPY_AVX_MEMCPY_AVX_H */
@@ -0,0 +1,207 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include "opal/constants.h"
+#include "opal/mca/base/mca_base_var.h"
+#include "opal/mca/memcpy/avx/memcpy_avx.h"
+#include "opal/mca/memcpy/base/base.h"
+#include "opal/mca/memcpy/memcpy.h"
+#include "opal/util/output.h"
+
+/* used when the size of the last level cache is unknown */
+#define MEMCPY_AVX_DEFAULT_NT_THRESHOLD (4 * 1024 * 1024)
+
+size_t opal_memcpy_avx_nt_threshold = SIZE_MAX;
+opal_memcpy_avx_fn_t opal_memcpy_avx_nt = memcpy;
+
+static int memcpy_avx_supported = 0;
+static int memcpy_avx_flags = 0;
+static size_t memcpy_avx_nt_threshold = 0;
+
+static int opal_memcpy_avx_register(void);
+static int opal_memcpy_avx_open(void);
+
+static mca_base_var_enum_value_flag_t memcpy_avx_support_flags[] = {
+    {.flag = OPAL_MEMCPY_AVX_HAS_AVX2_FLAG, .string = "AVX2"},
+    {.flag = OPAL_MEMCPY_AVX_HAS_AVX512F_FLAG, .string = "AVX512F"},
+    {.flag = 0, .string = NULL},
+};
+
+const opal_memcpy_base_component_2_0_0_t mca_memcpy_avx_component = {
+    /* First, the mca_component_t struct containing meta information
+       about the component itself */
+    .memcpyc_version =
+        {
+            OPAL_MEMCPY_BASE_VERSION_2_0_0,
+
+            /* Component name and version */
+            .mca_component_name = "avx",
+            MCA_BASE_MAKE_VERSION(component, OPAL_MAJOR_VERSION, OPAL_MINOR_VERSION,
+                                  OPAL_RELEASE_VERSION),
+
+            /* Component open and register functions */
+            .mca_open_component = opal_memcpy_avx_open,
+            .mca_register_component_params = opal_memcpy_avx_register,
+        },
+    .memcpyc_data =
+        {/* The component is checkpoint ready */
+         MCA_BASE_METADATA_PARAM_CHECKPOINT},
+};
+
+static void memcpy_avx_cpuid(uint32_t eax, uint32_t ecx, uint32_t *abcd)
+{
+    uint32_t ebx = 0, edx = 0;
+
+    __asm__("cpuid" : "+b"(ebx), "+a"(eax), "+c"(ecx), "=d"(edx));
+    abcd[0] = eax;
+    abcd[1] = ebx;
+    abcd[2] = ecx;
+    abcd[3] = edx;
+}
+
+/*
+ * The instruction sets are usable only if the processor has them and the
+ * operating system saves the corresponding registers (XCR0).
+ */
+static int memcpy_avx_features(void)
+{
+    const uint32_t osxsave_mask = (1U << 27); /* OSXSAVE (EAX = 1, ECX = 0) : ECX */
+    const uint32_t avx2_mask = (1U << 5);     /* AVX2    (EAX = 7, ECX = 0) : EBX */
+    const uint32_t avx512f_mask = (1U << 16); /* AVX512F (EAX = 7, ECX = 0) : EBX */
+    const uint32_t xcr0_avx = 0x06;           /* XMM and YMM state */
+    const uint32_t xcr0_avx512 = 0xe6;        /* and opmask, ZMM_Hi256, Hi16_ZMM state */
+    uint32_t abcd[4], xcr0, edx;
+    int flags = 0;
+
+    memcpy_avx_cpuid(0, 0, abcd);
+    if (abcd[0] < 7) {
+        return 0;
+    }
+
+    memcpy_avx_cpuid(1, 0, abcd);
+    if (!(abcd[2] & osxsave_mask)) {
+        return 0;
+    }
+    __asm__("xgetbv" : "=a"(xcr0), "=d"(edx) : "c"(0));
+
+    memcpy_avx_cpuid(7, 0, abcd);
+    if ((abcd[1] & avx2_mask) && (xcr0 & xcr0_avx) == xcr0_avx) {
+        flags |= OPAL_MEMCPY_AVX_HAS_AVX2_FLAG;
+    }
+    if ((abcd[1] & avx512f_mask) && (xcr0 & xcr0_avx512) == xcr0_avx512) {
+        flags |= OPAL_MEMCPY_AVX_HAS_AVX512F_FLAG;
+    }
+    return flags;
+}
+
+static int opal_memcpy_avx_register(void)
+{
+    mca_base_var_enum_flag_t *new_enum_flag = NULL;
+
+    memcpy_avx_supported = memcpy_avx_flags = memcpy_avx_features();
+
+    (void) mca_base_var_enum_create_flag("memcpy_avx_support_flags", memcpy_avx_support_flags,
+                                         &new_enum_flag);
+
+    (void) mca_base_component_var_register(&mca_memcpy_avx_component.memcpyc_version,
+                                           "capabilities",
+                                           "Level of AVX support available in the current "
+                                           "environment",
+                                           MCA_BASE_VAR_TYPE_INT, &(new_enum_flag->super), 0, 0,
+                                           OPAL_INFO_LVL_4, MCA_BASE_VAR_SCOPE_CONSTANT,
+                                           &memcpy_avx_supported);
+
+    (void) mca_base_component_var_register(&mca_memcpy_avx_component.memcpyc_version, "support",
+                                           "Level of AVX support to be used by the copy kernels, "
+                                           "capped by the local architecture capabilities "
+                                           "(none uses the C library for all copies)",
+                                           MCA_BASE_VAR_TYPE_INT, &(new_enum_flag->super), 0, 0,
+                                           OPAL_INFO_LVL_4, MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &memcpy_avx_flags);
+    OBJ_RELEASE(new_enum_flag);
+
+    memcpy_avx_nt_threshold = 0;
+    (void) mca_base_component_var_register(&mca_memcpy_avx_component.memcpyc_version,
+                                           "nt_threshold",
+                                           "Size in bytes from which the copies use non-temporal "
+                                           "(streaming) stores, bypassing the caches. The "
+                                           "opal_memcpy_bench program (test/util) reports the "
+                                           "crossover of a machine "
+                                           "(0 = three quarters of the last level cache, "
+                                           "default: 0)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL, &memcpy_avx_nt_threshold);
+
+    memcpy_avx_flags &= memcpy_avx_supported;
+
+    return OPAL_SUCCESS;
+}
+
+/* the copies larger than most of the last level cache evict it anyway */
+static size_t memcpy_avx_default_threshold(void)
+{
+    long size = -1;
+
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+    size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+    if (size <= 0) {
+        size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    }
+#endif
+    if (size <= 0) {
+        return MEMCPY_AVX_DEFAULT_NT_THRESHOLD;
+    }
+
+    return (size_t) size / 4 * 3;
+}
+
+static int opal_memcpy_avx_open(void)
+{
+    opal_memcpy_avx_fn_t kernel = NULL;
+    const char *name = NULL;
+
+#if OPAL_MCA_MEMCPY_HAVE_AVX512
+    if (memcpy_avx_flags & OPAL_MEMCPY_AVX_HAS_AVX512F_FLAG) {
+        kernel = opal_memcpy_avx512_nt;
+        name = "AVX512F";
+    }
+#endif
+#if OPAL_MCA_MEMCPY_HAVE_AVX2
+    if (NULL == kernel && (memcpy_avx_flags & OPAL_MEMCPY_AVX_HAS_AVX2_FLAG)) {
+        kernel = opal_memcpy_avx2_nt;
+        name = "AVX2";
+    }
+#endif
+
+    if (NULL == kernel) {
+        opal_memcpy_avx_nt_threshold = SIZE_MAX;
+        opal_memcpy_avx_nt = memcpy;
+        return OPAL_SUCCESS;
+    }
+
+    opal_memcpy_avx_nt = kernel;
+    opal_memcpy_avx_nt_threshold = memcpy_avx_nt_threshold ? memcpy_avx_nt_threshold
+                                                           : memcpy_avx_default_threshold();
+
+    opal_output_verbose(10, opal_memcpy_base_framework.framework_output,
+                        "memcpy:avx: %s streaming stores from %lu bytes",
+                        name, (unsigned long) opal_memcpy_avx_nt_threshold);
+
+    return OPAL_SUCCESS;
+}
@@ -0,0 +1,109 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * Streaming store copy kernels. This file is compiled once per
+ * instruction set, with GENERATE_AVX2_CODE or GENERATE_AVX512_CODE.
+ */
+
+#include "opal_config.h"
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "opal/mca/memcpy/avx/memcpy_avx.h"
+
+#if defined(GENERATE_AVX512_CODE)
+#    if defined(__AVX512F__)
+#        define MEMCPY_AVX_VECTOR_SIZE 64
+#        define MEMCPY_AVX_FUNC        opal_memcpy_avx512_nt
+typedef __m512i memcpy_avx_vector_t;
+#        define MEMCPY_AVX_LOAD(p)      _mm512_loadu_si512((const void *) (p))
+#        define MEMCPY_AVX_STREAM(p, v) _mm512_stream_si512((void *) (p), (v))
+#    else
+#        error "AVX512 code generation requested without the AVX512F flags"
+#    endif
+#elif defined(GENERATE_AVX2_CODE)
+#    if defined(__AVX2__)
+#        define MEMCPY_AVX_VECTOR_SIZE 32
+#        define MEMCPY_AVX_FUNC        opal_memcpy_avx2_nt
+typedef __m256i memcpy_avx_vector_t;
+#        define MEMCPY_AVX_LOAD(p)      _mm256_loadu_si256((const __m256i *) (p))
+#        define MEMCPY_AVX_STREAM(p, v) _mm256_stream_si256((__m256i *) (p), (v))
+#    else
+#        error "AVX2 code generation requested without the AVX2 flags"
+#    endif
+#else
+#    error "no instruction set selected"
+#endif
+
+/* bytes moved by an iteration of the main loop */
+#define MEMCPY_AVX_BLOCK_SIZE (4 * MEMCPY_AVX_VECTOR_SIZE)
+/* distance of the software prefetch of the source */
+#define MEMCPY_AVX_PREFETCH_DISTANCE 512
+
+void *MEMCPY_AVX_FUNC(void *dst, const void *src, size_t length)
+{
+    char *d = (char *) dst;
+    const char *s = (const char *) src;
+    size_t head;
+
+    /* the streaming stores need aligned destinations */
+    head = (MEMCPY_AVX_VECTOR_SIZE - ((uintptr_t) d & (MEMCPY_AVX_VECTOR_SIZE - 1)))
+           & (MEMCPY_AVX_VECTOR_SIZE - 1);
+    if (head > length) {
+        head = length;
+    }
+    memcpy(d, s, head);
+    d += head;
+    s += head;
+    length -= head;
+
+    while (length >= MEMCPY_AVX_BLOCK_SIZE) {
+        memcpy_avx_vector_t v0, v1, v2, v3;
+
+        _mm_prefetch(s + MEMCPY_AVX_PREFETCH_DISTANCE, _MM_HINT_NTA);
+        _mm_prefetch(s + MEMCPY_AVX_PREFETCH_DISTANCE + 64, _MM_HINT_NTA);
+#if MEMCPY_AVX_BLOCK_SIZE > 128
+        _mm_prefetch(s + MEMCPY_AVX_PREFETCH_DISTANCE + 128, _MM_HINT_NTA);
+        _mm_prefetch(s + MEMCPY_AVX_PREFETCH_DISTANCE + 192, _MM_HINT_NTA);
+#endif
+        v0 = MEMCPY_AVX_LOAD(s);
+        v1 = MEMCPY_AVX_LOAD(s + MEMCPY_AVX_VECTOR_SIZE);
+        v2 = MEMCPY_AVX_LOAD(s + 2 * MEMCPY_AVX_VECTOR_SIZE);
+        v3 = MEMCPY_AVX_LOAD(s + 3 * MEMCPY_AVX_VECTOR_SIZE);
+        MEMCPY_AVX_STREAM(d, v0);
+        MEMCPY_AVX_STREAM(d + MEMCPY_AVX_VECTOR_SIZE, v1);
+        MEMCPY_AVX_STREAM(d + 2 * MEMCPY_AVX_VECTOR_SIZE, v2);
+        MEMCPY_AVX_STREAM(d + 3 * MEMCPY_AVX_VECTOR_SIZE, v3);
+        d += MEMCPY_AVX_BLOCK_SIZE;
+        s += MEMCPY_AVX_BLOCK_SIZE;
+        length -= MEMCPY_AVX_BLOCK_SIZE;
+    }
+
+    while (length >= MEMCPY_AVX_VECTOR_SIZE) {
+        MEMCPY_AVX_STREAM(d, MEMCPY_AVX_LOAD(s));
+        d += MEMCPY_AVX_VECTOR_SIZE;
+        s += MEMCPY_AVX_VECTOR_SIZE;
+        length -= MEMCPY_AVX_VECTOR_SIZE;
+    }
+
+    /* the streaming stores are weakly ordered, make them visible before
+     * the copy is reported complete (to a peer process for instance) */
+    _mm_sfence();
+
+    memcpy(d, s, length);
+
+    return dst;
+}
@@ -0,0 +1,310 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * The caller publishes the job and bumps a generation counter, the
+ * helpers and the caller then take the tasks in turn from a shared
+ * counter. Every helper acknowledges every generation, so that none of
+ * them can still be looking at a job when the next one is published.
+ * Helpers spin for a short while before falling asleep on a condition
+ * variable, so that back-to-back jobs (e.g. the segments of a pipelined
+ * allreduce) do not pay the wake-up latency.
+ */
+
+#include "opal_config.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "opal/class/opal_object.h"
+#include "opal/constants.h"
+#include "opal/mca/hwloc/base/base.h"
+#include "opal/mca/threads/base/base.h"
+#include "opal/mca/threads/thread_pool.h"
+#include "opal/mca/threads/threads.h"
+#include "opal/sys/atomic.h"
+#include "opal/util/output.h"
+
+/* Spin iterations before a helper falls asleep */
+#define THREAD_POOL_SPIN_COUNT (64 * 1024)
+
+int opal_thread_pool_size = 0;
+bool opal_thread_pool_bind = true;
+
+typedef struct {
+    opal_thread_pool_fn_t fn;
+    void *arg;
+    int32_t ntasks;
+    /* index of the next task to run */
+    opal_atomic_int32_t next;
+} thread_pool_job_t;
+
+typedef enum {
+    THREAD_POOL_NOT_STARTED = 0,
+    THREAD_POOL_RUNNING,
+    THREAD_POOL_DISABLED,
+} thread_pool_state_t;
+
+static struct {
+    opal_mutex_t lock;
+    opal_cond_t cond;
+    int refcount;
+    opal_thread_t *threads;
+    hwloc_cpuset_t *cpusets;
+    int ncpusets;
+    int nthreads;
+    thread_pool_state_t state;
+    bool shutdown;
+    /* bumped (under the lock) every time a new job is published */
+    volatile uint32_t generation;
+    /* number of helpers that did not yet complete the current job */
+    opal_atomic_int32_t pending;
+    /* owned by the caller currently using the pool */
+    opal_atomic_int32_t busy;
+    thread_pool_job_t job;
+} thread_pool = {
+    .state = THREAD_POOL_NOT_STARTED,
+};
+
+static void thread_pool_run(thread_pool_job_t *job)
+{
+    int32_t task;
+
+    while ((task = opal_atomic_fetch_add_32(&job->next, 1)) < job->ntasks) {
+        job->fn(job->arg, task);
+    }
+}
+
+static void *thread_pool_helper(opal_object_t *obj)
+{
+    opal_thread_t *thread = (opal_thread_t *) obj;
+    int id = (int) (intptr_t) thread->t_arg;
+    uint32_t seen = 0;
+
+    if (id < thread_pool.ncpusets && NULL != thread_pool.cpusets[id]) {
+        (void) hwloc_set_cpubind(opal_hwloc_topology, thread_pool.cpusets[id],
+                                 HWLOC_CPUBIND_THREAD);
+    }
+
+    for (;;) {
+        for (int spin = 0; spin < THREAD_POOL_SPIN_COUNT && seen == thread_pool.generation;
+             ++spin) {
+            opal_atomic_rmb();
+        }
+        opal_mutex_lock(&thread_pool.lock);
+        while (seen == thread_pool.generation && !thread_pool.shutdown) {
+            opal_cond_wait(&thread_pool.cond, &thread_pool.lock);
+        }
+        if (thread_pool.shutdown) {
+            opal_mutex_unlock(&thread_pool.lock);
+            break;
+        }
+        seen = thread_pool.generation;
+        opal_mutex_unlock(&thread_pool.lock);
+
+        thread_pool_run(&thread_pool.job);
+        opal_atomic_wmb();
+        (void) opal_atomic_add_fetch_32(&thread_pool.pending, -1);
+    }
+    return NULL;
+}
+
+/*
+ * Compute one core per helper out of the cores of the process
+ * binding, leaving the first one to the calling thread. Returns the
+ * number of helpers that can be bound.
+ */
+static int thread_pool_bind_setup(int nthreads)
+{
+    hwloc_cpuset_t set;
+    int ncores;
+
+    if (NULL == opal_hwloc_topology) {
+        return nthreads;
+    }
+    set = hwloc_bitmap_alloc();
+    if (NULL == set) {
+        return nthreads;
+    }
+    if (0 != hwloc_get_cpubind(opal_hwloc_topology, set, HWLOC_CPUBIND_PROCESS)) {
+        hwloc_bitmap_free(set);
+        return nthreads;
+    }
+    ncores = hwloc_get_nbobjs_inside_cpuset_by_type(opal_hwloc_topology, set, HWLOC_OBJ_CORE);
+    if (nthreads > ncores - 1) {
+        opal_output_verbose(10, opal_threads_base_framework.framework_output,
+                            "thread pool: only %d core(s) in the process binding, using %d "
+                            "helper thread(s)",
+                            ncores, (ncores > 1) ? ncores - 1 : 0);
+        nthreads = (ncores > 1) ? ncores - 1 : 0;
+    }
+    if (nthreads > 0) {
+        thread_pool.cpusets = (hwloc_cpuset_t *) calloc(nthreads, sizeof(hwloc_cpuset_t));
+        thread_pool.ncpusets = (NULL != thread_pool.cpusets) ? nthreads : 0;
+        for (int i = 0; i < thread_pool.ncpusets; ++i) {
+            hwloc_obj_t core = hwloc_get_obj_inside_cpuset_by_type(opal_hwloc_topology, set,
+                                                                   HWLOC_OBJ_CORE, i + 1);
+            if (NULL != core) {
+                thread_pool.cpusets[i] = hwloc_bitmap_dup(core->cpuset);
+            }
+        }
+    }
+    hwloc_bitmap_free(set);
+    return nthreads;
+}
+
+static int thread_pool_start(void)
+{
+    int nthreads = opal_thread_pool_size;
+
+    if (opal_thread_pool_bind) {
+        nthreads = thread_pool_bind_setup(nthreads);
+    }
+    if (nthreads <= 0) {
+        thread_pool.state = THREAD_POOL_DISABLED;
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+
+    thread_pool.threads = (opal_thread_t *) calloc(nthreads, sizeof(opal_thread_t));
+    if (NULL == thread_pool.threads) {
+        thread_pool.state = THREAD_POOL_DISABLED;
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    thread_pool.shutdown = false;
+    for (int i = 0; i < nthreads; ++i) {
+        OBJ_CONSTRUCT(&thread_pool.threads[i], opal_thread_t);
+        thread_pool.threads[i].t_run = thread_pool_helper;
+        thread_pool.threads[i].t_arg = (void *) (intptr_t) i;
+        if (OPAL_SUCCESS != opal_thread_start(&thread_pool.threads[i])) {
+            OBJ_DESTRUCT(&thread_pool.threads[i]);
+            break;
+        }
+        thread_pool.nthreads++;
+    }
+    if (0 == thread_pool.nthreads) {
+        free(thread_pool.threads);
+        thread_pool.threads = NULL;
+        thread_pool.state = THREAD_POOL_DISABLED;
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    opal_output_verbose(10, opal_threads_base_framework.framework_output,
+                        "thread pool: started %d helper thread(s)", thread_pool.nthreads);
+    thread_pool.state = THREAD_POOL_RUNNING;
+    return OPAL_SUCCESS;
+}
+
+static void thread_pool_stop(void)
+{
+    if (THREAD_POOL_RUNNING == thread_pool.state) {
+        opal_mutex_lock(&thread_pool.lock);
+        thread_pool.shutdown = true;
+        opal_cond_broadcast(&thread_pool.cond);
+        opal_mutex_unlock(&thread_pool.lock);
+        for (int i = 0; i < thread_pool.nthreads; ++i) {
+            opal_thread_join(&thread_pool.threads[i], NULL);
+            OBJ_DESTRUCT(&thread_pool.threads[i]);
+        }
+        free(thread_pool.threads);
+        thread_pool.threads = NULL;
+        thread_pool.nthreads = 0;
+    }
+    if (NULL != thread_pool.cpusets) {
+        for (int i = 0; i < thread_pool.ncpusets; ++i) {
+            if (NULL != thread_pool.cpusets[i]) {
+                hwloc_bitmap_free(thread_pool.cpusets[i]);
+            }
+        }
+        free(thread_pool.cpusets);
+        thread_pool.cpusets = NULL;
+        thread_pool.ncpusets = 0;
+    }
+    thread_pool.state = THREAD_POOL_NOT_STARTED;
+}
+
+int opal_thread_pool_init(void)
+{
+    if (0 == thread_pool.refcount++) {
+        OBJ_CONSTRUCT(&thread_pool.lock, opal_mutex_t);
+        if (OPAL_SUCCESS != opal_cond_init(&thread_pool.cond)) {
+            OBJ_DESTRUCT(&thread_pool.lock);
+            thread_pool.refcount = 0;
+            return OPAL_ERROR;
+        }
+        thread_pool.busy = 0;
+        thread_pool.state = THREAD_POOL_NOT_STARTED;
+    }
+    return OPAL_SUCCESS;
+}
+
+void opal_thread_pool_fini(void)
+{
+    if (0 == thread_pool.refcount || 0 != --thread_pool.refcount) {
+        return;
+    }
+    thread_pool_stop();
+    opal_cond_destroy(&thread_pool.cond);
+    OBJ_DESTRUCT(&thread_pool.lock);
+}
+
+int opal_thread_pool_concurrency(void)
+{
+    switch (thread_pool.state) {
+    case THREAD_POOL_RUNNING:
+        return thread_pool.nthreads + 1;
+    case THREAD_POOL_DISABLED:
+        return 1;
+    default:
+        return (opal_thread_pool_size > 0) ? opal_thread_pool_size + 1 : 1;
+    }
+}
+
+int opal_thread_pool_submit(opal_thread_pool_fn_t fn, void *arg, int n)
+{
+    thread_pool_job_t *job = &thread_pool.job;
+    int32_t expected = 0;
+
+    if (n <= 0 || opal_thread_pool_size <= 0 || 0 == thread_pool.refcount
+        || THREAD_POOL_DISABLED == thread_pool.state
+        || !opal_atomic_compare_exchange_strong_32(&thread_pool.busy, &expected, 1)) {
+        return OPAL_ERR_TEMP_OUT_OF_RESOURCE;
+    }
+    if (THREAD_POOL_NOT_STARTED == thread_pool.state && OPAL_SUCCESS != thread_pool_start()) {
+        thread_pool.busy = 0;
+        return OPAL_ERR_TEMP_OUT_OF_RESOURCE;
+    }
+
+    job->fn = fn;
+    job->arg = arg;
+    job->ntasks = n;
+    job->next = 0;
+    thread_pool.pending = thread_pool.nthreads;
+
+    opal_mutex_lock(&thread_pool.lock);
+    thread_pool.generation++;
+    opal_cond_broadcast(&thread_pool.cond);
+    opal_mutex_unlock(&thread_pool.lock);
+
+    return OPAL_SUCCESS;
+}
+
+void opal_thread_pool_wait(void)
+{
+    thread_pool_run(&thread_pool.job);
+
+    while (thread_pool.pending > 0) {
+        opal_atomic_rmb();
+    }
+    opal_atomic_rmb();
+    opal_atomic_wmb();
+    thread_pool.busy = 0;
+}
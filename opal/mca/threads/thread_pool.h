@@ -0,0 +1,81 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * Process-wide pool of helper threads splitting a large piece of work
+ * (a reduction, a pack, a copy) with the calling thread.
+ *
+ * A job is made of n independent tasks, fn(arg, 0) to fn(arg, n - 1).
+ * opal_thread_pool_submit() hands the job to the helpers, and the
+ * submitting thread then calls opal_thread_pool_wait(), which runs the
+ * tasks the helpers did not take yet and returns once all of them are
+ * completed. A single job is in flight at any time: submit fails when
+ * the pool is in use (or has no helper), and the caller does the work
+ * by itself.
+ *
+ * The helpers are started by the first submitted job, and never call
+ * into the progress engine.
+ */
+
+#ifndef OPAL_MCA_THREADS_THREAD_POOL_H
+#define OPAL_MCA_THREADS_THREAD_POOL_H
+
+#include "opal_config.h"
+
+#include <stdbool.h>
+
+BEGIN_C_DECLS
+
+/** Number of helper threads (0 disables the pool) */
+OPAL_DECLSPEC extern int opal_thread_pool_size;
+/** Bind each helper to a distinct core of the process binding */
+OPAL_DECLSPEC extern bool opal_thread_pool_bind;
+
+typedef void (*opal_thread_pool_fn_t)(void *arg, int task);
+
+/**
+ * Take a reference on the pool. Every user of the pool calls it once
+ * before submitting any job.
+ */
+OPAL_DECLSPEC int opal_thread_pool_init(void);
+
+/**
+ * Release a reference, the helpers are stopped with the last one.
+ */
+OPAL_DECLSPEC void opal_thread_pool_fini(void);
+
+/**
+ * Number of threads running a job, the caller included. Before the
+ * first job this is the number of threads requested, the binding may
+ * reduce it when the helpers are started.
+ */
+OPAL_DECLSPEC int opal_thread_pool_concurrency(void);
+
+/**
+ * Hand the n tasks of a job to the helpers.
+ *
+ * @returns OPAL_SUCCESS, in which case the caller must call
+ *          opal_thread_pool_wait(), or OPAL_ERR_TEMP_OUT_OF_RESOURCE if
+ *          the pool is disabled or busy.
+ */
+OPAL_DECLSPEC int opal_thread_pool_submit(opal_thread_pool_fn_t fn, void *arg, int n);
+
+/**
+ * Run the remaining tasks of the job submitted by the calling thread,
+ * and wait for the helpers to complete theirs.
+ */
+OPAL_DECLSPEC void opal_thread_pool_wait(void);
+
+END_C_DECLS
+
+#endif /* OPAL_MCA_THREADS_THREAD_POOL_H */
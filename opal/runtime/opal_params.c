@@ -41,6 +41,7 @@
 #include "opal/mca/base/mca_base_var.h"
 #include "opal/mca/shmem/base/base.h"
 #include "opal/mca/threads/mutex.h"
+#include "opal/mca/threads/thread_pool.h"
 #include "opal/mca/threads/threads.h"
 #include "opal/runtime/opal.h"
 #include "opal/runtime/opal_params.h"
@@ -358,6 +359,23 @@ int opal_register_params(void)
                                  MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_8,
                                  MCA_BASE_VAR_SCOPE_READONLY, &opal_max_thread_in_progress);
 
+    /* Helper threads shared by the components splitting large pieces of work */
+    (void) mca_base_var_register("opal", "opal", "thread_pool", "size",
+                                 "Number of helper threads splitting large reductions (op/mt), "
+                                 "the pack and unpack of large non-contiguous buffers and "
+                                 "huge CMA copies (btl/sm) with the calling thread. When "
+                                 "binding is enabled this is capped by the number of cores "
+                                 "in the process binding minus one. "
+                                 "0 disables the helper threads (default: 0)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &opal_thread_pool_size);
+
+    (void) mca_base_var_register("opal", "opal", "thread_pool", "bind",
+                                 "Bind each helper thread to a distinct core of the process "
+                                 "binding (default: true)",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0, OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &opal_thread_pool_bind);
+
     /* The ddt engine has a few parameters */
     ret = opal_datatype_register_params();
     if (OPAL_SUCCESS != ret) {
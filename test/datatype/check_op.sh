@@ -67,6 +67,18 @@ for op in max min sum prod; do
     done
 done
 
+echo "=======Half precision float type all operations========"
+echo ""
+for op in max min sum prod; do
+    for size in 1024 127 130; do
+        foo=$((1024 * 1024 + $size))
+        echo -e "Test $Yellow __mm512 instruction for loop $NC Total_num_bits = $foo * 16"
+        cmd="$mpirun -np 1 reduce_local -l $foo -u $foo -t f -s 16 -o $op"
+        if test $verbose -eq 1 ; then echo $cmd; fi
+        eval $cmd
+    done
+done
+
 echo "========Double type all operations========="
 echo ""
 for op in max min sum prod; do
@@ -79,3 +91,34 @@ for op in max min sum prod; do
     done
 done
 
+
+echo "========Min and max location pairs========="
+echo ""
+for op in maxloc minloc; do
+    for type in "i 32" "i 64" "f 32" "d 64"; do
+        set -- $type
+        for size in 0 1 7 15 31 63 127 130; do
+            foo=$((1024 * 1024 + $size))
+            echo -e "Test $Yellow __mm512 instruction for loop $NC Total_num_bits = $foo * $2 * 2"
+            cmd="$mpirun -np 1 reduce_local -l $foo -u $foo -t $1 -s $2 -o $op"
+            if test $verbose -eq 1 ; then echo $cmd; fi
+            eval $cmd
+        done
+    done
+done
+
+echo "========Multithreaded reductions========="
+echo ""
+mt="--mca opal_thread_pool_size 3 --mca opal_thread_pool_bind 0 --mca op_mt_threshold 65536 --mca op_mt_min_chunk 16384"
+for op in sum max maxloc; do
+    for type in "i 32" "d 64"; do
+        set -- $type
+        for size in 0 1 127 130; do
+            foo=$((1024 * 1024 + $size))
+            echo -e "Test $Yellow op/mt split reduction $NC Total_num_bits = $foo * $2"
+            cmd="$mpirun $mt -np 1 reduce_local -l $foo -u $foo -t $1 -s $2 -o $op"
+            if test $verbose -eq 1 ; then echo $cmd; fi
+            eval $cmd
+        done
+    done
+done
@@ -0,0 +1,437 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * Throughput of the datatype engine. For a set of layouts and packed sizes
+ * it measures, in GB/s of packed data:
+ *  - pack: MPI_Pack of the whole buffer,
+ *  - unpack: MPI_Unpack of the whole buffer,
+ *  - position: packing in fragments taken in reverse order, each of them
+ *    requiring the convertor to be repositioned,
+ *  - raw: the generation of the iovecs describing the buffer.
+ *
+ * The results are printed one per line as "layout operation bytes GB/s",
+ * and can be saved (-o) and used as the baseline of a later run (-b), in
+ * which case the measurements slower than the baseline by more than the
+ * tolerance are reported and the benchmark fails.
+ *
+ * It is not part of the tests, run it with "make bench" (the options can
+ * be given in DDT_BENCH_FLAGS).
+ */
+
+#include "ompi_config.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mpi.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "opal/datatype/opal_convertor.h"
+
+#define DDT_BENCH_MAX_RESULTS 1024
+#define DDT_BENCH_RAW_IOVECS  256
+
+typedef struct {
+    char layout[32];
+    char op[16];
+    size_t bytes;
+    double gbps;
+} ddt_bench_result_t;
+
+typedef int (*ddt_bench_layout_fn)(size_t bytes, MPI_Datatype *ddt, int *count);
+
+static double min_time = 0.1;
+static size_t fragment_size = 64 * 1024;
+static ddt_bench_result_t results[DDT_BENCH_MAX_RESULTS];
+static int nb_results = 0;
+
+/* 4 doubles every 8 */
+static int layout_vector(size_t bytes, MPI_Datatype *ddt, int *count)
+{
+    MPI_Type_vector((int) (bytes / (4 * sizeof(double))), 4, 8, MPI_DOUBLE, ddt);
+    *count = 1;
+    return MPI_SUCCESS;
+}
+
+/* one int every two, the worst case of the short blocks */
+static int layout_vector_short(size_t bytes, MPI_Datatype *ddt, int *count)
+{
+    MPI_Type_vector((int) (bytes / sizeof(int)), 1, 2, MPI_INT, ddt);
+    *count = 1;
+    return MPI_SUCCESS;
+}
+
+/* irregular blocks of 1 to 8 ints with irregular gaps */
+static int layout_indexed(size_t bytes, MPI_Datatype *ddt, int *count)
+{
+    int blocklens[64], displs[64], disp = 0, size = 0;
+
+    for (int i = 0; i < 64; i++) {
+        blocklens[i] = 1 + (i * 5) % 8;
+        displs[i] = disp;
+        disp += blocklens[i] + 1 + (i % 3);
+        size += blocklens[i];
+    }
+    MPI_Type_indexed(64, blocklens, displs, MPI_INT, ddt);
+    *count = (int) (bytes / (size * sizeof(int)));
+    return MPI_SUCCESS;
+}
+
+/* interior of a 3D array of doubles, as the halo exchanges use */
+static int layout_subarray(size_t bytes, MPI_Datatype *ddt, int *count)
+{
+    int sizes[3], subsizes[3], starts[3] = {2, 2, 2}, n = 1;
+
+    while (((size_t) (n + 1) * (n + 1) * (n + 1) * sizeof(double)) <= bytes) {
+        n++;
+    }
+    sizes[0] = sizes[1] = sizes[2] = n + 4;
+    subsizes[0] = subsizes[1] = subsizes[2] = n;
+    MPI_Type_create_subarray(3, sizes, subsizes, starts, MPI_ORDER_C, MPI_DOUBLE, ddt);
+    *count = 1;
+    return MPI_SUCCESS;
+}
+
+struct ddt_bench_struct {
+    char c;
+    double d;
+    int i[3];
+};
+
+static MPI_Datatype create_struct_type(void)
+{
+    int blocklens[3] = {1, 1, 3};
+    MPI_Aint displs[3] = {offsetof(struct ddt_bench_struct, c),
+                          offsetof(struct ddt_bench_struct, d),
+                          offsetof(struct ddt_bench_struct, i)};
+    MPI_Datatype types[3] = {MPI_CHAR, MPI_DOUBLE, MPI_INT}, tmp, ddt;
+
+    MPI_Type_create_struct(3, blocklens, displs, types, &tmp);
+    MPI_Type_create_resized(tmp, 0, sizeof(struct ddt_bench_struct), &ddt);
+    MPI_Type_free(&tmp);
+    return ddt;
+}
+
+/* an array of C structures */
+static int layout_struct(size_t bytes, MPI_Datatype *ddt, int *count)
+{
+    *ddt = create_struct_type();
+    *count = (int) (bytes / (1 + sizeof(double) + 3 * sizeof(int)));
+    return MPI_SUCCESS;
+}
+
+/* two pairs of floats in 64 bytes, repeated with the resized extent */
+static int layout_resized(size_t bytes, MPI_Datatype *ddt, int *count)
+{
+    MPI_Datatype tmp;
+
+    MPI_Type_vector(2, 2, 4, MPI_FLOAT, &tmp);
+    MPI_Type_create_resized(tmp, 0, 64, ddt);
+    MPI_Type_free(&tmp);
+    *count = (int) (bytes / (4 * sizeof(float)));
+    return MPI_SUCCESS;
+}
+
+/* a vector of structures inside an indexed type */
+static int layout_nested(size_t bytes, MPI_Datatype *ddt, int *count)
+{
+    MPI_Datatype st = create_struct_type(), vec;
+    int blocklens[2] = {1, 2}, displs[2] = {0, 3}, size;
+
+    MPI_Type_vector(16, 2, 3, st, &vec);
+    MPI_Type_indexed(2, blocklens, displs, vec, ddt);
+    MPI_Type_free(&vec);
+    MPI_Type_free(&st);
+    MPI_Type_size(*ddt, &size);
+    *count = (int) (bytes / size);
+    return MPI_SUCCESS;
+}
+
+static const struct {
+    const char *name;
+    ddt_bench_layout_fn create;
+} layouts[] = {{"vector", layout_vector},   {"vector_short", layout_vector_short},
+               {"indexed", layout_indexed}, {"subarray", layout_subarray},
+               {"struct", layout_struct},   {"resized", layout_resized},
+               {"nested", layout_nested},   {NULL, NULL}};
+
+static void op_pack(MPI_Datatype ddt, int count, void *buf, void *packed, int packed_size)
+{
+    int pos = 0;
+    MPI_Pack(buf, count, ddt, packed, packed_size, &pos, MPI_COMM_WORLD);
+}
+
+static void op_unpack(MPI_Datatype ddt, int count, void *buf, void *packed, int packed_size)
+{
+    int pos = 0;
+    MPI_Unpack(packed, packed_size, &pos, buf, count, ddt, MPI_COMM_WORLD);
+}
+
+static void op_position(MPI_Datatype ddt, int count, void *buf, void *packed, int packed_size)
+{
+    opal_convertor_t *convertor = opal_convertor_create(opal_local_arch, 0);
+    size_t last = ((size_t) packed_size - 1) / fragment_size * fragment_size;
+
+    opal_convertor_prepare_for_send(convertor, &ddt->super, count, buf);
+    for (size_t offset = last;; offset -= fragment_size) {
+        struct iovec iov = {.iov_base = (char *) packed + offset,
+                            .iov_len = (size_t) packed_size - offset};
+        uint32_t iov_count = 1;
+        size_t position = offset, max_data = fragment_size;
+
+        opal_convertor_set_position(convertor, &position);
+        opal_convertor_pack(convertor, &iov, &iov_count, &max_data);
+        if (0 == offset) {
+            break;
+        }
+    }
+    OBJ_RELEASE(convertor);
+}
+
+static void op_raw(MPI_Datatype ddt, int count, void *buf, void *packed, int packed_size)
+{
+    opal_convertor_t *convertor = opal_convertor_create(opal_local_arch, 0);
+    struct iovec iov[DDT_BENCH_RAW_IOVECS];
+    size_t length;
+    uint32_t iov_count;
+    int done;
+
+    (void) packed;
+    (void) packed_size;
+    opal_convertor_prepare_for_send(convertor, &ddt->super, count, buf);
+    do {
+        iov_count = DDT_BENCH_RAW_IOVECS;
+        done = opal_convertor_raw(convertor, iov, &iov_count, &length);
+    } while (!done);
+    OBJ_RELEASE(convertor);
+}
+
+/* true if name is one of the entries of the comma separated list (or there
+ * is no list) */
+static bool ddt_bench_selected(const char *list, const char *name)
+{
+    char *copy, *entry, *save = NULL;
+    bool found = false;
+
+    if (NULL == list) {
+        return true;
+    }
+    copy = strdup(list);
+    for (entry = strtok_r(copy, ",", &save); NULL != entry; entry = strtok_r(NULL, ",", &save)) {
+        if (0 == strcmp(entry, name)) {
+            found = true;
+            break;
+        }
+    }
+    free(copy);
+    return found;
+}
+
+static const struct {
+    const char *name;
+    void (*run)(MPI_Datatype ddt, int count, void *buf, void *packed, int packed_size);
+} ops[] = {{"pack", op_pack},
+           {"unpack", op_unpack},
+           {"position", op_position},
+           {"raw", op_raw},
+           {NULL, NULL}};
+
+static void bench_layout(const char *name, ddt_bench_layout_fn create, size_t bytes,
+                         const char *ops_filter)
+{
+    MPI_Datatype ddt;
+    MPI_Aint lb, extent;
+    int count, size;
+    char *buf, *packed;
+
+    create(bytes, &ddt, &count);
+    MPI_Type_commit(&ddt);
+    MPI_Type_get_extent(ddt, &lb, &extent);
+    MPI_Type_size(ddt, &size);
+    if (0 == count || 0 == size) {
+        MPI_Type_free(&ddt);
+        return;
+    }
+    buf = malloc((size_t) (lb + count * extent));
+    packed = malloc((size_t) count * size);
+    memset(buf, 1, (size_t) (lb + count * extent));
+    memset(packed, 2, (size_t) count * size);
+
+    for (int o = 0; NULL != ops[o].name; o++) {
+        double start, elapsed;
+        long iterations = 0;
+
+        if (!ddt_bench_selected(ops_filter, ops[o].name)) {
+            continue;
+        }
+        ops[o].run(ddt, count, buf - lb, packed, count * size); /* warm up */
+        start = MPI_Wtime();
+        do {
+            ops[o].run(ddt, count, buf - lb, packed, count * size);
+            iterations++;
+            elapsed = MPI_Wtime() - start;
+        } while (elapsed < min_time);
+
+        if (nb_results < DDT_BENCH_MAX_RESULTS) {
+            ddt_bench_result_t *result = &results[nb_results++];
+            snprintf(result->layout, sizeof(result->layout), "%s", name);
+            snprintf(result->op, sizeof(result->op), "%s", ops[o].name);
+            result->bytes = (size_t) count * size;
+            result->gbps = (double) result->bytes * iterations / elapsed / 1e9;
+        }
+    }
+    free(packed);
+    free(buf);
+    MPI_Type_free(&ddt);
+}
+
+/*
+ * Compare the results with a baseline in the same format, and return the
+ * number of regressions (-1 if the baseline cannot be read).
+ */
+static int compare_baseline(const char *filename, double tolerance, FILE *out)
+{
+    char line[256], layout[32], op[16];
+    size_t bytes;
+    double gbps;
+    int regressions = 0;
+    FILE *f = fopen(filename, "r");
+
+    if (NULL == f) {
+        fprintf(stderr, "cannot open the baseline %s\n", filename);
+        return -1;
+    }
+    fprintf(out, "# comparison with %s (tolerance %.1f%%)\n", filename, tolerance);
+    fprintf(out, "# layout operation bytes GB/s baseline ratio\n");
+    while (NULL != fgets(line, sizeof(line), f)) {
+        if (('#' == line[0])
+            || (4 != sscanf(line, "%31s %15s %zu %lf", layout, op, &bytes, &gbps))) {
+            continue;
+        }
+        for (int i = 0; i < nb_results; i++) {
+            double ratio;
+
+            if ((bytes != results[i].bytes) || strcmp(layout, results[i].layout)
+                || strcmp(op, results[i].op)) {
+                continue;
+            }
+            ratio = results[i].gbps / gbps;
+            fprintf(out, "%s %s %zu %.3f %.3f %.3f%s\n", layout, op, bytes, results[i].gbps, gbps,
+                    ratio, (ratio < (1.0 - tolerance / 100.0)) ? " REGRESSION" : "");
+            if (ratio < (1.0 - tolerance / 100.0)) {
+                regressions++;
+            }
+        }
+    }
+    fclose(f);
+    return regressions;
+}
+
+int main(int argc, char **argv)
+{
+    size_t sizes[] = {1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024};
+    size_t max_size = 16 * 1024 * 1024;
+    char *layouts_filter = NULL, *ops_filter = NULL, *output = NULL, *baseline = NULL;
+    double tolerance = 10.0;
+    FILE *out = stdout;
+    int c, rc = 0;
+
+    MPI_Init(&argc, &argv);
+
+    while (-1 != (c = getopt(argc, argv, "l:p:m:t:f:o:b:r:h"))) {
+        switch (c) {
+        case 'l':
+            layouts_filter = optarg;
+            break;
+        case 'p':
+            ops_filter = optarg;
+            break;
+        case 'm':
+            max_size = strtoul(optarg, NULL, 10);
+            break;
+        case 't':
+            min_time = atof(optarg);
+            break;
+        case 'f':
+            fragment_size = strtoul(optarg, NULL, 10);
+            if (0 == fragment_size) {
+                fprintf(stderr, "The fragment size must be positive\n");
+                exit(-1);
+            }
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 'b':
+            baseline = optarg;
+            break;
+        case 'r':
+            tolerance = atof(optarg);
+            break;
+        case 'h':
+            fprintf(stdout, "%s options are:\n"
+                    " -l <names> : comma separated list of layouts among\n"
+                    "              vector, vector_short, indexed, subarray, struct, resized, nested\n"
+                    " -p <names> : comma separated list of operations among\n"
+                    "              pack, unpack, position, raw\n"
+                    " -m <bytes> : largest packed size (default 16MB)\n"
+                    " -t <seconds> : minimum duration of each measurement (default 0.1)\n"
+                    " -f <bytes> : fragment size of the position operation (default 64KB)\n"
+                    " -o <file> : save the results in the file instead of printing them\n"
+                    " -b <file> : compare the results with this baseline\n"
+                    " -r <percent> : tolerated slowdown compared with the baseline (default 10)\n"
+                    " -h: this help message\n", argv[0]);
+            MPI_Finalize();
+            exit(0);
+        }
+    }
+
+    for (int l = 0; NULL != layouts[l].name; l++) {
+        if (!ddt_bench_selected(layouts_filter, layouts[l].name)) {
+            continue;
+        }
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            if (sizes[s] <= max_size) {
+                bench_layout(layouts[l].name, layouts[l].create, sizes[s], ops_filter);
+            }
+        }
+    }
+
+    if ((NULL != output) && (NULL == (out = fopen(output, "w")))) {
+        fprintf(stderr, "cannot create %s\n", output);
+        out = stdout;
+    }
+    fprintf(out, "# layout operation bytes GB/s\n");
+    for (int i = 0; i < nb_results; i++) {
+        fprintf(out, "%s %s %zu %.3f\n", results[i].layout, results[i].op, results[i].bytes,
+                results[i].gbps);
+    }
+    if (stdout != out) {
+        fclose(out);
+    }
+    if (NULL != baseline) {
+        int regressions = compare_baseline(baseline, tolerance, stdout);
+        if (0 > regressions) {
+            rc = 1;
+        } else if (0 != regressions) {
+            fprintf(stderr, "%d measurements are slower than the baseline %s\n", regressions,
+                    baseline);
+            rc = 1;
+        }
+    }
+
+    MPI_Finalize();
+    return rc;
+}
@@ -25,6 +25,7 @@
 #include "ompi_config.h"
 #include "ddt_lib.h"
 #include "opal/datatype/opal_convertor.h"
+#include "opal/datatype/opal_convertor_internal.h"
 #include "opal/runtime/opal.h"
 
 #include <time.h>
@@ -140,6 +141,193 @@ static int local_copy_ddt_raw( ompi_datatype_t* pdt, int count, int iov_num )
     return OMPI_SUCCESS;
 }
 
+/**
+ * Extract the raw description starting from the middle of the data, once with
+ * the raw cache disabled and once with the cache enabled, and check that both
+ * describe the same memory regions.
+ */
+static int local_compare_ddt_raw_cache( ompi_datatype_t* pdt, int count, int iov_num,
+                                        size_t position )
+{
+    struct iovec* iov[2];
+    uint32_t used[2], iov_count, j;
+    opal_convertor_t* convertor;
+    size_t max_data, pos;
+    int i, cache_entries = opal_convertor_raw_cache_entries, rc = OMPI_SUCCESS;
+    int32_t done;
+
+    for( i = 0; i < 2; i++ ) {
+        iov[i] = (struct iovec*)malloc(count * pdt->super.size * sizeof(struct iovec));
+        used[i] = 0;
+        opal_convertor_raw_cache_entries = (0 == i) ? 0 : 16;
+
+        convertor = opal_convertor_create( remote_arch, 0 );
+        if( OMPI_SUCCESS != opal_convertor_prepare_for_send( convertor, &(pdt->super), count, NULL ) ) {
+            printf( "Cannot attach the datatype to a convertor\n" );
+            return OMPI_ERROR;
+        }
+        pos = position;
+        opal_convertor_set_position( convertor, &pos );
+        do {
+            iov_count = iov_num;
+            done = opal_convertor_raw( convertor, iov[i] + used[i], &iov_count, &max_data );
+            used[i] += iov_count;
+            if( 0 == (used[i] % 7) ) {  /* move around to force a resync of the stack */
+                pos = convertor->bConverted;
+                opal_convertor_set_position( convertor, &pos );
+            }
+        } while( 0 == done );
+        OBJ_RELEASE( convertor );
+        /* the iovecs are split differently depending on the call boundaries, merge them */
+        for( iov_count = 0, j = 1; j < used[i]; j++ ) {
+            if( ((char*)iov[i][iov_count].iov_base + iov[i][iov_count].iov_len) == iov[i][j].iov_base ) {
+                iov[i][iov_count].iov_len += iov[i][j].iov_len;
+            } else {
+                iov[i][++iov_count] = iov[i][j];
+            }
+        }
+        used[i] = (0 == used[i]) ? 0 : iov_count + 1;
+    }
+    opal_convertor_raw_cache_entries = cache_entries;
+
+    if( used[0] != used[1] ) {
+        printf( "raw cache: %u iovecs instead of %u\n", used[1], used[0] );
+        rc = OMPI_ERROR;
+    }
+    for( i = 0; (OMPI_SUCCESS == rc) && (i < (int)used[0]); i++ ) {
+        if( (iov[0][i].iov_base != iov[1][i].iov_base) || (iov[0][i].iov_len != iov[1][i].iov_len) ) {
+            printf( "raw cache: iovec %d is {%p, %zu} instead of {%p, %zu}\n", i,
+                    iov[1][i].iov_base, iov[1][i].iov_len, iov[0][i].iov_base, iov[0][i].iov_len );
+            rc = OMPI_ERROR;
+        }
+    }
+    free(iov[0]);
+    free(iov[1]);
+    printf( "raw cache from position %zu [%s]\n", position,
+            (OMPI_SUCCESS == rc) ? "PASSED" : "NOT PASSED" );
+    return rc;
+}
+
+/**
+ * Extract the raw description of a vector of doubles starting in the middle
+ * of one of its blocks, with the raw cache disabled. The first iovec must
+ * cover the rest of that block, and the iovecs the rest of the data.
+ */
+static int local_check_raw_partial_block( int blocklen, int stride, size_t position )
+{
+    ompi_datatype_t* pdt = create_vector_type( MPI_DOUBLE, 4, blocklen, stride );
+    size_t in_block = position % (blocklen * sizeof(double)), size = pdt->super.size;
+    int cache_entries = opal_convertor_raw_cache_entries, rc = OMPI_SUCCESS;
+    char* buf = (char*)malloc(pdt->super.true_ub);
+    size_t max_data, pos = position, total = 0;
+    opal_convertor_t* convertor;
+    struct iovec iov[8];
+    uint32_t iov_count;
+    char* expected;
+    int32_t done;
+
+    expected = buf + (position / (blocklen * sizeof(double))) * stride * sizeof(double) + in_block;
+    opal_convertor_raw_cache_entries = 0;
+    convertor = opal_convertor_create( remote_arch, 0 );
+    opal_convertor_prepare_for_send( convertor, &(pdt->super), 1, buf );
+    opal_convertor_set_position( convertor, &pos );
+    iov_count = 8;
+    done = opal_convertor_raw( convertor, iov, &iov_count, &max_data );
+    if( (0 == iov_count) || (iov[0].iov_base != expected) ||
+        (iov[0].iov_len != blocklen * sizeof(double) - in_block) ) {
+        printf( "raw from position %zu: first iovec {%p, %zu} instead of {%p, %zu}\n", position,
+                (0 == iov_count) ? NULL : iov[0].iov_base, (0 == iov_count) ? 0 : iov[0].iov_len,
+                (void*)expected, blocklen * sizeof(double) - in_block );
+        rc = OMPI_ERROR;
+    }
+    while( 1 ) {
+        for( uint32_t i = 0; i < iov_count; i++ ) total += iov[i].iov_len;
+        if( done || (0 == iov_count) || (total > size) ) break;
+        iov_count = 8;
+        done = opal_convertor_raw( convertor, iov, &iov_count, &max_data );
+    }
+    if( total != size - position ) {
+        printf( "raw from position %zu: %zu bytes described instead of %zu\n", position,
+                total, size - position );
+        rc = OMPI_ERROR;
+    }
+    OBJ_RELEASE( convertor );
+    opal_convertor_raw_cache_entries = cache_entries;
+    OBJ_RELEASE( pdt ); assert( pdt == NULL );
+    free(buf);
+
+    printf( "raw from position %zu inside a block [%s]\n", position,
+            (OMPI_SUCCESS == rc) ? "PASSED" : "NOT PASSED" );
+    return rc;
+}
+
+/**
+ * Describe the beginning of the data with the raw cache enabled, then pack
+ * the rest with the same convertor, once after repositioning it at the
+ * current position and once directly, and compare with a convertor that
+ * never used the cache. A cache hit leaves the stack of the convertor
+ * behind its position, which the pack has to rebuild.
+ */
+static int local_check_raw_cache_stack( ompi_datatype_t* pdt, int count, int iov_num )
+{
+    struct iovec* iov = (struct iovec*)malloc(iov_num * sizeof(struct iovec));
+    int i, cache_entries = opal_convertor_raw_cache_entries, rc = OMPI_SUCCESS;
+    size_t size = count * pdt->super.size, max_data, pos;
+    ptrdiff_t extent = pdt->super.true_ub;
+    char *buf, *packed, *packed_ref;
+    opal_convertor_t* convertor;
+    struct iovec piov;
+    uint32_t iov_count;
+
+    buf = (char*)malloc(count * extent);
+    packed = (char*)malloc(size);
+    packed_ref = (char*)malloc(size);
+    for( size_t j = 0; j < (size_t)(count * extent); j++ ) buf[j] = (char)j;
+
+    convertor = opal_convertor_create( remote_arch, 0 );
+    opal_convertor_prepare_for_send( convertor, &(pdt->super), count, buf );
+    piov.iov_base = packed_ref;
+    piov.iov_len = size;
+    iov_count = 1;
+    max_data = size;
+    opal_convertor_pack( convertor, &piov, &iov_count, &max_data );
+    OBJ_RELEASE( convertor );
+
+    opal_convertor_raw_cache_entries = 16;
+    for( i = 0; i < 2; i++ ) {
+        memset(packed, 0, size);
+        convertor = opal_convertor_create( remote_arch, 0 );
+        opal_convertor_prepare_for_send( convertor, &(pdt->super), count, buf );
+        iov_count = iov_num;
+        opal_convertor_raw( convertor, iov, &iov_count, &max_data );
+        iov_count = iov_num;
+        opal_convertor_raw( convertor, iov, &iov_count, &max_data );
+        pos = convertor->bConverted;
+        if( 0 == i ) {
+            opal_convertor_set_position( convertor, &pos );
+        }
+        piov.iov_base = packed + pos;
+        piov.iov_len = size - pos;
+        iov_count = 1;
+        max_data = size - pos;
+        opal_convertor_pack( convertor, &piov, &iov_count, &max_data );
+        OBJ_RELEASE( convertor );
+        if( (max_data != size - pos) || memcmp(packed + pos, packed_ref + pos, size - pos) ) {
+            printf( "raw cache: pack from position %zu %s differs\n", pos,
+                    (0 == i) ? "after set_position" : "without set_position" );
+            rc = OMPI_ERROR;
+        }
+    }
+    opal_convertor_raw_cache_entries = cache_entries;
+
+    free(iov);
+    free(buf);
+    free(packed);
+    free(packed_ref);
+    printf( "raw cache then pack [%s]\n", (OMPI_SUCCESS == rc) ? "PASSED" : "NOT PASSED" );
+    return rc;
+}
+
 /**
  * Go over a set of datatypes and copy them using the raw functionality provided by the
  * convertor. The goal of this test is to stress the convertor using several more or less
@@ -317,9 +505,29 @@ int main( int argc, char* argv[] )
     printf( ">>--------------------------------------------<<\n" );
     OBJ_RELEASE( pdt1 ); assert( pdt1 == NULL );
 
+    printf( "\n\n#\n * TEST RAW FROM INSIDE A BLOCK\n #\n\n" );
+    rc |= local_check_raw_partial_block( 5, 7, 16 );
+    rc |= local_check_raw_partial_block( 5, 7, 48 );
+    rc |= local_check_raw_partial_block( 3, 10, 8 );
+
+    printf( "\n\n#\n * TEST RAW CACHE\n #\n\n" );
+    pdt = upper_matrix(100);
+    rc = local_compare_ddt_raw_cache(pdt, 2, iov_num, 0);
+    rc |= local_compare_ddt_raw_cache(pdt, 2, iov_num, 4321);
+    OBJ_RELEASE( pdt ); assert( pdt == NULL );
+    pdt = create_vector_type( MPI_DOUBLE, 450, 10, 11 );
+    rc |= local_compare_ddt_raw_cache(pdt, 3, 1, 1003);
+    OBJ_RELEASE( pdt ); assert( pdt == NULL );
+    pdt = test_create_blacs_type();
+    rc |= local_compare_ddt_raw_cache(pdt, 10, iov_num, 555);
+    OBJ_RELEASE( pdt ); assert( pdt == NULL );
+    pdt = create_vector_type( MPI_DOUBLE, 450, 10, 11 );
+    rc |= local_check_raw_cache_stack(pdt, 2, iov_num);
+    OBJ_RELEASE( pdt ); assert( pdt == NULL );
+
     /* clean-ups all data allocations */
     ompi_datatype_finalize();
     opal_finalize_util ();
 
-    return OMPI_SUCCESS;
+    return (OMPI_SUCCESS == rc) ? OMPI_SUCCESS : 1;
 }
@@ -331,6 +331,48 @@ static int local_copy_with_convertor( ompi_datatype_t* pdt, int count, int chunk
     return OMPI_SUCCESS;
 }
 
+/**
+ * The committed datatypes with the same description share the optimized
+ * description, which must stay valid until the last of them is released.
+ */
+static int test_shared_opt_desc( void )
+{
+    ompi_datatype_t *pdt1, *pdt2, *pdt3, *pdup;
+    int rc = OMPI_SUCCESS;
+
+    pdt1 = create_vector_type( MPI_DOUBLE, 450, 10, 11 );
+    pdt2 = create_vector_type( MPI_DOUBLE, 450, 10, 11 );
+    pdt3 = create_vector_type( MPI_DOUBLE, 450, 10, 12 );
+    ompi_datatype_duplicate( pdt1, &pdup );
+
+    if( pdt1->super.opt_desc.desc != pdt2->super.opt_desc.desc ) {
+        printf( "identical datatypes do not share the optimized description\n" );
+        rc = OMPI_ERROR;
+    }
+    if( pdt1->super.opt_desc.desc != pdup->super.opt_desc.desc ) {
+        printf( "the duplicated datatype does not share the optimized description\n" );
+        rc = OMPI_ERROR;
+    }
+    if( pdt1->super.opt_desc.desc == pdt3->super.opt_desc.desc ) {
+        printf( "different datatypes share the optimized description\n" );
+        rc = OMPI_ERROR;
+    }
+
+    OBJ_RELEASE( pdt1 ); assert( pdt1 == NULL );
+    if( outputFlags & CHECK_PACK_UNPACK ) {
+        if( OMPI_SUCCESS != local_copy_with_convertor( pdt2, 1, 6000 ) ) rc = OMPI_ERROR;
+        if( OMPI_SUCCESS != local_copy_with_convertor_2datatypes( pdup, 1, pdt2, 1, 956 ) ) rc = OMPI_ERROR;
+        if( OMPI_SUCCESS != local_copy_with_convertor( pdt3, 1, 6000 ) ) rc = OMPI_ERROR;
+    }
+    OBJ_RELEASE( pdt2 ); assert( pdt2 == NULL );
+    if( outputFlags & CHECK_PACK_UNPACK ) {
+        if( OMPI_SUCCESS != local_copy_with_convertor( pdup, 1, 956 ) ) rc = OMPI_ERROR;
+    }
+    OBJ_RELEASE( pdup ); assert( pdup == NULL );
+    OBJ_RELEASE( pdt3 ); assert( pdt3 == NULL );
+    return rc;
+}
+
 /**
  * Main function. Call several tests and print-out the results. It try to stress the convertor
  * using difficult data-type constructions as well as strange segment sizes for the conversion.
@@ -538,8 +580,13 @@ int main( int argc, char* argv[] )
     OBJ_RELEASE( pdt1 ); assert( pdt1 == NULL );
     OBJ_RELEASE( pdt2 ); assert( pdt2 == NULL );
 
+    printf( ">>--------------------------------------------<<\n" );
+    printf( "Shared optimized descriptions\n" );
+    rc = test_shared_opt_desc();
+    printf( ">>--------------------------------------------<<\n" );
+
     /* clean-ups all data allocations */
     ompi_datatype_finalize();
 
-    return OMPI_SUCCESS;
+    return rc;
 }
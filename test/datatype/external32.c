@@ -12,11 +12,13 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "ompi_config.h"
 #include "ompi/datatype/ompi_datatype.h"
 #include "opal/runtime/opal.h"
 #include "opal/datatype/opal_convertor.h"
+#include "opal/datatype/opal_convertor_internal.h"
 #include "opal/datatype/opal_datatype_internal.h"
 #include <arpa/inet.h>
 
@@ -160,6 +162,59 @@ static int pack_unpack_datatype( void* send_data, ompi_datatype_t *datatype, int
     return (error == MPI_SUCCESS ? 0 : -1);
 }
 
+/*
+ * Compare the byte swapping kernels, for each instruction set, with a
+ * plain byte reversal of each element. The buffers are misaligned and
+ * the counts are not multiple of the vector widths on purpose.
+ */
+static int check_swap_kernels(void)
+{
+    size_t sizes[] = {2, 4, 8, 16, 3}, counts[] = {1, 2, 7, 33, 257, 1001};
+    uint8_t *from = (uint8_t*)malloc(16 * 1001 + 64), *to = (uint8_t*)malloc(16 * 1001 + 64);
+    int level, errors = 0;
+
+    for( size_t i = 0; i < 16 * 1001 + 64; i++ ) from[i] = (uint8_t)(i * 7 + 3);
+    for( level = OPAL_DATATYPE_SWAP_SCALAR; level <= OPAL_DATATYPE_SWAP_AVX512; level++ ) {
+        opal_datatype_swap_simd = level;
+        for( size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++ ) {
+            for( size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++ ) {
+                for( size_t misalign = 0; misalign < 4; misalign++ ) {
+                    size_t size = sizes[s], count = counts[c];
+                    memset(to, 0, 16 * 1001 + 64);
+                    opal_datatype_swap_bytes(to + misalign, from + 1, size, count);
+                    for( size_t e = 0; e < count; e++ ) {
+                        for( size_t b = 0; b < size; b++ ) {
+                            if( to[misalign + e * size + b] != from[1 + e * size + size - 1 - b] ) {
+                                printf("Error in the byte swap (level %d size %zu count %zu element %zu)\n",
+                                       level, size, count, e);
+                                errors++;
+                                goto next_count;
+                            }
+                        }
+                    }
+                    if( 0 != to[misalign + size * count] ) {
+                        printf("The byte swap wrote past the end (level %d size %zu count %zu)\n",
+                               level, size, count);
+                        errors++;
+                    }
+                    /* swapping twice in place gives back the original data */
+                    opal_datatype_swap_bytes(to + misalign, to + misalign, size, count);
+                    if( 0 != memcmp(to + misalign, from + 1, size * count) ) {
+                        printf("Error in the in place byte swap (level %d size %zu count %zu)\n",
+                               level, size, count);
+                        errors++;
+                    }
+                }
+            next_count: ;
+            }
+        }
+    }
+    opal_datatype_swap_simd = -1;
+    free(from);
+    free(to);
+    return errors;
+}
+
 int main(int argc, char *argv[])
 {
     opal_init_util(&argc, &argv);
@@ -245,6 +300,42 @@ int main(int argc, char *argv[])
         }
     }
 
+    /* Large contiguous data, converted as a whole array */
+    printf("\n\nLarge contiguous data\n\n");
+    {
+        ompi_datatype_t *types[2] = {&ompi_mpi_int32_t.dt, &ompi_mpi_int16_t.dt};
+        int32_t send_data[1001], recv_data[1001];
+        char packed[1001 * sizeof(int32_t)];
+
+        for( int t = 0; t < 2; t++ ) {
+            MPI_Aint position = 0;
+            size_t size = types[t]->super.size;
+
+            for( int i = 0; i < 1001; i++ ) send_data[i] = (int32_t)(0x01020304U * (uint32_t)(i + 1));
+            memset(recv_data, 0, sizeof(recv_data));
+            ompi_datatype_pack_external("external32", send_data, 1001, types[t],
+                                        packed, sizeof(packed), &position);
+            if( (position != (MPI_Aint)(1001 * size)) ||
+                (0 != check_contiguous(send_data, packed, types[t], 1001, NULL)) ) {
+                printf("Error during external32 pack of large contiguous data (%s)\n", types[t]->name);
+                exit(-1);
+            }
+            position = 0;
+            ompi_datatype_unpack_external("external32", packed, sizeof(packed), &position,
+                                          recv_data, 1001, types[t]);
+            if( 0 != memcmp(send_data, recv_data, 1001 * size) ) {
+                printf("Error during external32 unpack of large contiguous data (%s)\n", types[t]->name);
+                exit(-1);
+            }
+        }
+    }
+
+    /* Byte swapping kernels */
+    printf("\n\nByte swapping kernels\n\n");
+    if( 0 != check_swap_kernels() ) {
+        exit(-1);
+    }
+
     ompi_datatype_finalize();
 
     return 0;
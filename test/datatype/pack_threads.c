@@ -0,0 +1,113 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * Check that packing and unpacking large buffers with the helper threads
+ * produces the same result as converting them one datatype at a time,
+ * which stays below the threshold and goes through the single threaded
+ * path.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+
+static int errors = 0;
+
+static void check(const char *name, MPI_Datatype ddt, int count)
+{
+    MPI_Aint lb, extent;
+    int size, pos = 0, pos_ref = 0;
+    size_t len;
+    unsigned char *src, *dst, *dst_ref, *packed, *packed_ref;
+
+    MPI_Type_get_extent(ddt, &lb, &extent);
+    len = (size_t) (lb + count * extent);
+    src = malloc(len);
+    dst = malloc(len);
+    dst_ref = malloc(len);
+    for (size_t i = 0; i < len; ++i) {
+        src[i] = (unsigned char) (i * 7 + 3);
+        dst[i] = dst_ref[i] = 0xaa;
+    }
+    MPI_Pack_size(count, ddt, MPI_COMM_WORLD, &size);
+    packed = malloc(size);
+    packed_ref = malloc(size);
+
+    MPI_Pack(src, count, ddt, packed, size, &pos, MPI_COMM_WORLD);
+    for (int i = 0; i < count; ++i) {
+        MPI_Pack(src + i * extent, 1, ddt, packed_ref, size, &pos_ref, MPI_COMM_WORLD);
+    }
+    if (pos != pos_ref || 0 != memcmp(packed, packed_ref, pos)) {
+        printf("%s: the packed data differ\n", name);
+        errors++;
+    }
+
+    pos = pos_ref = 0;
+    MPI_Unpack(packed, size, &pos, dst, count, ddt, MPI_COMM_WORLD);
+    for (int i = 0; i < count; ++i) {
+        MPI_Unpack(packed_ref, size, &pos_ref, dst_ref + i * extent, 1, ddt, MPI_COMM_WORLD);
+    }
+    if (0 != memcmp(dst, dst_ref, len)) {
+        printf("%s: the unpacked data differ\n", name);
+        errors++;
+    }
+
+    free(src);
+    free(dst);
+    free(dst_ref);
+    free(packed);
+    free(packed_ref);
+}
+
+int main(int argc, char **argv)
+{
+    MPI_Datatype vector, structure, vector_of_structs;
+    int blocklens[3] = {1, 3, 1};
+    MPI_Aint displs[3] = {0, 8, 40};
+    MPI_Datatype types[3] = {MPI_CHAR, MPI_DOUBLE, MPI_SHORT};
+
+    /* Force the helper threads on buffers much smaller than the default
+       threshold, the threads are only used by MPI_Pack and MPI_Unpack
+       calls converting many datatypes at once. The helpers are not bound,
+       so that they run on machines with few cores too. */
+    setenv("OMPI_MCA_opal_thread_pool_size", "3", 0);
+    setenv("OMPI_MCA_opal_thread_pool_bind", "0", 0);
+    setenv("OMPI_MCA_mpi_ddt_pack_threshold", "4096", 0);
+
+    MPI_Init(&argc, &argv);
+
+    MPI_Type_vector(1000, 3, 5, MPI_INT, &vector);
+    MPI_Type_commit(&vector);
+    check("vector", vector, 50);
+
+    /* predefined types of different sizes, the parts must not split them */
+    MPI_Type_create_struct(3, blocklens, displs, types, &structure);
+    MPI_Type_commit(&structure);
+    check("struct", structure, 20000);
+
+    MPI_Type_vector(777, 2, 3, structure, &vector_of_structs);
+    MPI_Type_commit(&vector_of_structs);
+    check("vector of structs", vector_of_structs, 13);
+
+    MPI_Type_free(&vector);
+    MPI_Type_free(&structure);
+    MPI_Type_free(&vector_of_structs);
+
+    if (0 == errors) {
+        printf("Pack and unpack with helper threads are correct\n");
+    }
+    MPI_Finalize();
+    return (0 == errors) ? 0 : 1;
+}
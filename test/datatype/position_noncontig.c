@@ -186,66 +186,118 @@ extern bool opal_ddt_pack_debug;
 extern bool opal_ddt_position_debug ;
 #endif  /* OPAL_ENABLE_DEBUG */
 
-int main( int argc, char* argv[] )
+/*
+ * Pack and unpack the data in shuffled segments and compare with a copy
+ * of the data done by the datatype engine in a single step.
+ */
+static int
+check_datatype( ompi_datatype_t* datatype, int count, int nelt, int show_only_first_error )
 {
     ddt_segment_t* segments;
-    int *send_buffer, *recv_buffer;
+    int *send_buffer, *recv_buffer, *expected;
     int i, seg_count, errors;
-    int show_only_first_error = 1;
-    ompi_datatype_t* datatype = MPI_DATATYPE_NULL;
 
-#define NELT (300)
-    send_buffer = malloc(NELT*sizeof(int));
-    recv_buffer = malloc(NELT*sizeof(int));
-    for (i = 0; i < NELT; ++i) {
+    send_buffer = malloc(nelt*sizeof(int));
+    recv_buffer = malloc(nelt*sizeof(int));
+    expected = malloc(nelt*sizeof(int));
+    for (i = 0; i < nelt; ++i) {
         send_buffer[i] = i;
         recv_buffer[i] = 0xdeadbeef;
+        expected[i] = 0xdeadbeef;
     }
+    ompi_datatype_copy_content_same_ddt( datatype, count, (char*)expected, (char*)send_buffer );
 
-    opal_init_util (NULL, NULL);
-    ompi_datatype_init();
-
-    ompi_datatype_create_vector(NELT/2, 1, 2, MPI_INT, &datatype);
-    ompi_datatype_commit(&datatype);
-
-#if (OPAL_ENABLE_DEBUG == 1) && (OPAL_C_HAVE_VISIBILITY == 0)
-    opal_ddt_unpack_debug   = false;
-    opal_ddt_pack_debug     = false;
-    opal_ddt_position_debug = false;
-#endif  /* OPAL_ENABLE_DEBUG */
-
-    create_segments( datatype, 1, fragment_size,
+    create_segments( datatype, count, fragment_size,
                      &segments, &seg_count );
 
     /* shuffle the segments */
     shuffle_segments( segments, seg_count );
 
     /* pack the data */
-    pack_segments( datatype, 1, fragment_size, segments, seg_count,
+    pack_segments( datatype, count, fragment_size, segments, seg_count,
                    send_buffer );
 
     /* unpack the data back in the user space (recv buffer) */
-    unpack_segments( datatype, 1, fragment_size, segments, seg_count,
+    unpack_segments( datatype, count, fragment_size, segments, seg_count,
                      recv_buffer );
 
     /* And now check the data */
-    for( errors = i = 0; i < NELT; i++ ) {
-        int expected = ((i % 2) ? (int)0xdeadbeef : i);
-        if (recv_buffer[i] != expected) {
+    for( errors = i = 0; i < nelt; i++ ) {
+        if (recv_buffer[i] != expected[i]) {
             if( (show_only_first_error && (0 == errors)) ||
                 !show_only_first_error ) {
-                printf("error at index %4d: 0x%08x != 0x%08x\n", i, recv_buffer[i], expected);
+                printf("error at index %4d: 0x%08x != 0x%08x\n", i, recv_buffer[i], expected[i]);
             }
             errors++;
         }
     }
-    printf( "Found %d errors\n", errors );
-    free(send_buffer); free(recv_buffer);
+    free(send_buffer); free(recv_buffer); free(expected);
 
     for( i = 0; i < seg_count; i++ ) {
         free( segments[i].buffer );
     }
     free(segments);
+    return errors;
+}
+
+int main( int argc, char* argv[] )
+{
+    int i, errors;
+    int show_only_first_error = 1;
+    ompi_datatype_t* datatype = MPI_DATATYPE_NULL;
+
+    opal_init_util (NULL, NULL);
+    ompi_datatype_init();
+
+#if (OPAL_ENABLE_DEBUG == 1) && (OPAL_C_HAVE_VISIBILITY == 0)
+    opal_ddt_unpack_debug   = false;
+    opal_ddt_pack_debug     = false;
+    opal_ddt_position_debug = false;
+#endif  /* OPAL_ENABLE_DEBUG */
+
+#define NELT (300)
+    ompi_datatype_create_vector(NELT/2, 1, 2, MPI_INT, &datatype);
+    ompi_datatype_commit(&datatype);
+    errors = check_datatype( datatype, 1, NELT, show_only_first_error );
+    ompi_datatype_destroy( &datatype );
+
+    /* An irregular datatype with enough elements to get a position index,
+     * repeated a few times to move between the instances.
+     */
+    {
+#define NBLOCKS (200)
+        int blocklens[NBLOCKS], displs[NBLOCKS], extent = 0;
+        for( i = 0; i < NBLOCKS; i++ ) {
+            blocklens[i] = 1 + (i % 7);
+            displs[i] = extent + (i % 3) + 1;
+            extent = displs[i] + blocklens[i];
+        }
+        ompi_datatype_create_indexed(NBLOCKS, blocklens, displs, MPI_INT, &datatype);
+        ompi_datatype_commit(&datatype);
+        errors += check_datatype( datatype, 3, 3 * extent, show_only_first_error );
+        ompi_datatype_destroy( &datatype );
+    }
+
+    /* The same with loops on the top level of the description */
+    {
+        ompi_datatype_t* vector, *types[NBLOCKS];
+        int blocklens[NBLOCKS];
+        ptrdiff_t displs[NBLOCKS], extent = 0;
+
+        ompi_datatype_create_vector(5, 2, 3, MPI_INT, &vector);
+        for( i = 0; i < NBLOCKS; i++ ) {
+            types[i] = (i % 2) ? vector : (ompi_datatype_t*)&ompi_mpi_int.dt;
+            blocklens[i] = 1 + (i % 3);
+            displs[i] = extent + sizeof(int);
+            extent = displs[i] + blocklens[i] * ((i % 2) ? 14 : 1) * sizeof(int);
+        }
+        ompi_datatype_create_struct(NBLOCKS, blocklens, displs, types, &datatype);
+        ompi_datatype_commit(&datatype);
+        errors += check_datatype( datatype, 2, 2 * extent / sizeof(int), show_only_first_error );
+        ompi_datatype_destroy( &datatype );
+        ompi_datatype_destroy( &vector );
+    }
+    printf( "Found %d errors\n", errors );
 
     ompi_datatype_finalize();
     opal_finalize_util ();
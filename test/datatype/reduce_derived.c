@@ -0,0 +1,196 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * Check the reductions with the predefined operations on derived
+ * datatypes made of a single predefined type. The blocks described by
+ * the datatype must be reduced, while the gaps must be left untouched.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+
+#define NBLOCKS  1000
+#define BLOCKLEN 3
+#define STRIDE   5
+#define GAP_MARK -7
+
+static int errors = 0;
+
+static void check_int(const char *name, const int *inout, const int *expected,
+                      size_t len)
+{
+    for (size_t i = 0; i < len; ++i) {
+        if (inout[i] != expected[i]) {
+            printf("%s: error at position %zu: got %d expected %d\n", name, i,
+                   inout[i], expected[i]);
+            errors++;
+            return;
+        }
+    }
+}
+
+/* Reduce in into inout with op on the elements selected by mask */
+static void int_reference(MPI_Op op, const int *in, int *inout, const char *mask, size_t len)
+{
+    for (size_t i = 0; i < len; ++i) {
+        if (!mask[i]) {
+            continue;
+        }
+        if (MPI_SUM == op) {
+            inout[i] += in[i];
+        } else if (MPI_MAX == op) {
+            inout[i] = (in[i] > inout[i]) ? in[i] : inout[i];
+        }
+    }
+}
+
+static void test_int(const char *name, MPI_Datatype ddt, int count, MPI_Op op)
+{
+    MPI_Aint lb, extent;
+    size_t len;
+    int *in, *inout, *expected;
+    char *mask;
+
+    MPI_Type_get_extent(ddt, &lb, &extent);
+    len = (size_t) (lb + count * extent) / sizeof(int);
+    in = malloc(len * sizeof(int));
+    inout = malloc(len * sizeof(int));
+    expected = malloc(len * sizeof(int));
+    mask = calloc(len, 1);
+
+    /* Mark the positions touched by the datatype by packing a buffer of
+       ones and unpacking it into a buffer of zeroes. */
+    {
+        int size, position = 0;
+        char *packed;
+        MPI_Pack_size(count, ddt, MPI_COMM_WORLD, &size);
+        packed = malloc(size);
+        for (size_t i = 0; i < len; ++i) {
+            in[i] = 1;
+            inout[i] = 0;
+        }
+        MPI_Pack(in, count, ddt, packed, size, &position, MPI_COMM_WORLD);
+        position = 0;
+        MPI_Unpack(packed, size, &position, inout, count, ddt, MPI_COMM_WORLD);
+        for (size_t i = 0; i < len; ++i) {
+            mask[i] = (char) inout[i];
+        }
+        free(packed);
+    }
+
+    for (size_t i = 0; i < len; ++i) {
+        in[i] = (int) (i % 97) - 40;
+        inout[i] = mask[i] ? (int) (i % 13) : GAP_MARK;
+        expected[i] = inout[i];
+    }
+    int_reference(op, in, expected, mask, len);
+    MPI_Reduce_local(in, inout, count, ddt, op);
+    check_int(name, inout, expected, len);
+
+    free(in);
+    free(inout);
+    free(expected);
+    free(mask);
+}
+
+static void test_double_int_maxloc(void)
+{
+    struct {
+        double v;
+        int i;
+    } *in, *inout, *expected;
+    MPI_Datatype ddt;
+    size_t len = NBLOCKS * STRIDE;
+
+    MPI_Type_vector(NBLOCKS, BLOCKLEN, STRIDE, MPI_DOUBLE_INT, &ddt);
+    MPI_Type_commit(&ddt);
+
+    in = malloc(len * sizeof(*in));
+    inout = malloc(len * sizeof(*inout));
+    expected = malloc(len * sizeof(*expected));
+    for (size_t i = 0; i < len; ++i) {
+        in[i].v = (double) (i % 7);
+        in[i].i = (int) i;
+        inout[i].v = (double) (i % 5);
+        inout[i].i = -(int) i;
+        expected[i] = inout[i];
+        if ((i % STRIDE) < BLOCKLEN) {
+            if (in[i].v > expected[i].v ||
+                (in[i].v == expected[i].v && in[i].i < expected[i].i)) {
+                expected[i] = in[i];
+            }
+        }
+    }
+    MPI_Reduce_local(in, inout, 1, ddt, MPI_MAXLOC);
+    for (size_t i = 0; i < len; ++i) {
+        if (inout[i].v != expected[i].v || inout[i].i != expected[i].i) {
+            printf("vector of MPI_DOUBLE_INT maxloc: error at position %zu\n", i);
+            errors++;
+            break;
+        }
+    }
+    MPI_Type_free(&ddt);
+    free(in);
+    free(inout);
+    free(expected);
+}
+
+int main(int argc, char **argv)
+{
+    MPI_Datatype contig, vector, vector2d, resized, indexed;
+    int blocklens[3] = {2, 1, 4}, displs[3] = {1, 4, 9};
+
+    MPI_Init(&argc, &argv);
+
+    MPI_Type_contiguous(17, MPI_INT, &contig);
+    MPI_Type_commit(&contig);
+    test_int("contiguous", contig, 100, MPI_SUM);
+
+    MPI_Type_vector(NBLOCKS, BLOCKLEN, STRIDE, MPI_INT, &vector);
+    MPI_Type_commit(&vector);
+    test_int("vector", vector, 1, MPI_SUM);
+    test_int("vector", vector, 3, MPI_MAX);
+
+    /* a vector of vectors, described with nested loops */
+    MPI_Type_create_hvector(4, 1, (MPI_Aint) (NBLOCKS * STRIDE + 2) * sizeof(int),
+                            vector, &vector2d);
+    MPI_Type_commit(&vector2d);
+    test_int("vector of vectors", vector2d, 2, MPI_SUM);
+
+    /* leave a gap between the consecutive elements */
+    MPI_Type_create_resized(vector, 0, (MPI_Aint) (NBLOCKS * STRIDE + 11) * sizeof(int),
+                            &resized);
+    MPI_Type_commit(&resized);
+    test_int("resized vector", resized, 5, MPI_MAX);
+
+    MPI_Type_indexed(3, blocklens, displs, MPI_INT, &indexed);
+    MPI_Type_commit(&indexed);
+    test_int("indexed", indexed, 1000, MPI_SUM);
+
+    test_double_int_maxloc();
+
+    MPI_Type_free(&contig);
+    MPI_Type_free(&vector);
+    MPI_Type_free(&vector2d);
+    MPI_Type_free(&resized);
+    MPI_Type_free(&indexed);
+
+    if (0 == errors) {
+        printf("All the reductions on derived datatypes are correct\n");
+    }
+    MPI_Finalize();
+    return (0 == errors) ? 0 : 1;
+}
@@ -25,6 +25,13 @@
 #include "ompi/runtime/mpiruntime.h"
 #include "ompi/datatype/ompi_datatype.h"
 
+#if defined(HAVE_OPAL_SHORT_FLOAT_T) && (2 == SIZEOF_OPAL_SHORT_FLOAT_T)
+/* Same definition as in the shortfloat MPI extension, whose header is
+ * only available once installed. */
+OMPI_DECLSPEC extern struct ompi_predefined_datatype_t ompi_mpi_short_float;
+#define MPIX_C_FLOAT16 OMPI_PREDEFINED_GLOBAL(MPI_Datatype, ompi_mpi_short_float)
+#endif  /* defined(HAVE_OPAL_SHORT_FLOAT_T) && (2 == SIZEOF_OPAL_SHORT_FLOAT_T) */
+
 typedef struct op_name_s {
     char* name;
     char* mpi_op_name;
@@ -41,10 +48,12 @@ static op_name_t array_of_ops [] = {
     { "bor", "MPI_BOR", MPI_BOR },
     { "lxor", "MPI_LXOR", MPI_LXOR },
     { "bxor", "MPI_BXOR", MPI_BXOR },
+    { "maxloc", "MPI_MAXLOC", MPI_MAXLOC },
+    { "minloc", "MPI_MINLOC", MPI_MINLOC },
     { "replace", "MPI_REPLACE", MPI_REPLACE },
     { NULL, "MPI_OP_NULL", MPI_OP_NULL }
 };
-static int do_ops[12] = { -1, };  /* index of the ops to do. Size +1 larger than the array_of_ops */
+static int do_ops[14] = { -1, };  /* index of the ops to do. Size +1 larger than the array_of_ops */
 static int verbose = 0;
 static int total_errors = 0;
 
@@ -175,6 +184,62 @@ do { \
     goto check_and_continue; \
 } while (0)
 
+#define LOC_STRUCT(type_name, type1, type2) \
+    typedef struct {                            \
+        type1 v;                                \
+        type2 k;                                \
+    } type_name##_t;
+
+LOC_STRUCT(float_int, float, int)
+LOC_STRUCT(double_int, double, int)
+LOC_STRUCT(long_int, long, int)
+LOC_STRUCT(two_int, int, int)
+
+/* Mix of smaller, equal and larger values, with different indexes on equality */
+#define MPI_LOC_INIT(INBUF, INOUT_BUF, CHECK_BUF, COUNT) \
+do { \
+    for( i = 0; i < (COUNT); i++ ) { \
+        (INBUF)[i].v = i % 3; \
+        (INBUF)[i].k = i; \
+        (INOUT_BUF)[i].v = (CHECK_BUF)[i].v = 1; \
+        (INOUT_BUF)[i].k = (CHECK_BUF)[i].k = i % 5; \
+    } \
+} while (0)
+
+#define MPI_OP_LOC_TEST(OPNAME, MPIOP, MPITYPE, TYPE, INBUF, INOUT_BUF, CHECK_BUF, COUNT, TYPE_PREFIX) \
+do { \
+    const TYPE *_p1 = ((TYPE*)(INBUF)), *_p3 = ((TYPE*)(CHECK_BUF)); \
+    TYPE *_p2 = ((TYPE*)(INOUT_BUF)); \
+    skip_op_type = 0; \
+    for(int _k = 0; _k < min((COUNT), max_shift); +_k++ ) { \
+        duration[_k] = 0.0; \
+        for(int _r = repeats; _r > 0; _r--) { \
+            memcpy(_p2, _p3, sizeof(TYPE) * (COUNT)); \
+            tstart = MPI_Wtime(); \
+            MPI_Reduce_local(_p1+_k, _p2+_k, (COUNT)-_k, (MPITYPE), (MPIOP)); \
+            tend = MPI_Wtime(); \
+            duration[_k] += (tend - tstart); \
+            if( check ) { \
+                for( i = 0; i < (COUNT)-_k; i++ ) { \
+                    TYPE _v1 = (_p1+_k)[i], _v2 = (_p2+_k)[i], _v3 = (_p3+_k)[i], _e = _v3; \
+                    if( _v1.v OPNAME _v3.v ) { \
+                        _e = _v1; \
+                    } else if( _v1.v == _v3.v ) { \
+                        _e.k = min(_v1.k, _v3.k); \
+                    } \
+                    if( (_v2.v == _e.v) && (_v2.k == _e.k) ) \
+                        continue; \
+                    printf("First error at alignment %d position %d ((%" TYPE_PREFIX ", %d) %s (%" TYPE_PREFIX ", %d) != (%" TYPE_PREFIX ", %d))\n", \
+                           _k, i, _v1.v, _v1.k, (#OPNAME), _v3.v, _v3.k, _v2.v, _v2.k); \
+                    correctness = 0; \
+                    break; \
+                } \
+            } \
+        } \
+    } \
+    goto check_and_continue; \
+} while (0)
+
 int main(int argc, char **argv)
 {
     static void *in_buf = NULL, *inout_buf = NULL, *inout_check_buf = NULL;
@@ -264,9 +329,10 @@ int main(int argc, char **argv)
                     " -u <number> : upper number of elements\n"
                     " -s <type_size> : 8, 16, 32 or 64 bits elements\n"
                     " -t [i,u,f,d] : type of the elements to apply the operations on\n"
+                    "                (f with -s 16 selects MPIX_C_FLOAT16 when available)\n"
                     " -r <number> : number of repetitions for each test\n"
                     " -o <op> : comma separated list of operations to execute among\n"
-                    "           sum, min, max, prod, bor, bxor, band\n"
+                    "           sum, min, max, prod, bor, bxor, band, maxloc, minloc\n"
                     " -i <number> : shift on all buffers to check alignment\n"
                     " -1 <number> : (mis)alignment in elements for the first op\n"
                     " -2 <number> : (mis)alignment in elements for the result\n"
@@ -279,9 +345,10 @@ int main(int argc, char **argv)
     if( !do_ops_built ) {  /* not yet done, take the default */
             build_do_ops( "all", do_ops);
     }
-    posix_memalign( &in_buf,          64, (upper + op1_alignment) * sizeof(double));
-    posix_memalign( &inout_buf,       64, (upper + res_alignment) * sizeof(double));
-    posix_memalign( &inout_check_buf, 64, upper * sizeof(double));
+    /* the largest elements are the double_int pairs */
+    posix_memalign( &in_buf,          64, (upper + op1_alignment) * sizeof(double_int_t));
+    posix_memalign( &inout_buf,       64, (upper + res_alignment) * sizeof(double_int_t));
+    posix_memalign( &inout_check_buf, 64, upper * sizeof(double_int_t));
     duration = (double*)malloc(max_shift * sizeof(double));
 
     ompi_mpi_init(argc, argv, MPI_THREAD_SERIALIZED, &provided, false);
@@ -436,6 +503,21 @@ int main(int argc, char **argv)
                                                in_int32, inout_int32, inout_int32_for_check,
                                                count, PRId32);
                         }
+                        if( (0 == strcmp(op, "maxloc")) || (0 == strcmp(op, "minloc")) ) {
+                            two_int_t *in_2int = (two_int_t*)((char*)in_buf + op1_alignment * sizeof(two_int_t)),
+                                *inout_2int = (two_int_t*)((char*)inout_buf + res_alignment * sizeof(two_int_t)),
+                                *inout_2int_for_check = (two_int_t*)inout_check_buf;
+                            MPI_LOC_INIT(in_2int, inout_2int, inout_2int_for_check, count);
+                            mpi_type = "MPI_2INT";
+                            if( 0 == strcmp(op, "maxloc") ) {
+                                MPI_OP_LOC_TEST(>, mpi_op, MPI_2INT, two_int_t,
+                                                in_2int, inout_2int, inout_2int_for_check,
+                                                count, "d");
+                            }
+                            MPI_OP_LOC_TEST(<, mpi_op, MPI_2INT, two_int_t,
+                                            in_2int, inout_2int, inout_2int_for_check,
+                                            count, "d");
+                        }
                     }
                     if( 64 == type_size ) {
                         int64_t *in_int64 = (int64_t*)((char*)in_buf + op1_alignment * sizeof(int64_t)),
@@ -482,6 +564,21 @@ int main(int argc, char **argv)
                                                in_int64, inout_int64, inout_int64_for_check,
                                                count, PRId64);
                         }
+                        if( (0 == strcmp(op, "maxloc")) || (0 == strcmp(op, "minloc")) ) {
+                            long_int_t *in_long_int = (long_int_t*)((char*)in_buf + op1_alignment * sizeof(long_int_t)),
+                                *inout_long_int = (long_int_t*)((char*)inout_buf + res_alignment * sizeof(long_int_t)),
+                                *inout_long_int_for_check = (long_int_t*)inout_check_buf;
+                            MPI_LOC_INIT(in_long_int, inout_long_int, inout_long_int_for_check, count);
+                            mpi_type = "MPI_LONG_INT";
+                            if( 0 == strcmp(op, "maxloc") ) {
+                                MPI_OP_LOC_TEST(>, mpi_op, MPI_LONG_INT, long_int_t,
+                                                in_long_int, inout_long_int, inout_long_int_for_check,
+                                                count, "ld");
+                            }
+                            MPI_OP_LOC_TEST(<, mpi_op, MPI_LONG_INT, long_int_t,
+                                            in_long_int, inout_long_int, inout_long_int_for_check,
+                                            count, "ld");
+                        }
                     }
                 }
 
@@ -672,6 +769,40 @@ int main(int argc, char **argv)
                     }
                 }
 
+#if defined(MPIX_C_FLOAT16)
+                if( ('f' == type[type_idx]) && (16 == type_size) ) {
+                    opal_short_float_t *in_half = (opal_short_float_t*)((char*)in_buf + op1_alignment * sizeof(opal_short_float_t)),
+                        *inout_half = (opal_short_float_t*)((char*)inout_buf + res_alignment * sizeof(opal_short_float_t)),
+                        *inout_half_for_check = (opal_short_float_t*)inout_check_buf;
+                    for( i = 0; i < count; i++ ) {
+                        in_half[i] = (opal_short_float_t)(10.0 + (i % 7) * 0.125);
+                        inout_half[i] = inout_half_for_check[i] = (opal_short_float_t)(3.0 - (i % 5) * 0.25);
+                    }
+                    mpi_type = "MPIX_C_FLOAT16";
+
+                    if( 0 == strcmp(op, "sum") ) {
+                        MPI_OP_TEST( +, mpi_op, MPIX_C_FLOAT16, opal_short_float_t,
+                                     in_half, inout_half, inout_half_for_check,
+                                     count, "f");
+                    }
+                    if( 0 == strcmp(op, "prod") ) {
+                        MPI_OP_TEST( *, mpi_op, MPIX_C_FLOAT16, opal_short_float_t,
+                                     in_half, inout_half, inout_half_for_check,
+                                     count, "f");
+                    }
+                    if( 0 == strcmp(op, "max") ) {
+                        MPI_OP_MINMAX_TEST(max, mpi_op,  MPIX_C_FLOAT16, opal_short_float_t,
+                                           in_half, inout_half, inout_half_for_check,
+                                           count, "f");
+                    }
+                    if( 0 == strcmp(op, "min") ) {
+                        MPI_OP_MINMAX_TEST(min, mpi_op,  MPIX_C_FLOAT16, opal_short_float_t,
+                                           in_half, inout_half, inout_half_for_check,
+                                           count, "f");
+                    }
+                }
+                else
+#endif  /* defined(MPIX_C_FLOAT16) */
                 if( 'f' == type[type_idx] ) {
                     float *in_float = (float*)((char*)in_buf + op1_alignment * sizeof(float)),
                         *inout_float = (float*)((char*)inout_buf + res_alignment * sizeof(float)),
@@ -702,6 +833,21 @@ int main(int argc, char **argv)
                                            in_float, inout_float, inout_float_for_check,
                                            count, "f");
                     }
+                    if( (0 == strcmp(op, "maxloc")) || (0 == strcmp(op, "minloc")) ) {
+                        float_int_t *in_float_int = (float_int_t*)((char*)in_buf + op1_alignment * sizeof(float_int_t)),
+                            *inout_float_int = (float_int_t*)((char*)inout_buf + res_alignment * sizeof(float_int_t)),
+                            *inout_float_int_for_check = (float_int_t*)inout_check_buf;
+                        MPI_LOC_INIT(in_float_int, inout_float_int, inout_float_int_for_check, count);
+                        mpi_type = "MPI_FLOAT_INT";
+                        if( 0 == strcmp(op, "maxloc") ) {
+                            MPI_OP_LOC_TEST(>, mpi_op, MPI_FLOAT_INT, float_int_t,
+                                            in_float_int, inout_float_int, inout_float_int_for_check,
+                                            count, "f");
+                        }
+                        MPI_OP_LOC_TEST(<, mpi_op, MPI_FLOAT_INT, float_int_t,
+                                        in_float_int, inout_float_int, inout_float_int_for_check,
+                                        count, "f");
+                    }
                 }
 
                 if( 'd' == type[type_idx] ) {
@@ -734,6 +880,21 @@ int main(int argc, char **argv)
                                            in_double, inout_double, inout_double_for_check,
                                            count, "f");
                     }
+                    if( (0 == strcmp(op, "maxloc")) || (0 == strcmp(op, "minloc")) ) {
+                        double_int_t *in_double_int = (double_int_t*)((char*)in_buf + op1_alignment * sizeof(double_int_t)),
+                            *inout_double_int = (double_int_t*)((char*)inout_buf + res_alignment * sizeof(double_int_t)),
+                            *inout_double_int_for_check = (double_int_t*)inout_check_buf;
+                        MPI_LOC_INIT(in_double_int, inout_double_int, inout_double_int_for_check, count);
+                        mpi_type = "MPI_DOUBLE_INT";
+                        if( 0 == strcmp(op, "maxloc") ) {
+                            MPI_OP_LOC_TEST(>, mpi_op, MPI_DOUBLE_INT, double_int_t,
+                                            in_double_int, inout_double_int, inout_double_int_for_check,
+                                            count, "f");
+                        }
+                        MPI_OP_LOC_TEST(<, mpi_op, MPI_DOUBLE_INT, double_int_t,
+                                        in_double_int, inout_double_int, inout_double_int_for_check,
+                                        count, "f");
+                    }
                 }
         check_and_continue:
                 if( !skip_op_type )
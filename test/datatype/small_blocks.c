@@ -0,0 +1,164 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * Pack and unpack strided blocks of 1 to 64 bytes, the sizes handled by
+ * the fixed-size kernels of opal_datatype_pack_unpack_blocks.h and their
+ * neighbours going through the generic copies, and compare the result
+ * with the blocks copied one by one. Each layout is converted in a
+ * single piece, and in fragments of a few bytes ending in the middle of
+ * the blocks.
+ */
+
+#include "ompi_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "opal/datatype/opal_convertor.h"
+
+#define NBLOCKS  37
+#define FRAGMENT 13
+
+static int errors = 0;
+
+/* convert the whole buffer in pieces of at most FRAGMENT bytes, the pack
+ * stops before a predefined datatype that does not fit */
+static void convert_fragments(opal_convertor_t *convertor, unsigned char *packed, size_t size,
+                              bool pack)
+{
+    for (size_t offset = 0; offset < size;) {
+        struct iovec iov = {.iov_base = packed + offset,
+                            .iov_len = (size - offset) < FRAGMENT ? size - offset : FRAGMENT};
+        uint32_t iov_count = 1;
+        size_t max_data = iov.iov_len;
+
+        if (pack) {
+            opal_convertor_pack(convertor, &iov, &iov_count, &max_data);
+        } else {
+            opal_convertor_unpack(convertor, &iov, &iov_count, &max_data);
+        }
+        if (0 == max_data) {
+            break;
+        }
+        offset += max_data;
+    }
+}
+
+/*
+ * ddt describes nblocks blocks of block bytes, stride bytes apart, when
+ * repeated count times.
+ */
+static void check(const char *name, MPI_Datatype ddt, int count, size_t block, size_t stride,
+                  size_t nblocks)
+{
+    size_t len = (nblocks - 1) * stride + block, size = nblocks * block;
+    unsigned char *src = malloc(len), *dst = malloc(len), *expected = malloc(len);
+    unsigned char *packed = malloc(size), *packed_ref = malloc(size);
+    opal_convertor_t *convertor;
+    int pos = 0;
+
+    for (size_t i = 0; i < len; ++i) {
+        src[i] = (unsigned char) (i * 7 + 3);
+        expected[i] = 0xaa;
+    }
+    for (size_t i = 0; i < nblocks; ++i) {
+        memcpy(packed_ref + i * block, src + i * stride, block);
+        memcpy(expected + i * stride, src + i * stride, block);
+    }
+
+    MPI_Pack(src, count, ddt, packed, (int) size, &pos, MPI_COMM_WORLD);
+    if ((size_t) pos != size || 0 != memcmp(packed, packed_ref, size)) {
+        printf("%s (%zu bytes blocks): MPI_Pack differs\n", name, block);
+        errors++;
+    }
+    memset(dst, 0xaa, len);
+    pos = 0;
+    MPI_Unpack(packed_ref, (int) size, &pos, dst, count, ddt, MPI_COMM_WORLD);
+    if (0 != memcmp(dst, expected, len)) {
+        printf("%s (%zu bytes blocks): MPI_Unpack differs\n", name, block);
+        errors++;
+    }
+
+    memset(packed, 0, size);
+    convertor = opal_convertor_create(opal_local_arch, 0);
+    opal_convertor_prepare_for_send(convertor, &ddt->super, count, src);
+    convert_fragments(convertor, packed, size, true);
+    OBJ_RELEASE(convertor);
+    if (0 != memcmp(packed, packed_ref, size)) {
+        printf("%s (%zu bytes blocks): fragmented pack differs\n", name, block);
+        errors++;
+    }
+    memset(dst, 0xaa, len);
+    convertor = opal_convertor_create(opal_local_arch, 0);
+    opal_convertor_prepare_for_recv(convertor, &ddt->super, count, dst);
+    convert_fragments(convertor, packed_ref, size, false);
+    OBJ_RELEASE(convertor);
+    if (0 != memcmp(dst, expected, len)) {
+        printf("%s (%zu bytes blocks): fragmented unpack differs\n", name, block);
+        errors++;
+    }
+
+    free(src);
+    free(dst);
+    free(expected);
+    free(packed);
+    free(packed_ref);
+}
+
+int main(int argc, char **argv)
+{
+    MPI_Datatype ddt, tmp;
+
+    MPI_Init(&argc, &argv);
+
+    for (int block = 1; block <= 64; ++block) {
+        /* blocks of bytes in a vector */
+        MPI_Type_vector(NBLOCKS, block, block + 5, MPI_CHAR, &ddt);
+        MPI_Type_commit(&ddt);
+        check("char vector", ddt, 1, block, block + 5, NBLOCKS);
+        MPI_Type_free(&ddt);
+
+        /* blocks of ints in a vector */
+        if (0 == (block % 4)) {
+            MPI_Type_vector(NBLOCKS, block / 4, block / 4 + 3, MPI_INT, &ddt);
+            MPI_Type_commit(&ddt);
+            check("int vector", ddt, 1, block, block + 12, NBLOCKS);
+            MPI_Type_free(&ddt);
+        }
+
+        /* a short followed by bytes, repeated with a larger extent */
+        if (block >= 3) {
+            int blocklens[2] = {1, block - 2};
+            MPI_Aint displs[2] = {0, 2};
+            MPI_Datatype types[2] = {MPI_SHORT, MPI_CHAR};
+
+            MPI_Type_create_struct(2, blocklens, displs, types, &tmp);
+            MPI_Type_create_resized(tmp, 0, block + 6, &ddt);
+            MPI_Type_free(&tmp);
+            MPI_Type_commit(&ddt);
+            check("resized struct", ddt, NBLOCKS, block, block + 6, NBLOCKS);
+            MPI_Type_free(&ddt);
+        }
+    }
+
+    MPI_Finalize();
+
+    if (0 != errors) {
+        printf("%d errors\n", errors);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * With the coalescing of ob1 enabled, every process but the last sends a
+ * burst of small messages to the last one, completes them and immediately
+ * frees the communicator, then sends a second burst right before
+ * MPI_Finalize. The messages are complete for the sender while they still
+ * sit in an open fragment, every one of them must reach the receiver.
+ *
+ * mpirun -n 2 ./coalesce_finalize
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpi.h"
+
+#define NMSGS 1000
+
+/* every process but the last sends NMSGS small messages to the last one,
+ * which receives them. returns the number of wrong messages. */
+static int burst(MPI_Comm comm, int tag)
+{
+    int rank, size, errors = 0;
+    int *buf = malloc(NMSGS * sizeof(int));
+    MPI_Request *reqs = malloc(NMSGS * sizeof(MPI_Request));
+
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    if (rank != size - 1) {
+        for (int i = 0; i < NMSGS; ++i) {
+            buf[i] = rank * NMSGS + i;
+            MPI_Isend(buf + i, 1, MPI_INT, size - 1, tag, comm, reqs + i);
+        }
+        MPI_Waitall(NMSGS, reqs, MPI_STATUSES_IGNORE);
+    } else {
+        for (int src = 0; src < size - 1; ++src) {
+            for (int i = 0; i < NMSGS; ++i) {
+                MPI_Recv(buf + i, 1, MPI_INT, src, tag, comm, MPI_STATUS_IGNORE);
+                if (buf[i] != src * NMSGS + i) {
+                    ++errors;
+                }
+            }
+        }
+    }
+
+    free(buf);
+    free(reqs);
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    int rank, size, errors;
+    MPI_Comm comm;
+
+    setenv("OMPI_MCA_pml_ob1_coalesce", "1", 0);
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    /* the senders free the communicator as soon as their sends complete */
+    MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+    errors = burst(comm, 17);
+    MPI_Comm_free(&comm);
+
+    /* the senders finalize as soon as their sends complete */
+    errors += burst(MPI_COMM_WORLD, 42);
+
+    if (0 != errors) {
+        printf("[%d] %d messages lost or corrupted\n", rank, errors);
+    } else if (rank == size - 1) {
+        printf("[%d] received every message from %d senders\n", rank, size - 1);
+    }
+    MPI_Finalize();
+    return (0 == errors) ? 0 : 1;
+}
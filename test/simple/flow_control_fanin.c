@@ -0,0 +1,85 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * With the flow control of ob1 enabled and a small window, every process
+ * but the last floods the last one, which only starts receiving after a
+ * while. Once the receiver matched everything, the credits must be back:
+ * a small message completes at the sender before the receiver posts the
+ * matching receive, which only happens when it is sent eagerly.
+ *
+ * mpirun -n 8 ./flow_control_fanin
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "mpi.h"
+
+#define NMSGS 2000
+#define MSG_SIZE 64
+
+int main(int argc, char *argv[])
+{
+    int rank, size, flag = 0, errors = 0;
+    char buf[MSG_SIZE];
+    MPI_Request req;
+    double start;
+
+    setenv("OMPI_MCA_pml_ob1_flow_control", "1", 0);
+    setenv("OMPI_MCA_pml_ob1_flow_control_credits", "4096", 0);
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    /* the flood, the window only holds a few dozen messages */
+    if (rank != size - 1) {
+        for (int i = 0; i < NMSGS; ++i) {
+            buf[0] = (char) i;
+            MPI_Send(buf, MSG_SIZE, MPI_CHAR, size - 1, 0, MPI_COMM_WORLD);
+        }
+    } else {
+        sleep(1);
+        for (int i = 0; i < NMSGS * (size - 1); ++i) {
+            MPI_Recv(buf, MSG_SIZE, MPI_CHAR, MPI_ANY_SOURCE, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    /* the receiver is slow again, an eager send completes without it */
+    if (rank != size - 1) {
+        MPI_Isend(buf, MSG_SIZE, MPI_CHAR, size - 1, 1, MPI_COMM_WORLD, &req);
+        start = MPI_Wtime();
+        while (!flag && MPI_Wtime() - start < 1.0) {
+            MPI_Test(&req, &flag, MPI_STATUS_IGNORE);
+        }
+        if (!flag) {
+            printf("[%d] the send did not complete before it was matched, no eager credits left\n",
+                   rank);
+            ++errors;
+        }
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+    } else {
+        sleep(3);
+        for (int i = 0; i < size - 1; ++i) {
+            MPI_Recv(buf, MSG_SIZE, MPI_CHAR, MPI_ANY_SOURCE, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (0 == rank) {
+        printf("%s\n", (0 == errors) ? "eager sends resumed on every sender" : "FAILED");
+    }
+    MPI_Finalize();
+    return (0 == errors) ? 0 : 1;
+}
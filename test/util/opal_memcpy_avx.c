@@ -0,0 +1,109 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * Compare the streaming store kernels of the memcpy framework with the C
+ * library memcpy, for every kernel built and supported by the CPU. The
+ * source and the destination are misaligned by 0 to 63 bytes, and the
+ * lengths go around the vector and block sizes of the kernels, including
+ * the copies that end in the unaligned head. The bytes around the
+ * destination must not be touched.
+ */
+
+#include "opal_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/mca/memcpy/avx/memcpy_avx.h"
+
+typedef void *(*memcpy_avx_test_fn_t)(void *dst, const void *src, size_t length);
+
+/* room for the misalignment and the guard bytes */
+#define MEMCPY_AVX_TEST_PAD 128
+#define MEMCPY_AVX_TEST_MAX 4096
+
+static const size_t lengths[] = {0,   1,   2,   7,   15,  16,  17,  31,  32,  33,  63,
+                                 64,  65,  95,  127, 128, 129, 191, 255, 256, 257, 300,
+                                 383, 511, 512, 513, 1000, 1023, 1024, 1025, 4095, 4096};
+
+static int memcpy_avx_test(const char *name, memcpy_avx_test_fn_t fn)
+{
+    size_t size = MEMCPY_AVX_TEST_MAX + 2 * MEMCPY_AVX_TEST_PAD;
+    unsigned char *src, *dst, *expected;
+    int errors = 0;
+
+    if (0 != posix_memalign((void **) &src, 64, size)
+        || 0 != posix_memalign((void **) &dst, 64, size)
+        || 0 != posix_memalign((void **) &expected, 64, size)) {
+        fprintf(stderr, "cannot allocate the buffers\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < size; ++i) {
+        src[i] = (unsigned char) (i * 13 + 5);
+    }
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+        size_t length = lengths[l];
+
+        for (size_t src_off = 0; src_off < 64; ++src_off) {
+            for (size_t dst_off = 0; dst_off < 64; ++dst_off) {
+                unsigned char *d = dst + MEMCPY_AVX_TEST_PAD / 2 + dst_off;
+                unsigned char *e = expected + MEMCPY_AVX_TEST_PAD / 2 + dst_off;
+                const unsigned char *s = src + src_off;
+
+                memset(dst, 0xa5, size);
+                memset(expected, 0xa5, size);
+                memcpy(e, s, length);
+                fn(d, s, length);
+                if (0 != memcmp(dst, expected, size)) {
+                    if (++errors <= 10) {
+                        printf("%s: %zu bytes, source offset %zu, destination offset %zu "
+                               "differ from memcpy\n",
+                               name, length, src_off, dst_off);
+                    }
+                }
+            }
+        }
+    }
+
+    free(src);
+    free(dst);
+    free(expected);
+    printf("%s: %s\n", name, (0 == errors) ? "[PASSED]" : "[FAILED]");
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    int errors = 0, tested = 0;
+
+#if OPAL_MCA_MEMCPY_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        errors += memcpy_avx_test("opal_memcpy_avx2_nt", opal_memcpy_avx2_nt);
+        ++tested;
+    }
+#endif
+#if OPAL_MCA_MEMCPY_HAVE_AVX512
+    if (__builtin_cpu_supports("avx512f")) {
+        errors += memcpy_avx_test("opal_memcpy_avx512_nt", opal_memcpy_avx512_nt);
+        ++tested;
+    }
+#endif
+
+    if (0 == tested) {
+        printf("no streaming store kernel built or supported by the CPU\n");
+        return 77;
+    }
+    return (0 == errors) ? 0 : 1;
+}
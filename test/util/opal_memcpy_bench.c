@@ -0,0 +1,188 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * Throughput of the C library memcpy and of the streaming store kernel
+ * of the memcpy framework, from 4KB to the maximum size (-m, 256MB by
+ * default). Each copy is followed by a read of the destination, as the
+ * receiver of a shared memory transfer would do, unless -c is given.
+ *
+ * The results are printed one per line as "bytes memcpy-GB/s nt-GB/s",
+ * followed by the smallest size from which the streaming stores are
+ * faster for all the larger sizes, a candidate for memcpy_avx_nt_threshold.
+ *
+ * It is not part of the tests, run it with "make bench" (the options can
+ * be given in MEMCPY_BENCH_FLAGS).
+ */
+
+#include "opal_config.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "opal/mca/base/mca_base_framework.h"
+#include "opal/mca/memcpy/base/base.h"
+#include "opal/runtime/opal.h"
+
+typedef void *(*memcpy_bench_fn_t)(void *dst, const void *src, size_t length);
+
+static double min_time = 0.1;
+static bool with_read = true;
+
+static double memcpy_bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/* touch every cache line of the destination */
+static uint64_t memcpy_bench_read(const char *buf, size_t length)
+{
+    uint64_t sum = 0;
+
+    for (size_t i = 0; i < length; i += 64) {
+        sum += (unsigned char) buf[i];
+    }
+    return sum;
+}
+
+static double memcpy_bench_run(memcpy_bench_fn_t fn, char *dst, const char *src, size_t length)
+{
+    volatile uint64_t sink = 0;
+    double start, elapsed;
+    size_t iterations = 0;
+
+    /* warm up, the pages are faulted in */
+    fn(dst, src, length);
+
+    start = memcpy_bench_now();
+    do {
+        fn(dst, src, length);
+        if (with_read) {
+            sink += memcpy_bench_read(dst, length);
+        }
+        ++iterations;
+        elapsed = memcpy_bench_now() - start;
+    } while (elapsed < min_time);
+
+    (void) sink;
+    return (double) (length * iterations) / elapsed / 1e9;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-t seconds] [-m max_bytes] [-c]\n"
+            "  -t  minimum time per measurement (default 0.1)\n"
+            "  -m  largest copy (default 256MB)\n"
+            "  -c  do not read the destination after each copy\n",
+            name);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t max_size = 256 * 1024 * 1024;
+    int opt, rc;
+
+    while (-1 != (opt = getopt(argc, argv, "t:m:ch"))) {
+        switch (opt) {
+        case 't':
+            min_time = atof(optarg);
+            break;
+        case 'm':
+            max_size = strtoull(optarg, NULL, 0);
+            break;
+        case 'c':
+            with_read = false;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    rc = opal_init_util(&argc, &argv);
+    if (OPAL_SUCCESS != rc) {
+        fprintf(stderr, "opal_init_util failed (%d)\n", rc);
+        return 1;
+    }
+    rc = mca_base_framework_open(&opal_memcpy_base_framework, 0);
+    if (OPAL_SUCCESS != rc) {
+        fprintf(stderr, "could not open the memcpy framework (%d)\n", rc);
+        opal_finalize_util();
+        return 1;
+    }
+
+#if defined(OPAL_MCA_MEMCPY_AVX_MEMCPY_AVX_H)
+    size_t threshold = 0;
+    char *src, *dst;
+
+    if (SIZE_MAX == opal_memcpy_avx_nt_threshold) {
+        printf("no streaming store kernel for this processor\n");
+        rc = 77;
+        goto cleanup;
+    }
+
+    src = (char *) malloc(max_size + 64);
+    dst = (char *) malloc(max_size + 64);
+    if (NULL == src || NULL == dst) {
+        fprintf(stderr, "could not allocate 2 x %lu bytes\n", (unsigned long) max_size);
+        free(src);
+        free(dst);
+        rc = 1;
+        goto cleanup;
+    }
+    memset(src, 1, max_size + 64);
+    memset(dst, 0, max_size + 64);
+
+    printf("# current memcpy_avx_nt_threshold %lu\n",
+           (unsigned long) opal_memcpy_avx_nt_threshold);
+    printf("# bytes memcpy-GB/s nt-GB/s%s\n", with_read ? " (copy + read)" : "");
+    for (size_t length = 4096; length <= max_size; length *= 2) {
+        double libc = memcpy_bench_run(memcpy, dst, src, length);
+        double nt = memcpy_bench_run(opal_memcpy_avx_nt, dst, src, length);
+
+        printf("%lu %.2f %.2f\n", (unsigned long) length, libc, nt);
+        if (nt < libc) {
+            threshold = 0;
+        } else if (0 == threshold) {
+            threshold = length;
+        }
+    }
+
+    if (0 != threshold) {
+        printf("# suggested memcpy_avx_nt_threshold %lu\n", (unsigned long) threshold);
+    } else {
+        printf("# the streaming stores are never faster, suggested memcpy_avx_support none\n");
+    }
+
+    free(src);
+    free(dst);
+    rc = 0;
+
+cleanup:
+#else
+    printf("the memcpy framework has no streaming store kernel in this build\n");
+    (void) max_size;
+    rc = 77;
+#endif
+    (void) mca_base_framework_close(&opal_memcpy_base_framework);
+    opal_finalize_util();
+
+    return rc;
+}